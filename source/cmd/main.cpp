@@ -41,6 +41,7 @@ struct AcquireOptions
   bool verbose{false};
   std::string save_h5;
   std::string save_csv;
+  std::vector<std::string> merge;
 
   AcquireOptions()
   {
@@ -53,9 +54,57 @@ struct AcquireOptions
     app.add_flag("-v,--verbose", verbose, "Print results");
     app.add_option("-s,--save", save_h5, "Save to h5 file");
     app.add_option("-c,--save_csv", save_csv, "Save to multiple csv files");
+    app.add_option("-m,--merge", merge,
+                   "Instead of acquiring, sum up the data of these project files")
+        ->check(CLI::ExistingFile);
   }
 };
 
+void save_project(const AcquireOptions& opts, ProjectPtr project)
+{
+  if (!opts.save_h5.empty())
+  {
+    INFO("Saving h5 to {}", opts.save_h5);
+    project->save(opts.save_h5);
+  }
+
+  if (!opts.save_csv.empty())
+  {
+    INFO("Saving csv to {}", opts.save_csv);
+    project->save_split(opts.save_csv);
+  }
+}
+
+int merge_projects(const AcquireOptions& opts)
+{
+  ProjectPtr project = ProjectPtr(new Project());
+  try
+  {
+    INFO("Opening {}", opts.merge.front());
+    project->open(opts.merge.front());
+    for (size_t i = 1; i < opts.merge.size(); ++i)
+    {
+      INFO("Merging {}", opts.merge[i]);
+      project->merge(opts.merge[i]);
+    }
+  }
+  catch (std::exception& e)
+  {
+    ERR("Failed to merge project files:\n{}", hdf5::error::print_nested(e, 1));
+    return EXIT_FAILURE;
+  }
+
+  if (opts.verbose)
+  {
+    std::stringstream ss;
+    ss << *project;
+    INFO("Merged project:\n{}", ss.str());
+  }
+
+  save_project(opts, project);
+  return EXIT_SUCCESS;
+}
+
 int main(int argc, char** argv)
 {
   AcquireOptions opts;
@@ -77,6 +126,9 @@ int main(int argc, char** argv)
   INFO("BuildInfo.build_time: {}", BI_BUILD_TIME);
 #endif
 
+  if (!opts.merge.empty())
+    return merge_projects(opts);
+
   auto& engine = Engine::singleton();
 
   if (!opts.profile_file.empty())
@@ -127,17 +179,7 @@ int main(int argc, char** argv)
     INFO("Project after DAQ run:\n{}", ss.str());
   }
 
-  if (!opts.save_h5.empty())
-  {
-    INFO("Saving h5 to {}", opts.save_h5);
-    project->save(opts.save_h5);
-  }
-
-  if (!opts.save_csv.empty())
-  {
-    INFO("Saving csv to {}", opts.save_csv);
-    project->save_split(opts.save_csv);
-  }
+  save_project(opts, project);
 
   engine.die();
 
@@ -64,7 +64,7 @@ bool Histogram1D::_accept_events(const Spill& /*spill*/)
   return value_latch_.valid();
 }
 
-void Histogram1D::_push_event(const Event& event)
+void Histogram1D::_push_event(const EventView& event)
 {
   if (!filters_.accept(event))
     return;
@@ -73,4 +73,20 @@ void Histogram1D::_push_event(const Event& event)
   data_->add_one(coords_);
 }
 
+void Histogram1D::_push_events(const EventBuffer& events)
+{
+  filters_.select(events, selected_);
+  value_latch_.extract(bins_, events);
+
+  size_t count = 0;
+  for (size_t i = 0; i < events.size(); ++i)
+  {
+    bins_[count] = bins_[i];
+    count += selected_[i];
+  }
+  bins_.resize(count);
+
+  fill_ones(bins_);
+}
+
 }
@@ -18,7 +18,8 @@ class Histogram1D : public Spectrum
     void _recalc_axes() override;
 
     //event processing
-    void _push_event(const Event& event) override;
+    void _push_event(const EventView& event) override;
+    void _push_events(const EventBuffer& events) override;
     void _push_stats_pre(const Spill& spill) override;
     bool _accept_spill(const Spill& spill) override;
     bool _accept_events(const Spill& spill) override;
@@ -28,6 +29,8 @@ class Histogram1D : public Spectrum
 
     //reserve memory
     Coords coords_{0};
+    std::vector<uint8_t> selected_;
+    std::vector<size_t> bins_;
 };
 
 }
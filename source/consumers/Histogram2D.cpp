@@ -1,7 +1,9 @@
 #include <consumers/Histogram2D.h>
 
+#include <consumers/dataspaces/Adaptive2D.h>
 #include <consumers/dataspaces/SparseMap2D.h>
 #include <consumers/dataspaces/SparseMatrix2D.h>
+#include <consumers/dataspaces/TileMap2D.h>
 #include <consumers/dataspaces/DenseMatrix2D.h>
 
 #include <core/util/logger.h>
@@ -13,8 +15,10 @@ Histogram2D::Histogram2D()
 {
     //INFO("Histogram2D ctor");
 //  data_ = std::make_shared<SparseMap2D>();
-  data_ = std::make_shared<SparseMatrix2D>();
+//  data_ = std::make_shared<SparseMatrix2D>();
+//  data_ = std::make_shared<TileMap2D>();
 //  data_ = std::make_shared<DenseMatrix2D>();
+  data_ = std::make_shared<Adaptive2D>();
 
   Setting base_options = metadata_.attributes();
   metadata_ = ConsumerMetadata(my_type(), "Event-based 2D spectrum");
@@ -83,7 +87,7 @@ bool Histogram2D::_accept_events(const Spill& /*spill*/)
   return value_latch_x_.valid() && value_latch_y_.valid();
 }
 
-void Histogram2D::_push_event(const Event& event)
+void Histogram2D::_push_event(const EventView& event)
 {
   //INFO("<Histogram2D> _push_event()");
   if (!filters_.accept(event))
@@ -94,5 +98,22 @@ void Histogram2D::_push_event(const Event& event)
   data_->add_one(coords_);
 }
 
+void Histogram2D::_push_events(const EventBuffer& events)
+{
+  filters_.select(events, selected_);
+  value_latch_x_.extract(bins_x_, events);
+  value_latch_y_.extract(bins_y_, events);
+
+  batch_.clear();
+  for (size_t i = 0; i < events.size(); ++i)
+  {
+    if (!selected_[i])
+      continue;
+    batch_.push_back(bins_x_[i]);
+    batch_.push_back(bins_y_[i]);
+  }
+
+  fill_ones(batch_);
+}
 
 }
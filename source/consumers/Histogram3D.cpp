@@ -1,6 +1,6 @@
 #include <consumers/Histogram3D.h>
 
-#include <consumers/dataspaces/SparseMap3D.h>
+#include <consumers/dataspaces/BrickMap3D.h>
 //#include <consumers/dataspaces/sparse_matrix3d.h>
 //#include <consumers/dataspaces/dense_matrix3d.h>
 
@@ -12,7 +12,8 @@ Histogram3D::Histogram3D()
     : Spectrum()
 {
   //INFO("Histogram3D ctor");
-  data_ = std::make_shared<SparseMap3D>();
+  data_ = std::make_shared<BrickMap3D>();
+//  data_ = std::make_shared<SparseMap3D>();
 //  data_ = std::make_shared<SparseMatrix3D>();
 //  data_ = std::make_shared<DenseMatrix3D>();
 
@@ -86,7 +87,7 @@ bool Histogram3D::_accept_events(const Spill& /*spill*/)
   return value_latch_x_.valid() && value_latch_y_.valid() && value_latch_z_.valid();
 }
 
-void Histogram3D::_push_event(const Event& event)
+void Histogram3D::_push_event(const EventView& event)
 {
   if (!filters_.accept(event))
     return;
@@ -98,4 +99,24 @@ void Histogram3D::_push_event(const Event& event)
   data_->add_one(coords_);
 }
 
+void Histogram3D::_push_events(const EventBuffer& events)
+{
+  filters_.select(events, selected_);
+  value_latch_x_.extract(bins_x_, events);
+  value_latch_y_.extract(bins_y_, events);
+  value_latch_z_.extract(bins_z_, events);
+
+  batch_.clear();
+  for (size_t i = 0; i < events.size(); ++i)
+  {
+    if (!selected_[i])
+      continue;
+    batch_.push_back(bins_x_[i]);
+    batch_.push_back(bins_y_[i]);
+    batch_.push_back(bins_z_[i]);
+  }
+
+  fill_ones(batch_);
+}
+
 }
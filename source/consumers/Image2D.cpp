@@ -2,6 +2,7 @@
 
 #include <consumers/dataspaces/SparseMap2D.h>
 #include <consumers/dataspaces/SparseMatrix2D.h>
+#include <consumers/dataspaces/TileMap2D.h>
 
 #include <core/util/logger.h>
 
@@ -12,7 +13,8 @@ Image2D::Image2D()
 {
 //  data_ = std::make_shared<SparseMap2D>();
   //INFO("Image2D ctor");
-  data_ = std::make_shared<SparseMatrix2D>();
+//  data_ = std::make_shared<SparseMatrix2D>();
+  data_ = std::make_shared<TileMap2D>();
 
   Setting base_options = metadata_.attributes();
   metadata_ = ConsumerMetadata(my_type(), "Values-based 2D image");
@@ -86,7 +88,7 @@ bool Image2D::_accept_events(const Spill& /*spill*/)
   return value_latch_x_.valid() && value_latch_y_.valid() && value_latch_i_.valid();
 }
 
-void Image2D::_push_event(const Event& event)
+void Image2D::_push_event(const EventView& event)
 {
   if (!filters_.accept(event))
     return;
@@ -98,4 +100,25 @@ void Image2D::_push_event(const Event& event)
   data_->add(entry_);
 }
 
+void Image2D::_push_events(const EventBuffer& events)
+{
+  filters_.select(events, selected_);
+  value_latch_x_.extract(bins_x_, events);
+  value_latch_y_.extract(bins_y_, events);
+  value_latch_i_.extract(intensities_, events);
+
+  batch_.clear();
+  batch_counts_.clear();
+  for (size_t i = 0; i < events.size(); ++i)
+  {
+    if (!selected_[i])
+      continue;
+    batch_.push_back(bins_x_[i]);
+    batch_.push_back(bins_y_[i]);
+    batch_counts_.push_back(intensities_[i]);
+  }
+
+  data_->add_many(batch_, batch_counts_);
+}
+
 }
@@ -17,7 +17,8 @@ class Image2D : public Spectrum
     void _apply_attributes() override;
     void _recalc_axes() override;
 
-    void _push_event(const Event&) override;
+    void _push_event(const EventView&) override;
+    void _push_events(const EventBuffer&) override;
     void _push_stats_pre(const Spill& spill) override;
 
     bool _accept_spill(const Spill& spill) override;
@@ -30,6 +31,12 @@ class Image2D : public Spectrum
 
     //reserve memory
     Entry entry_{{0, 0}, 0};
+    std::vector<uint8_t> selected_;
+    std::vector<size_t> bins_x_;
+    std::vector<size_t> bins_y_;
+    std::vector<PreciseFloat> intensities_;
+    std::vector<size_t> batch_;
+    std::vector<PreciseFloat> batch_counts_;
 };
 
 }
@@ -77,7 +77,7 @@ void Prebinned1D::_push_stats_pre(const Spill& spill)
   }
 }
 
-void Prebinned1D::_push_event(const Event& event)
+void Prebinned1D::_push_event(const EventView& event)
 {
   if (!filters_.accept(event))
     return;
@@ -45,6 +45,20 @@ Spectrum::Spectrum()
   real_time.set_flag("readonly");
   base_options.branches.add(real_time);
 
+  SettingMeta shards("shards", SettingType::integer, "Filling threads");
+  shards.set_val("min", 1);
+  shards.set_val("max", 64);
+  base_options.branches.add(shards);
+
+  SettingMeta storage("data_representation", SettingType::text, "Data representation");
+  storage.set_flag("readonly");
+  base_options.branches.add(storage);
+
+  SettingMeta memory("data_memory", SettingType::integer, "Data memory footprint");
+  memory.set_flag("readonly");
+  memory.set_val("units", "bytes");
+  base_options.branches.add(memory);
+
   base_options.branches.add(recent_rate_.update(Status(), 0));
 
   base_options.branches.add(periodic_trigger_.settings(-1, "Clear periodically"));
@@ -65,6 +79,8 @@ void Spectrum::_apply_attributes()
 
     periodic_trigger_.settings(metadata_.get_attribute(periodic_trigger_.settings()));
     metadata_.replace_attribute(periodic_trigger_.settings(-1, "Clear periodically"));
+
+    reshard(std::max(metadata_.get_attribute("shards").get_int(), integer_t(1)));
   }
   catch (...)
   {
@@ -93,6 +109,9 @@ void Spectrum::_push_stats_pre(const Spill& spill)
     if (data_)
     {
       data_->clear();
+      for (auto& p : shards_.partials)
+        p->clear();
+      data_stale_ = false;
       recent_rate_.update(recent_rate_.previous_status, data_->total_count());
     }
     periodic_trigger_.triggered = false;
@@ -106,8 +125,8 @@ void Spectrum::update_cumulative(const Status& new_status)
     stats_.pop_back();
   stats_.push_back(new_status);
 
-  auto live_time = Status::total_elapsed(stats_, "live_time");
-  auto real_time = Status::total_elapsed(stats_, "native_time");
+  auto live_time = Status::total_elapsed(stats_, SpillStats::live_time);
+  auto real_time = Status::total_elapsed(stats_, SpillStats::native_time);
   if (live_time == hr_duration_t())
     live_time = real_time;
   metadata_.set_attribute(Setting("live_time", live_time));
@@ -127,8 +146,10 @@ void Spectrum::_push_stats_post(const Spill& spill)
 
   if (data_)
   {
-    metadata_.set_attribute(Setting::precise("total_count", data_->total_count()));
-    metadata_.set_attribute(recent_rate_.update(new_status, data_->total_count()));
+    auto total = total_count();
+    metadata_.set_attribute(Setting::precise("total_count", total));
+    metadata_.set_attribute(recent_rate_.update(new_status, total));
+    update_storage();
   }
 }
 
@@ -139,6 +160,111 @@ void Spectrum::_flush()
   metadata_.set_attribute(Setting::precise("total_count", data_->total_count()));
   metadata_.set_attribute(
       recent_rate_.update(recent_rate_.previous_status, data_->total_count()));
+  update_storage();
+}
+
+void Spectrum::_merge(const ConsumerMetadata& other)
+{
+  // times add up, as for runs that were acquired one after another
+  for (auto name : {"live_time", "real_time"})
+  {
+    auto time = metadata_.get_attribute(name).duration()
+        + other.get_attribute(name).duration();
+    metadata_.set_attribute(Setting(name, time));
+  }
+  metadata_.set_attribute(Setting::precise("total_count", data_->total_count()));
+  update_storage();
+}
+
+void Spectrum::_sync_data()
+{
+  if (!data_)
+    return;
+  for (auto& p : shards_.partials)
+  {
+    if (p->empty())
+      continue;
+    // axes of data_ may have been updated since the partial was made
+    for (uint16_t i = 0; i < data_->dimensions(); ++i)
+      p->set_axis(i, data_->axis(i));
+    data_->merge(*p);
+    p->clear();
+  }
+  this->_recalc_axes();
+  metadata_.set_attribute(Setting::precise("total_count", data_->total_count()));
+  update_storage();
+}
+
+Spectrum::Shards::Shards(const Shards& other)
+{
+  for (const auto& p : other.partials)
+    partials.push_back(DataspacePtr(p->clone()));
+  if (other.pool)
+    pool = std::make_unique<ThreadPool>(other.pool->size());
+}
+
+void Spectrum::reshard(size_t count)
+{
+  if (!data_ || (count == (shards_.partials.size() + 1)))
+    return;
+
+  if (data_stale_)
+  {
+    _sync_data();
+    data_stale_ = false;
+  }
+
+  shards_.partials.clear();
+  shards_.pool.reset();
+  if (count < 2)
+    return;
+
+  for (size_t i = 1; i < count; ++i)
+  {
+    shards_.partials.push_back(DataspacePtr(data_->clone()));
+    shards_.partials.back()->clear();
+  }
+  shards_.pool = std::make_unique<ThreadPool>(count);
+}
+
+void Spectrum::fill_ones(const std::vector<size_t>& coords)
+{
+  size_t dims = std::max(data_->dimensions(), uint16_t(1));
+  size_t events = coords.size() / dims;
+  size_t count = shards_.partials.size() + 1;
+
+  // not worth waking up the threads for
+  if ((count < 2) || (events < (count << 10)))
+  {
+    data_->add_ones(coords);
+    return;
+  }
+
+  shards_.pool->parallel_for(count, [&](size_t i)
+  {
+    auto& target = i ? shards_.partials[i - 1] : data_;
+    target->add_ones(coords.data() + (events * i / count) * dims,
+                     coords.data() + (events * (i + 1) / count) * dims);
+  });
+  data_stale_ = true;
+}
+
+PreciseFloat Spectrum::total_count() const
+{
+  PreciseFloat ret = data_->total_count();
+  for (const auto& p : shards_.partials)
+    ret += p->total_count();
+  return ret;
+}
+
+void Spectrum::update_storage()
+{
+  // only dataspaces that can change representation report it
+  auto representation = data_->representation();
+  if (representation.empty())
+    return;
+  metadata_.set_attribute(Setting::text("data_representation", representation));
+  metadata_.set_attribute(Setting::integer("data_memory", data_->memory_footprint()));
 }
 
 }
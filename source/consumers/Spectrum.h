@@ -12,6 +12,7 @@
 #include <consumers/add_ons/PeriodicTrigger.h>
 #include <consumers/add_ons/RecentRate.h>
 #include <consumers/add_ons/FilterBlock.h>
+#include <core/ThreadPool.h>
 
 namespace DAQuiri {
 
@@ -26,6 +27,8 @@ class Spectrum : public Consumer
     void _push_stats_pre(const Spill& spill) override;
     void _push_stats_post(const Spill& spill) override;
     void _flush() override;
+    void _merge(const ConsumerMetadata& other) override;
+    void _sync_data() override;
 
   protected:
     PeriodicTrigger periodic_trigger_;
@@ -36,7 +39,27 @@ class Spectrum : public Consumer
 
     std::vector<Status> stats_;
 
+    /// partial dataspaces filled alongside data_, by "shards" threads
+    struct Shards
+    {
+      Shards() {}
+      Shards(const Shards& other);
+      Shards& operator=(const Shards&) = delete;
+
+      std::vector<DataspacePtr> partials;
+      std::unique_ptr<ThreadPool> pool;
+    };
+    Shards shards_;
+
     void update_cumulative(const Status&);
+    void update_storage();
+
+    /// \brief adds packed coords as Dataspace::add_ones does, large batches
+    ///         are split between data_ and the partials if sharded
+    void fill_ones(const std::vector<size_t>& coords);
+    /// \brief of data_ and the partials not merged into it yet
+    PreciseFloat total_count() const;
+    void reshard(size_t count);
 };
 
 }
@@ -40,6 +40,7 @@ void StatsScalar::_apply_attributes()
 {
   Spectrum::_apply_attributes();
   what_ = metadata_.get_attribute("what_stats").get_text();
+  what_field_ = SpillStats::field(what_);
   diff_ = metadata_.get_attribute("diff").get_bool();
   this->_recalc_axes();
 }
@@ -54,14 +55,27 @@ void StatsScalar::_push_stats_pre(const Spill& spill)
   if (!this->_accept_spill(spill))
     return;
 
-  auto set = spill.state.find(Setting(what_));
-  if (set)
+  bool found {false};
+  PreciseFloat value {0};
+  if (what_field_ != SpillStats::field_count)
+    found = spill.find_stat(what_field_, value);
+  else
   {
-    entry_.second = set.get_number();
+    auto set = spill.state.find(Setting(what_));
+    if (set)
+    {
+      value = set.get_number();
+      found = true;
+    }
+  }
+
+  if (found)
+  {
+    entry_.second = value;
     if (diff_)
     {
       entry_.second -= previous_;
-      previous_ = set.get_number();
+      previous_ = value;
     }
     data_->add(entry_);
   }
@@ -93,7 +107,7 @@ bool StatsScalar::_accept_events(const Spill& /*spill*/)
   return false;
 }
 
-void StatsScalar::_push_event(const Event& /*event*/)
+void StatsScalar::_push_event(const EventView& /*event*/)
 {
   // do nothing here
   // this should never be called anyhow because of above
@@ -18,13 +18,14 @@ class StatsScalar : public Spectrum
     void _recalc_axes() override;
 
     //event processing
-    void _push_event(const Event& event) override;
+    void _push_event(const EventView& event) override;
     void _push_stats_pre(const Spill& spill) override;
     bool _accept_events(const Spill& spill) override;
     void _flush() override;
 
     // cached parameters:
     std::string what_{0};
+    SpillStats::Field what_field_{SpillStats::field_count};
 
     bool diff_{false};
     PreciseFloat previous_{0};
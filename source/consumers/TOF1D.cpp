@@ -93,8 +93,9 @@ void TOF1D::_push_stats_pre(const Spill& spill)
   if (!this->_accept_spill(spill))
     return;
   timebase_ = spill.event_model.timebase;
-  pulse_time_ = timebase_.to_nanosec(
-      spill.state.find(Setting("pulse_time")).get_number());
+  PreciseFloat pulse_time {std::numeric_limits<double>::quiet_NaN()};
+  spill.find_stat(SpillStats::pulse_time, pulse_time);
+  pulse_time_ = timebase_.to_nanosec(pulse_time);
   Spectrum::_push_stats_pre(spill);
 }
 
@@ -103,12 +104,28 @@ bool TOF1D::_accept_events(const Spill& /*spill*/)
   return ((pulse_time_ >= 0) && (0 != time_resolution_));
 }
 
-void TOF1D::_push_event(const Event& event)
+void TOF1D::_push_event(const EventView& event)
 {
   if (!filters_.accept(event))
     return;
+  bin(event.timestamp());
+}
 
-  double nsecs = timebase_.to_nanosec(event.timestamp()) - pulse_time_;
+bool TOF1D::_push_columns(const EventColumns& columns)
+{
+  // filters need decoded values, and so do events the decoder
+  // may reject if there is no cheaper way to tell which
+  if (filters_.valid || !columns.validates())
+    return false;
+  for (size_t i = 0; i < columns.size(); ++i)
+    if (columns.valid(i))
+      bin(columns.timestamp(i));
+  return true;
+}
+
+void TOF1D::bin(uint64_t timestamp)
+{
+  double nsecs = timebase_.to_nanosec(timestamp) - pulse_time_;
 
   if (nsecs < 0)
     return;
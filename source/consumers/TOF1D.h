@@ -19,7 +19,8 @@ class TOF1D : public Spectrum
 
     //event processing
     void _push_stats_pre(const Spill& spill) override;
-    void _push_event(const Event& event) override;
+    void _push_event(const EventView& event) override;
+    bool _push_columns(const EventColumns& columns) override;
 
     bool _accept_spill(const Spill& spill) override;
     bool _accept_events(const Spill& spill) override;
@@ -39,6 +40,8 @@ class TOF1D : public Spectrum
 
     //reserve memory
     Coords coords_{0};
+
+    void bin(uint64_t timestamp);
 };
 
 }
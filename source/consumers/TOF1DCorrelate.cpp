@@ -68,6 +68,13 @@ void TOF1DCorrelate::_recalc_axes()
   data_->set_axis(0, DataAxis(Calibration(id, id), domain_));
 }
 
+std::set<std::string> TOF1DCorrelate::_streams() const
+{
+  auto ret = Spectrum::_streams();
+  ret.insert(chopper_stream_id_);
+  return ret;
+}
+
 bool TOF1DCorrelate::_accept_spill(const Spill& spill)
 {
   return (spill.stream_id == chopper_stream_id_) || Spectrum::_accept_spill(spill);
@@ -87,8 +94,12 @@ void TOF1DCorrelate::_push_stats_pre(const Spill& spill)
   if (spill.stream_id == chopper_stream_id_)
   {
     chopper_timebase_ = spill.event_model.timebase;
-    for (auto& e : spill.events)
-      chopper_buffer_.push_back(e.timestamp());
+    if (spill.columns)
+      for (size_t i = 0; i < spill.columns->size(); ++i)
+        chopper_buffer_.push_back(spill.columns->timestamp(i));
+    else
+      for (const auto& e : spill.events)
+        chopper_buffer_.push_back(e.timestamp());
   }
   else
   {
@@ -159,7 +170,7 @@ bool TOF1DCorrelate::bin_events()
   return true;
 }
 
-void TOF1DCorrelate::_push_event(const Event& event)
+void TOF1DCorrelate::_push_event(const EventView& event)
 {
   if (!filters_.accept(event))
     return;
@@ -89,8 +89,9 @@ void TOFVal2D::_push_stats_pre(const Spill& spill)
   if (!this->_accept_spill(spill))
     return;
   timebase_ = spill.event_model.timebase;
-  pulse_time_ = timebase_.to_nanosec(
-      spill.state.find(Setting("pulse_time")).get_number());
+  PreciseFloat pulse_time {std::numeric_limits<double>::quiet_NaN()};
+  spill.find_stat(SpillStats::pulse_time, pulse_time);
+  pulse_time_ = timebase_.to_nanosec(pulse_time);
   value_latch_.configure(spill);
   Spectrum::_push_stats_pre(spill);
 }
@@ -102,7 +103,7 @@ bool TOFVal2D::_accept_events(const Spill& /*spill*/)
       (pulse_time_ >= 0);
 }
 
-void TOFVal2D::_push_event(const Event& event)
+void TOFVal2D::_push_event(const EventView& event)
 {
   if (!filters_.accept(event))
     return;
@@ -128,4 +129,42 @@ void TOFVal2D::_push_event(const Event& event)
   data_->add_one(coords_);
 }
 
+void TOFVal2D::_push_events(const EventBuffer& events)
+{
+  filters_.select(events, selected_);
+  value_latch_.extract(bins_, events);
+
+  const uint64_t* times = events.timestamps();
+  size_t max_bin = 0;
+  batch_.clear();
+  for (size_t i = 0; i < events.size(); ++i)
+  {
+    if (!selected_[i])
+      continue;
+
+    double nsecs = timebase_.to_nanosec(times[i]) - pulse_time_;
+    if (nsecs < 0)
+      continue;
+
+    size_t bin = static_cast<size_t>(nsecs * time_resolution_);
+    max_bin = std::max(max_bin, bin);
+    batch_.push_back(bin);
+    batch_.push_back(bins_[i]);
+  }
+
+  if (batch_.empty())
+    return;
+
+  if (max_bin >= domain_.size())
+  {
+    size_t oldbound = domain_.size();
+    domain_.resize(max_bin + 1);
+
+    for (size_t i = oldbound; i <= max_bin; ++i)
+      domain_[i] = i / time_resolution_ / units_multiplier_;
+  }
+
+  fill_ones(batch_);
+}
+
 }
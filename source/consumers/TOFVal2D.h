@@ -20,7 +20,8 @@ class TOFVal2D : public Spectrum
 
     //event processing
     void _push_stats_pre(const Spill& spill) override;
-    void _push_event(const Event&) override;
+    void _push_event(const EventView&) override;
+    void _push_events(const EventBuffer&) override;
 
     bool _accept_spill(const Spill& spill) override;
     bool _accept_events(const Spill& spill) override;
@@ -41,6 +42,9 @@ class TOFVal2D : public Spectrum
 
     //reserve memory
     Coords coords_{0, 0};
+    std::vector<uint8_t> selected_;
+    std::vector<size_t> bins_;
+    std::vector<size_t> batch_;
 };
 
 }
@@ -83,6 +83,13 @@ void TOFVal2DCorrelate::_recalc_axes()
   data_->set_axis(0, DataAxis(Calibration(id, id), domain_));
 }
 
+std::set<std::string> TOFVal2DCorrelate::_streams() const
+{
+  auto ret = Spectrum::_streams();
+  ret.insert(chopper_stream_id_);
+  return ret;
+}
+
 bool TOFVal2DCorrelate::_accept_spill(const Spill& spill)
 {
   return (spill.stream_id == chopper_stream_id_) ||
@@ -104,8 +111,12 @@ void TOFVal2DCorrelate::_push_stats_pre(const Spill& spill)
   if (spill.stream_id == chopper_stream_id_)
   {
     chopper_timebase_ = spill.event_model.timebase;
-    for (auto& e : spill.events)
-      chopper_buffer_.push_back(e.timestamp());
+    if (spill.columns)
+      for (size_t i = 0; i < spill.columns->size(); ++i)
+        chopper_buffer_.push_back(spill.columns->timestamp(i));
+    else
+      for (const auto& e : spill.events)
+        chopper_buffer_.push_back(e.timestamp());
   }
   else
   {
@@ -180,12 +191,12 @@ bool TOFVal2DCorrelate::bin_events()
   return true;
 }
 
-void TOFVal2DCorrelate::_push_event(const Event& event)
+void TOFVal2DCorrelate::_push_event(const EventView& event)
 {
   if (!filters_.accept(event))
     return;
 
-  events_buffer_.push_back(event);
+  events_buffer_.emplace_back(event);
 }
 
 }
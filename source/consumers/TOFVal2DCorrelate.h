@@ -25,9 +25,10 @@ class TOFVal2DCorrelate : public Spectrum
 
   //event processing
   void _push_stats_pre(const Spill& spill) override;
-  void _push_event(const Event& event) override;
+  void _push_event(const EventView& event) override;
   void _push_stats_post(const Spill& spill) override;
 
+  std::set<std::string> _streams() const override;
   bool _accept_spill(const Spill& spill) override;
   bool _accept_events(const Spill& spill) override;
 
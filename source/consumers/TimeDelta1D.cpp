@@ -101,7 +101,7 @@ bool TimeDelta1D::_accept_events(const Spill& /*spill*/)
   return (0 != time_resolution_);
 }
 
-void TimeDelta1D::_push_event(const Event& event)
+void TimeDelta1D::_push_event(const EventView& event)
 {
   if (!filters_.accept(event))
     return;
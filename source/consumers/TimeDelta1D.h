@@ -19,7 +19,7 @@ class TimeDelta1D : public Spectrum
 
     //event processing
     void _push_stats_pre(const Spill& spill) override;
-    void _push_event(const Event& event) override;
+    void _push_event(const EventView& event) override;
 
     bool _accept_spill(const Spill& spill) override;
     bool _accept_events(const Spill& spill) override;
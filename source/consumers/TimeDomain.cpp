@@ -105,7 +105,7 @@ void TimeDomain::_push_stats_pre(const Spill& spill)
   Spectrum::_push_stats_pre(spill);
 }
 
-void TimeDomain::_push_event(const Event& event)
+void TimeDomain::_push_event(const EventView& event)
 {
   if (!filters_.accept(event))
     return;
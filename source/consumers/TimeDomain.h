@@ -18,7 +18,7 @@ class TimeDomain : public Spectrum
     void _recalc_axes() override;
 
     //event processing
-    void _push_event(const Event& event) override;
+    void _push_event(const EventView& event) override;
     void _push_stats_pre(const Spill& spill) override;
 
     bool _accept_events(const Spill& spill) override;
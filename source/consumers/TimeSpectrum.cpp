@@ -1,5 +1,5 @@
 #include <consumers/TimeSpectrum.h>
-#include <consumers/dataspaces/SparseMatrix2D.h>
+#include <consumers/dataspaces/TileMap2D.h>
 
 #include <core/util/logger.h>
 
@@ -7,7 +7,7 @@ namespace DAQuiri {
 
 TimeSpectrum::TimeSpectrum()
 {
-  data_ = std::make_shared<SparseMatrix2D>(); //use dense 2d
+  data_ = std::make_shared<TileMap2D>();
 
   Setting base_options = metadata_.attributes();
   metadata_ = ConsumerMetadata(my_type(), "Spectra in time series");
@@ -97,7 +97,7 @@ bool TimeSpectrum::_accept_events(const Spill& /*spill*/)
   return value_latch_.valid() && (0 != time_resolution_);
 }
 
-void TimeSpectrum::_push_event(const Event& event)
+void TimeSpectrum::_push_event(const EventView& event)
 {
   if (!filters_.accept(event))
     return;
@@ -120,4 +120,39 @@ void TimeSpectrum::_push_event(const Event& event)
   data_->add_one(coords_);
 }
 
+void TimeSpectrum::_push_events(const EventBuffer& events)
+{
+  filters_.select(events, selected_);
+  value_latch_.extract(bins_, events);
+
+  const uint64_t* times = events.timestamps();
+  size_t max_bin = 0;
+  batch_.clear();
+  for (size_t i = 0; i < events.size(); ++i)
+  {
+    if (!selected_[i])
+      continue;
+
+    double nsecs = timebase_.to_nanosec(times[i]);
+    size_t bin = static_cast<size_t>(std::round(nsecs * time_resolution_));
+    max_bin = std::max(max_bin, bin);
+    batch_.push_back(bin);
+    batch_.push_back(bins_[i]);
+  }
+
+  if (batch_.empty())
+    return;
+
+  if (max_bin >= domain_.size())
+  {
+    size_t oldbound = domain_.size();
+    domain_.resize(max_bin + 1);
+
+    for (size_t i = oldbound; i <= max_bin; ++i)
+      domain_[i] = i / time_resolution_ / units_multiplier_;
+  }
+
+  fill_ones(batch_);
+}
+
 }
@@ -19,7 +19,8 @@ class TimeSpectrum : public Spectrum
     void _recalc_axes() override;
 
     //event processing
-    void _push_event(const Event&) override;
+    void _push_event(const EventView&) override;
+    void _push_events(const EventBuffer&) override;
     void _push_stats_pre(const Spill& spill) override;
 
     bool _accept_spill(const Spill& spill) override;
@@ -38,6 +39,9 @@ class TimeSpectrum : public Spectrum
 
     //reserve memory
     Coords coords_{0, 0};
+    std::vector<uint8_t> selected_;
+    std::vector<size_t> bins_;
+    std::vector<size_t> batch_;
 };
 
 }
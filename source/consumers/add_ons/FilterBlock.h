@@ -11,7 +11,8 @@ struct FilterBlock
 
   void configure(const Spill& spill);
 
-  inline bool accept(const Event& event) const
+  template<typename EventT>
+  inline bool accept(const EventT& event) const
   {
     if (!valid)
       return true;
@@ -21,6 +22,17 @@ struct FilterBlock
     return true;
   }
 
+  /// \brief marks which events of the buffer pass all filters
+  inline void select(const EventBuffer& events,
+                     std::vector<uint8_t>& selected) const
+  {
+    selected.assign(events.size(), 1);
+    if (!valid)
+      return;
+    for (auto& f : filters_)
+      f.select(events, selected);
+  }
+
   std::vector<ValueFilter> filters_;
   bool valid {false};
 };
@@ -62,7 +62,7 @@ void PeriodicTrigger::update(const Status& current)
 
   if (clock_type == ClockType::NativeTime)
   {
-    auto recent_native_time = Status::calc_diff(previous_, current, "native_time");
+    auto recent_native_time = Status::calc_diff(previous_, current, SpillStats::native_time);
     if (recent_native_time != hr_duration_t())
       recent_time_ += recent_native_time;
   }
@@ -11,26 +11,43 @@ Status Status::extract(const Spill& spill)
   ret.producer_time = spill.time;
   ret.consumer_time = std::chrono::system_clock::now();
   ret.timebase = spill.event_model.timebase;
-  Setting native_time = spill.state.find(Setting("native_time"));
-  if (native_time)
-    ret.stats["native_time"] = native_time;
-  auto live_time = spill.state.find(Setting("live_time"));
-  if (live_time)
-    ret.stats["live_time"] = live_time;
+  PreciseFloat value;
+  if (spill.find_stat(SpillStats::native_time, value))
+    ret.stats.set(SpillStats::native_time, value);
+  if (spill.find_stat(SpillStats::live_time, value))
+    ret.stats.set(SpillStats::live_time, value);
   return ret;
 }
 
-// TODO: make this work with nanoseconds
 hr_duration_t Status::calc_diff(const Status& from, const Status& to, std::string name)
 {
-  if (!from.stats.count(name) || !to.stats.count(name))
+  auto field = SpillStats::field(name);
+  if (field == SpillStats::field_count)
+    return hr_duration_t();
+  return calc_diff(from, to, field);
+}
+
+// TODO: make this work with nanoseconds
+hr_duration_t Status::calc_diff(const Status& from, const Status& to,
+                                SpillStats::Field field)
+{
+  if (!from.stats.has(field) || !to.stats.has(field))
     return hr_duration_t();
-  auto diff = to.stats.at(name).get_number() - from.stats.at(name).get_number();
+  auto diff = to_double(to.stats.get(field)) - to_double(from.stats.get(field));
   auto diff_us = to.timebase.to_microsec(diff);
   return std::chrono::microseconds(static_cast<uint64_t>(diff_us));
 }
 
 hr_duration_t Status::total_elapsed(const std::vector<Status>& stats, std::string name)
+{
+  auto field = SpillStats::field(name);
+  if (field == SpillStats::field_count)
+    return hr_duration_t();
+  return total_elapsed(stats, field);
+}
+
+hr_duration_t Status::total_elapsed(const std::vector<Status>& stats,
+                                    SpillStats::Field field)
 {
   hr_duration_t t {std::chrono::seconds(0)};
   hr_duration_t ret {std::chrono::seconds(0)};
@@ -46,7 +63,7 @@ hr_duration_t Status::total_elapsed(const std::vector<Status>& stats, std::strin
     }
     else
     {
-      t = calc_diff(start, q, name);
+      t = calc_diff(start, q, field);
       if (t == hr_duration_t())
         return t;
     }
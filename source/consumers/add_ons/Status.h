@@ -8,15 +8,19 @@ struct Status
 {
   static Status extract(const Spill& spill);
 
+  static hr_duration_t calc_diff(const Status& from, const Status& to,
+                                 SpillStats::Field field);
   static hr_duration_t calc_diff(const Status& from, const Status& to, std::string name);
 
+  static hr_duration_t total_elapsed(const std::vector<Status>& stats,
+                                     SpillStats::Field field);
   static hr_duration_t total_elapsed(const std::vector<Status>& stats, std::string name);
 
   bool valid {false};
   Spill::Type type{Spill::Type::daq_status};
   hr_time_t producer_time {};
   hr_time_t consumer_time {};
-  std::map<std::string, Setting> stats;
+  SpillStats stats;
   TimeBase timebase;
 };
 
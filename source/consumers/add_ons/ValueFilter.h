@@ -11,7 +11,8 @@ struct ValueFilter
 
   void configure(const Spill& spill);
 
-  inline bool accept(const Event& event) const
+  template<typename EventT>
+  inline bool accept(const EventT& event) const
   {
     if (!valid())
       return true;
@@ -19,6 +20,17 @@ struct ValueFilter
     return ((value_ >= min_) && (value_ <= max_));
   }
 
+  /// \brief clears selected[i] for every event failing the filter
+  inline void select(const EventBuffer& events,
+                     std::vector<uint8_t>& selected) const
+  {
+    if (!valid())
+      return;
+    const uint32_t* vals = events.values(static_cast<size_t>(idx_));
+    for (size_t i = 0; i < events.size(); ++i)
+      selected[i] &= static_cast<uint8_t>((vals[i] >= min_) & (vals[i] <= max_));
+  }
+
   inline bool valid() const
   {
     return (enabled_ && (idx_ >= 0));
@@ -17,8 +17,8 @@ struct ValueLatch
 
     void configure(const Spill& spill);
 
-    template<typename T>
-    inline void extract(T& bin, const Event& event) const
+    template<typename T, typename EventT>
+    inline void extract(T& bin, const EventT& event) const
     {
       if (downsample)
         bin = event.value(static_cast<size_t>(idx)) >> downsample;
@@ -26,6 +26,16 @@ struct ValueLatch
         bin = event.value(static_cast<size_t>(idx));
     }
 
+    template<typename T>
+    inline void extract(std::vector<T>& bins, const EventBuffer& events) const
+    {
+      bins.resize(events.size());
+      const uint32_t* vals = events.values(static_cast<size_t>(idx));
+      const auto shift = downsample;
+      for (size_t i = 0; i < events.size(); ++i)
+        bins[i] = vals[i] >> shift;
+    }
+
     inline bool valid() const
     {
       return (idx >= 0);
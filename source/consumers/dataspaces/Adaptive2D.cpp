@@ -0,0 +1,475 @@
+#include <consumers/dataspaces/Adaptive2D.h>
+#include <consumers/dataspaces/SparseLayout.h>
+
+namespace DAQuiri {
+
+Adaptive2D::Adaptive2D(double promote_fraction, double demote_fraction)
+    : Dataspace(2)
+    , promote_fraction_(promote_fraction)
+    , demote_fraction_(std::min(demote_fraction, promote_fraction))
+{}
+
+bool Adaptive2D::empty() const
+{
+  return !filled_;
+}
+
+void Adaptive2D::clear()
+{
+  touch_all();
+  dense_ = false;
+  sparse_ = CountHash<uint32_t>();
+  promote_at_ = 0;
+  bins_ = CountArray();
+  rows_ = 0;
+  cols_ = 0;
+  filled_ = false;
+  max0_ = 0;
+  max1_ = 0;
+  changed_.clear();
+  total_count_ = 0;
+}
+
+void Adaptive2D::add(const Entry& e)
+{
+  touch();
+  if ((e.first.size() != dimensions()) || !e.second)
+    return;
+  bin_pair(e.first[0], e.first[1], e.second);
+}
+
+void Adaptive2D::add_one(const Coords& coords)
+{
+  touch();
+  if (coords.size() != dimensions())
+    return;
+  bin_one(coords[0], coords[1]);
+}
+
+void Adaptive2D::add_ones(const size_t* begin, const size_t* end)
+{
+  touch();
+  for (auto i = begin; i + 1 < end; i += 2)
+    bin_one(i[0], i[1]);
+}
+
+void Adaptive2D::add_many(const std::vector<size_t>& coords,
+                          const std::vector<PreciseFloat>& counts)
+{
+  touch();
+  for (size_t i = 0; (i < counts.size()) && (2 * i + 1 < coords.size()); ++i)
+    if (counts[i])
+      bin_pair(coords[2 * i], coords[2 * i + 1], counts[i]);
+}
+
+void Adaptive2D::extend(uint16_t x, uint16_t y)
+{
+  max0_ = filled_ ? std::max(max0_, x) : x;
+  max1_ = filled_ ? std::max(max1_, y) : y;
+  filled_ = true;
+  if (changed_.size() <= max0_)
+    changed_.resize(size_t(max0_) + 1, 0);
+
+  double area = (size_t(max0_) + 1) * (size_t(max1_) + 1);
+  promote_at_ = static_cast<size_t>(promote_fraction_ * area);
+
+  if (!dense_ || ((max0_ < rows_) && (max1_ < cols_)))
+    return;
+
+  // matrix must be reallocated anyway, see if it is still worth it
+  if (dense_nonzeros() < demote_fraction_ * area)
+    demote();
+  else
+    reshape(size_t(max0_) + 1, size_t(max1_) + 1);
+}
+
+void Adaptive2D::promote()
+{
+  reshape(size_t(max0_) + 1, size_t(max1_) + 1);
+  sparse_.for_each([this](uint32_t k, const PreciseFloat& c)
+                   {
+                     bins_.add((k >> 16) * cols_ + (k & 0xFFFF), c);
+                   });
+  sparse_ = CountHash<uint32_t>();
+  dense_ = true;
+}
+
+void Adaptive2D::demote()
+{
+  sparse_ = CountHash<uint32_t>();
+  for (size_t x = 0; x < rows_; ++x)
+    for (size_t y = 0; y < cols_; ++y)
+    {
+      auto count = bins_.get(x * cols_ + y);
+      if (count != 0)
+        sparse_[key(x, y)] = count;
+    }
+  bins_ = CountArray();
+  rows_ = 0;
+  cols_ = 0;
+  dense_ = false;
+}
+
+void Adaptive2D::reshape(size_t rows, size_t cols)
+{
+  size_t r = 16, c = 16;
+  while (r < rows)
+    r <<= 1;
+  while (c < cols)
+    c <<= 1;
+  if ((r == rows_) && (c == cols_))
+    return;
+
+  CountArray bins;
+  bins.resize(r * c);
+  for (size_t x = 0; x < rows_; ++x)
+    for (size_t y = 0; y < cols_; ++y)
+    {
+      auto count = bins_.get(x * cols_ + y);
+      if (count != 0)
+        bins.add(x * c + y, count);
+    }
+  bins_ = std::move(bins);
+  rows_ = r;
+  cols_ = c;
+}
+
+size_t Adaptive2D::dense_nonzeros() const
+{
+  size_t ret = 0;
+  for (size_t i = 0; i < bins_.size(); ++i)
+    if (bins_.get(i) != 0)
+      ret++;
+  return ret;
+}
+
+std::string Adaptive2D::representation() const
+{
+  return dense_ ? "dense" : "sparse";
+}
+
+size_t Adaptive2D::memory_footprint() const
+{
+  return sizeof(*this) + sparse_.bytes() + bins_.bytes();
+}
+
+void Adaptive2D::recalc_axes()
+{
+  auto ax0 = axis(0);
+  ax0.expand_domain(max0_);
+  set_axis(0, ax0);
+
+  auto ax1 = axis(1);
+  ax1.expand_domain(max1_);
+  set_axis(1, ax1);
+}
+
+PreciseFloat Adaptive2D::at(uint16_t x, uint16_t y) const
+{
+  if (!within(x, y))
+    return 0;
+  if (dense_)
+    return bins_.get(x * cols_ + y);
+  auto count = sparse_.find(key(x, y));
+  return count ? *count : PreciseFloat(0);
+}
+
+PreciseFloat Adaptive2D::get(const Coords& coords) const
+{
+  if (coords.size() != dimensions())
+    return 0;
+  return at(coords[0], coords[1]);
+}
+
+EntryList Adaptive2D::range(std::vector<Pair> list) const
+{
+  Coords lo, hi;
+  range_bounds(list, {max0_, max1_}, lo, hi);
+  EntryList result(new EntryList_t);
+  fill_list(result, lo[0], hi[0], lo[1], hi[1]);
+  return result;
+}
+
+void Adaptive2D::read_range(DataBlock& block, std::vector<Pair> list) const
+{
+  Coords lo, hi;
+  range_bounds(list, {max0_, max1_}, lo, hi);
+  size_t min0 = lo[0], max0 = hi[0], min1 = lo[1], max1 = hi[1];
+
+  if (!dense_)
+  {
+    block.reset_sparse(2);
+    sparse_.for_each([&](uint32_t k, const PreciseFloat& c)
+                     {
+                       size_t co0 = k >> 16;
+                       size_t co1 = k & 0xFFFF;
+                       if ((min0 > co0) || (co0 > max0) ||
+                           (min1 > co1) || (co1 > max1))
+                         return;
+                       block.push(co0, co1, to_double(c));
+                     });
+    return;
+  }
+
+  max0 = std::min(max0, size_t(max0_));
+  max1 = std::min(max1, size_t(max1_));
+  if ((min0 > max0) || (min1 > max1))
+  {
+    block.reset_dense({min0, min1}, {0, 0});
+    return;
+  }
+
+  block.reset_dense({min0, min1}, {max0 - min0 + 1, max1 - min1 + 1});
+  size_t i = 0;
+  for (size_t x = min0; x <= max0; ++x)
+    for (size_t y = min1; y <= max1; ++y)
+      block.counts[i++] = to_double(bins_.get(x * cols_ + y));
+}
+
+bool Adaptive2D::range_since(DataBlock& block, uint64_t since) const
+{
+  if (since < cleared_version_)
+  {
+    read_range(block, {});
+    return false;
+  }
+
+  block.reset_sparse(2);
+  if (!dense_)
+  {
+    sparse_.for_each([&](uint32_t k, const PreciseFloat& c)
+                     {
+                       size_t co0 = k >> 16;
+                       if (changed_[co0] > since)
+                         block.push(co0, k & 0xFFFF, to_double(c));
+                     });
+    return true;
+  }
+
+  for (size_t x = 0; x < changed_.size(); ++x)
+  {
+    if (changed_[x] <= since)
+      continue;
+    for (size_t y = 0; y <= max1_; ++y)
+    {
+      auto count = bins_.get(x * cols_ + y);
+      if (count != 0)
+        block.push(x, y, to_double(count));
+    }
+  }
+  return true;
+}
+
+const Adaptive2D::Level& Adaptive2D::update_level(uint16_t level) const
+{
+  if (pyramid_.levels.size() < level)
+    pyramid_.levels.resize(level);
+  auto& lv = pyramid_.levels[level - 1];
+
+  size_t rows = (size_t(max0_) >> level) + 1;
+  size_t cols = (size_t(max1_) >> level) + 1;
+  bool all = (lv.version < cleared_version_) ||
+      (lv.rows != rows) || (lv.cols != cols);
+  if (!all && (lv.version == version_))
+    return lv;
+
+  // each level is made from the one below it
+  const Level* finer = (level > 1) ? &update_level(level - 1) : nullptr;
+
+  if (all)
+  {
+    lv.rows = rows;
+    lv.cols = cols;
+    lv.bins.assign(rows * cols, 0);
+  }
+
+  size_t fine_rows = size_t(max0_) + 1;
+  for (size_t x = 0; x < rows; ++x)
+  {
+    size_t first = x << level;
+    size_t last = std::min(first + (size_t(1) << level), fine_rows);
+    bool dirty = all;
+    for (size_t i = first; !dirty && (i < last); ++i)
+      dirty = (changed_[i] > lv.version);
+    if (!dirty)
+      continue;
+
+    double* row = &lv.bins[x * cols];
+    std::fill(row, row + cols, 0.0);
+    if (finer)
+    {
+      for (size_t i = 2 * x; i < std::min(2 * x + 2, finer->rows); ++i)
+      {
+        const double* src = &finer->bins[i * finer->cols];
+        for (size_t j = 0; j < finer->cols; ++j)
+          row[j >> 1] += src[j];
+      }
+    }
+    else
+    {
+      for (size_t i = first; i < last; ++i)
+        for (size_t j = 0; j <= max1_; ++j)
+          row[j >> 1] += to_double(bins_.get(i * cols_ + j));
+    }
+  }
+
+  lv.version = version_;
+  return lv;
+}
+
+void Adaptive2D::read_level(DataBlock& block, uint16_t level,
+                            std::vector<Pair> list) const
+{
+  if (!level || !dense_ || (level >= 16))
+  {
+    Dataspace::read_level(block, level, list);
+    return;
+  }
+
+  Coords lo, hi;
+  range_bounds(list, {max0_, max1_}, lo, hi);
+  size_t min0 = lo[0], max0 = hi[0], min1 = lo[1], max1 = hi[1];
+
+  std::lock_guard<std::mutex> lock(pyramid_.mutex);
+  const auto& lv = update_level(level);
+
+  min0 >>= level;
+  min1 >>= level;
+  max0 = std::min(max0 >> level, lv.rows - 1);
+  max1 = std::min(max1 >> level, lv.cols - 1);
+  if ((min0 > max0) || (min1 > max1))
+  {
+    block.reset_dense({min0, min1}, {0, 0});
+    return;
+  }
+
+  size_t width = max1 - min1 + 1;
+  block.reset_dense({min0, min1}, {max0 - min0 + 1, width});
+  for (size_t x = min0; x <= max0; ++x)
+    std::copy(&lv.bins[x * lv.cols + min1], &lv.bins[x * lv.cols + min1] + width,
+              &block.counts[(x - min0) * width]);
+}
+
+void Adaptive2D::fill_list(EntryList& result,
+                           size_t min0, size_t max0,
+                           size_t min1, size_t max1) const
+{
+  if (!filled_)
+    return;
+
+  if (!dense_)
+  {
+    auto inside = [=](uint32_t k)
+    {
+      size_t co0 = k >> 16;
+      size_t co1 = k & 0xFFFF;
+      return (min0 <= co0) && (co0 <= max0) && (min1 <= co1) && (co1 <= max1);
+    };
+    for (const auto& it : sparse_.sorted(inside))
+      result->push_back({{size_t(it.first >> 16), size_t(it.first & 0xFFFF)},
+                         it.second});
+    return;
+  }
+
+  max0 = std::min(max0, size_t(max0_));
+  max1 = std::min(max1, size_t(max1_));
+  for (size_t x = min0; x <= max0; ++x)
+    for (size_t y = min1; y <= max1; ++y)
+    {
+      auto count = bins_.get(x * cols_ + y);
+      if (count != 0)
+        result->push_back({{x, y}, count});
+    }
+}
+
+void Adaptive2D::data_merge(const Dataspace& other)
+{
+  auto o = dynamic_cast<const Adaptive2D*>(&other);
+  if (!o)
+  {
+    Dataspace::data_merge(other);
+    return;
+  }
+  if (!o->dense_)
+  {
+    o->sparse_.for_each([this](uint32_t k, const PreciseFloat& c)
+                        {
+                          bin_pair(k >> 16, k & 0xFFFF, c);
+                        });
+    return;
+  }
+  // settle the extent first, so that storage is reallocated at most once
+  extend(o->max0_, o->max1_);
+  for (size_t x = 0; x <= o->max0_; ++x)
+    for (size_t y = 0; y <= o->max1_; ++y)
+    {
+      auto count = o->bins_.get(x * o->cols_ + y);
+      if (count != 0)
+        bin_pair(x, y, count);
+    }
+}
+
+void Adaptive2D::data_save(const hdf5::node::Group& g) const
+{
+  if (!filled_)
+    return;
+
+  try
+  {
+    EntryList entries(new EntryList_t);
+    fill_list(entries, 0, max0_, 0, max1_);
+    save_entries(g, *entries, 2);
+  }
+  catch (...)
+  {
+    std::throw_with_nested(std::runtime_error("<Adaptive2D> Could not save"));
+  }
+}
+
+void Adaptive2D::data_load(const hdf5::node::Group& g)
+{
+  try
+  {
+    std::vector<std::vector<uint16_t>> indices;
+    std::vector<double> counts;
+    if (!load_entries(g, 2, indices, counts))
+      return;
+
+    clear();
+    // settle the extent first, so representation is decided only once
+    const auto& dx = indices[0];
+    const auto& dy = indices[1];
+    for (size_t i = 0; i < dx.size(); ++i)
+      if (!within(dx[i], dy[i]))
+        extend(dx[i], dy[i]);
+    for (size_t i = 0; i < dx.size(); ++i)
+      bin_pair(dx[i], dy[i], counts[i]);
+  }
+  catch (...)
+  {
+    std::throw_with_nested(std::runtime_error("<Adaptive2D> Could not load"));
+  }
+}
+
+std::string Adaptive2D::data_debug(__attribute__((unused)) const std::string& prepend) const
+{
+  double maximum {0};
+  if (dense_)
+    maximum = to_double(bins_.max());
+  else
+    sparse_.for_each([&maximum](uint32_t, const PreciseFloat& c)
+                     {
+                       maximum = std::max(maximum, to_double(c));
+                     });
+
+  std::stringstream ss;
+  ss << prepend << "Maximum=" << maximum
+     << " representation=" << this->representation()
+     << " bytes=" << memory_footprint() << "\n";
+  if (maximum)
+    ascii_grid(ss, prepend, maximum, max0_, max1_,
+               [this](uint16_t x, uint16_t y) { return at(x, y); });
+  return ss.str();
+}
+
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <core/Dataspace.h>
+#include <consumers/dataspaces/CountArray.h>
+#include <consumers/dataspaces/CountHash.h>
+#include <mutex>
+
+namespace DAQuiri
+{
+
+/// \brief 2D counts that switch between sparse and dense storage
+///
+/// Starts as a hash map of nonzero bins and moves to a dense row-major
+/// matrix once the fraction of nonzero bins within the filled extent passes
+/// promote_fraction. The dense matrix grows in powers of two; whenever it
+/// has to be reallocated and fewer than demote_fraction of the bins are
+/// nonzero, the data goes back to the hash map. Saved in the same layout
+/// as SparseMatrix2D and SparseMap2D.
+///
+/// In dense mode, zoomed-out reads come from a pyramid of coarser levels
+/// that is brought up to date on read, one dirty band of rows at a time.
+class Adaptive2D : public Dataspace
+{
+  public:
+    Adaptive2D(double promote_fraction = 0.125,
+               double demote_fraction = 0.03125);
+    Adaptive2D* clone() const override
+    { return new Adaptive2D(*this); }
+
+    bool empty() const override;
+    void clear() override;
+    void add(const Entry&) override;
+    void add_one(const Coords&) override;
+    using Dataspace::add_ones;
+    void add_ones(const size_t* begin, const size_t* end) override;
+    void add_many(const std::vector<size_t>& coords,
+                  const std::vector<PreciseFloat>& counts) override;
+    PreciseFloat get(const Coords&) const override;
+    EntryList range(std::vector<Pair> list) const override;
+    void read_range(DataBlock& block, std::vector<Pair> list) const override;
+    bool range_since(DataBlock& block, uint64_t since) const override;
+    bool tracks_changes() const override { return true; }
+    void read_level(DataBlock& block, uint16_t level,
+                    std::vector<Pair> list) const override;
+    bool has_levels() const override { return dense_; }
+    void recalc_axes() override;
+
+    /// \returns "sparse" or "dense"
+    std::string representation() const override;
+    size_t memory_footprint() const override;
+
+    inline bool dense() const { return dense_; }
+
+  protected:
+    double promote_fraction_;
+    double demote_fraction_;
+
+    bool dense_ {false};
+
+    /// sparse, keyed on (x << 16) | y, so sorted order is the same as (x, y)
+    CountHash<uint32_t> sparse_;
+    /// hash size above which the data goes dense
+    size_t promote_at_ {0};
+
+    /// dense, bin (x, y) at x * cols_ + y
+    CountArray bins_;
+    size_t rows_ {0};
+    size_t cols_ {0};
+
+    bool filled_ {false};
+    uint16_t max0_ {0};
+    uint16_t max1_ {0};
+
+    /// version of the last change, by row (x)
+    std::vector<uint64_t> changed_;
+
+    /// dense bins merged 2^level to a side, as of version
+    struct Level
+    {
+      uint64_t version {0};
+      size_t rows {0};
+      size_t cols {0};
+      std::vector<double> bins;
+    };
+
+    /// derived data, so copies start out empty
+    struct Pyramid
+    {
+      Pyramid() {}
+      Pyramid(const Pyramid&) {}
+      Pyramid& operator=(const Pyramid&) { return *this; }
+
+      std::mutex mutex;
+      std::vector<Level> levels; ///< levels[i] is level i + 1
+    };
+    mutable Pyramid pyramid_;
+
+    static inline uint32_t key(uint16_t x, uint16_t y)
+    {
+      return (uint32_t(x) << 16) | y;
+    }
+
+    inline bool within(uint16_t x, uint16_t y) const
+    {
+      return filled_ && (x <= max0_) && (y <= max1_);
+    }
+
+    inline void bin_pair(const uint16_t& x, const uint16_t& y,
+                         const PreciseFloat& count)
+    {
+      if (!within(x, y))
+        extend(x, y);
+      changed_[x] = version_;
+      if (dense_)
+        bins_.add(x * cols_ + y, count);
+      else
+      {
+        sparse_[key(x, y)] += count;
+        if (sparse_.size() > promote_at_)
+          promote();
+      }
+      total_count_ += count;
+    }
+
+    inline void bin_one(const uint16_t& x, const uint16_t& y)
+    {
+      if (!within(x, y))
+        extend(x, y);
+      changed_[x] = version_;
+      if (dense_)
+        bins_.add_one(x * cols_ + y);
+      else
+      {
+        sparse_[key(x, y)] ++;
+        if (sparse_.size() > promote_at_)
+          promote();
+      }
+      total_count_ ++;
+    }
+
+    /// \brief grows the extent to include (x, y), may reallocate or demote
+    void extend(uint16_t x, uint16_t y);
+    void promote();
+    void demote();
+    /// \brief dense storage of at least rows x cols, keeping the contents
+    void reshape(size_t rows, size_t cols);
+    size_t dense_nonzeros() const;
+    /// \brief brings level up to date, pyramid_.mutex must be held
+    const Level& update_level(uint16_t level) const;
+
+    PreciseFloat at(uint16_t x, uint16_t y) const;
+
+    void fill_list(EntryList &result,
+                   size_t min0, size_t max0,
+                   size_t min1, size_t max1) const;
+
+    void data_merge(const Dataspace& other) override;
+    void data_save(const hdf5::node::Group&) const override;
+    void data_load(const hdf5::node::Group&) override;
+
+    std::string data_debug(const std::string& prepend) const override;
+};
+
+}
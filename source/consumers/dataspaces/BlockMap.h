@@ -0,0 +1,248 @@
+#pragma once
+
+#include <core/Dataspace.h>
+#include <consumers/dataspaces/CountArray.h>
+#include <consumers/dataspaces/CountHash.h>
+#include <algorithm>
+#include <array>
+
+namespace DAQuiri
+{
+
+/// \brief counts in dense square or cubic blocks, allocated when first touched
+///
+/// A block is found through a hash of its packed block coordinates (16 bits
+/// per dimension, first dimension most significant), the bins of all blocks
+/// share one contiguous CountArray. Memory grows with the number of occupied
+/// blocks and existing blocks never move. Consecutive fills into the same
+/// block skip the lookup. Every block keeps the version of its last change,
+/// for range_since. Storage of TileMap2D (Key = uint32_t, Dims = 2) and
+/// BrickMap3D (Key = uint64_t, Dims = 3).
+template <typename Key, uint16_t Dims>
+class BlockMap
+{
+  public:
+    using Point = std::array<uint16_t, Dims>;
+
+    /// \param shift log2 of the block edge
+    explicit BlockMap(uint16_t shift)
+      : shift_(shift)
+      , mask_((1 << shift) - 1)
+      , size_(size_t(1) << (Dims * shift))
+    {}
+
+    inline uint16_t shift() const { return shift_; }
+    inline size_t edge() const { return size_t(1) << shift_; }
+    inline size_t count() const { return keys_.size(); }
+    inline bool empty() const { return keys_.empty(); }
+    inline PreciseFloat max() const { return bins_.max(); }
+
+    void clear()
+    {
+      index_.clear();
+      keys_.clear();
+      changed_.clear();
+      bins_.clear();
+      cached_key_ = std::numeric_limits<Key>::max();
+      cached_block_ = 0;
+      cached_base_ = 0;
+    }
+
+    inline void add_one(const Point& p, uint64_t version)
+    {
+      bins_.add_one(bin(p, version));
+    }
+
+    inline void add(const Point& p, const PreciseFloat& count, uint64_t version)
+    {
+      bins_.add(bin(p, version), count);
+    }
+
+    inline PreciseFloat get(const Point& p) const
+    {
+      auto number = index_.find(key(p));
+      if (!number)
+        return 0;
+      return bins_.get((*number - 1) * size_ + local(p));
+    }
+
+    /// \brief adds all bins of other, whose blocks must be of the same size
+    void add(const BlockMap& other, uint64_t version)
+    {
+      // block by block, existing blocks do not move
+      for (size_t b = 0; b < other.keys_.size(); ++b)
+      {
+        size_t mine = base(other.keys_[b], version);
+        size_t theirs = b * size_;
+        for (size_t i = 0; i < size_; ++i)
+        {
+          auto count = other.bins_.get(theirs + i);
+          if (count != 0)
+            bins_.add(mine + i, count);
+        }
+      }
+    }
+
+    /// \brief non-zero bins within [lo, hi] (inclusive), sorted
+    void fill(EntryList_t& result, const Coords& lo, const Coords& hi) const
+    {
+      for_each_in(lo, hi, [&result](const Coords& c, const PreciseFloat& count)
+            {
+              result.push_back({c, count});
+            });
+      // blocks are visited in no particular order, bins must be sorted across them
+      std::sort(result.begin(), result.end(),
+                [](const Entry& a, const Entry& b) { return a.first < b.first; });
+    }
+
+    /// \brief non-zero bins within [lo, hi] (inclusive), in no particular order
+    void read(DataBlock& block, const Coords& lo, const Coords& hi) const
+    {
+      block.reset_sparse(Dims);
+      for_each_in(lo, hi, [&block](const Coords& c, const PreciseFloat& count)
+            {
+              block.push(c, to_double(count));
+            });
+    }
+
+    /// \brief non-zero bins of all blocks changed after version since
+    void read_since(DataBlock& block, uint64_t since) const
+    {
+      block.reset_sparse(Dims);
+      Coords c(Dims);
+      for (size_t b = 0; b < keys_.size(); ++b)
+      {
+        if (changed_[b] <= since)
+          continue;
+        Coords o = origin(keys_[b]);
+        size_t first = b * size_;
+        for (size_t i = 0; i < size_; ++i)
+        {
+          auto count = bins_.get(first + i);
+          if (count == 0)
+            continue;
+          for (uint16_t d = 0; d < Dims; ++d)
+            c[d] = o[d] + ((i >> (shift_ * (Dims - 1 - d))) & mask_);
+          block.push(c, to_double(count));
+        }
+      }
+    }
+
+  private:
+    uint16_t shift_;
+    uint16_t mask_;
+    size_t size_;
+
+    /// block coordinates -> block number + 1
+    CountHash<Key, uint32_t> index_;
+    /// block coordinates, by block number
+    std::vector<Key> keys_;
+    /// version of the last change, by block number
+    std::vector<uint64_t> changed_;
+    CountArray bins_;
+
+    Key cached_key_ {std::numeric_limits<Key>::max()};
+    size_t cached_block_ {0};
+    size_t cached_base_ {0};
+
+    template <typename P>
+    inline Key key(const P& p) const
+    {
+      Key k {0};
+      for (uint16_t d = 0; d < Dims; ++d)
+        k = (k << 16) | Key(p[d] >> shift_);
+      return k;
+    }
+
+    template <typename P>
+    inline size_t local(const P& p) const
+    {
+      size_t l {0};
+      for (uint16_t d = 0; d < Dims; ++d)
+        l = (l << shift_) | (p[d] & mask_);
+      return l;
+    }
+
+    /// \returns coordinates of the first bin of a block
+    inline Coords origin(Key k) const
+    {
+      Coords o(Dims);
+      for (uint16_t d = Dims; d-- > 0;)
+      {
+        o[d] = size_t(k & 0xFFFF) << shift_;
+        k >>= 16;
+      }
+      return o;
+    }
+
+    /// \returns first bin of the block, allocated if new and marked as
+    ///          changed at version
+    inline size_t base(Key k, uint64_t version)
+    {
+      if (k != cached_key_)
+      {
+        auto& number = index_[k];
+        if (!number)
+        {
+          keys_.push_back(k);
+          changed_.push_back(0);
+          number = keys_.size();
+          bins_.resize(keys_.size() * size_);
+        }
+        cached_key_ = k;
+        cached_block_ = number - 1;
+        cached_base_ = cached_block_ * size_;
+      }
+      changed_[cached_block_] = version;
+      return cached_base_;
+    }
+
+    inline size_t bin(const Point& p, uint64_t version)
+    {
+      return base(key(p), version) + local(p);
+    }
+
+    /// \brief calls visit(coords, count) for non-zero bins within [lo, hi]
+    template <typename Visitor>
+    void for_each_in(const Coords& lo, const Coords& hi, Visitor visit) const
+    {
+      size_t last = edge() - 1;
+      Coords from(Dims), to(Dims), c(Dims);
+      index_.for_each([&](Key k, uint32_t number)
+                      {
+                        Coords o = origin(k);
+                        for (uint16_t d = 0; d < Dims; ++d)
+                        {
+                          from[d] = std::max(lo[d], o[d]);
+                          to[d] = std::min(hi[d], o[d] + last);
+                          if (from[d] > to[d])
+                            return;
+                        }
+
+                        size_t first = (number - 1) * size_;
+                        c = from;
+                        do
+                        {
+                          auto count = bins_.get(first + local(c));
+                          if (count != 0)
+                            visit(c, count);
+                        }
+                        while (next(c, from, to));
+                      });
+    }
+
+    /// \brief steps c through the box [from, to], last dimension fastest,
+    ///         false once done
+    static inline bool next(Coords& c, const Coords& from, const Coords& to)
+    {
+      for (size_t d = c.size(); d-- > 0;)
+      {
+        if (++c[d] <= to[d])
+          return true;
+        c[d] = from[d];
+      }
+      return false;
+    }
+};
+
+}
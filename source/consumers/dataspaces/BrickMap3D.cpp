@@ -0,0 +1,201 @@
+#include <consumers/dataspaces/BrickMap3D.h>
+#include <consumers/dataspaces/SparseLayout.h>
+
+namespace DAQuiri {
+
+BrickMap3D::BrickMap3D(uint16_t brick_shift)
+    : Dataspace(3)
+    , bricks_(std::max(uint16_t(1), std::min(brick_shift, uint16_t(6))))
+{}
+
+bool BrickMap3D::empty() const
+{
+  return bricks_.empty();
+}
+
+void BrickMap3D::clear()
+{
+  touch_all();
+  max0_ = 0;
+  max1_ = 0;
+  max2_ = 0;
+  total_count_ = 0;
+  bricks_.clear();
+}
+
+void BrickMap3D::add(const Entry& e)
+{
+  touch();
+  if ((e.first.size() != dimensions()) || !e.second)
+    return;
+  bin_pair(e.first[0], e.first[1], e.first[2], e.second);
+}
+
+void BrickMap3D::add_one(const Coords& coords)
+{
+  touch();
+  if (coords.size() != dimensions())
+    return;
+  bin_one(coords[0], coords[1], coords[2]);
+}
+
+void BrickMap3D::add_ones(const size_t* begin, const size_t* end)
+{
+  touch();
+  for (auto i = begin; i + 2 < end; i += 3)
+    bin_one(i[0], i[1], i[2]);
+}
+
+void BrickMap3D::recalc_axes()
+{
+  auto ax0 = axis(0);
+  ax0.expand_domain(max0_);
+  set_axis(0, ax0);
+
+  auto ax1 = axis(1);
+  ax1.expand_domain(max1_);
+  set_axis(1, ax1);
+
+  auto ax2 = axis(2);
+  ax2.expand_domain(max2_);
+  set_axis(2, ax2);
+}
+
+PreciseFloat BrickMap3D::at(uint16_t x, uint16_t y, uint16_t z) const
+{
+  return bricks_.get({x, y, z});
+}
+
+PreciseFloat BrickMap3D::get(const Coords& coords) const
+{
+  if (coords.size() != dimensions())
+    return 0;
+  return at(coords[0], coords[1], coords[2]);
+}
+
+EntryList BrickMap3D::range(std::vector<Pair> list) const
+{
+  Coords lo, hi;
+  range_bounds(list, {max0_, max1_, max2_}, lo, hi);
+  EntryList result(new EntryList_t);
+  bricks_.fill(*result, lo, hi);
+  return result;
+}
+
+bool BrickMap3D::range_since(DataBlock& block, uint64_t since) const
+{
+  if (since < cleared_version_)
+  {
+    read_range(block, {});
+    return false;
+  }
+  bricks_.read_since(block, since);
+  return true;
+}
+
+EntryList BrickMap3D::slab(uint16_t z) const
+{
+  EntryList result(new EntryList_t);
+  bricks_.fill(*result, {0, 0, z}, {max0_, max1_, z});
+  return result;
+}
+
+void BrickMap3D::data_merge(const Dataspace& other)
+{
+  auto o = dynamic_cast<const BrickMap3D*>(&other);
+  if (!o || (o->bricks_.shift() != bricks_.shift()))
+  {
+    Dataspace::data_merge(other);
+    return;
+  }
+  bricks_.add(o->bricks_, version_);
+  max0_ = std::max(max0_, o->max0_);
+  max1_ = std::max(max1_, o->max1_);
+  max2_ = std::max(max2_, o->max2_);
+  total_count_ += o->total_count_;
+}
+
+void BrickMap3D::data_save(const hdf5::node::Group& g) const
+{
+  if (bricks_.empty())
+    return;
+
+  try
+  {
+    EntryList_t entries;
+    bricks_.fill(entries, {0, 0, 0}, {max0_, max1_, max2_});
+    save_entries(g, entries, 3);
+  }
+  catch (...)
+  {
+    std::throw_with_nested(std::runtime_error("<BrickMap3D> Could not save"));
+  }
+}
+
+void BrickMap3D::data_load(const hdf5::node::Group& g)
+{
+  try
+  {
+    std::vector<std::vector<uint16_t>> indices;
+    std::vector<double> counts;
+    if (!load_entries(g, 3, indices, counts))
+      return;
+
+    clear();
+    for (size_t i = 0; i < indices[0].size(); ++i)
+      bin_pair(indices[0][i], indices[1][i], indices[2][i], counts[i]);
+  }
+  catch (...)
+  {
+    std::throw_with_nested(std::runtime_error("<BrickMap3D> Could not load"));
+  }
+}
+
+std::string BrickMap3D::data_debug(__attribute__((unused)) const std::string& prepend) const
+{
+  double maximum = to_double(bricks_.max());
+
+  std::stringstream ss;
+  ss << prepend << "Maximum=" << maximum
+     << " bricks=" << bricks_.count() << "\n";
+  if (!maximum)
+    return ss.str();
+
+  for (uint16_t i = 0; i <= max0_; i++)
+  {
+    std::stringstream ss2;
+    if (ascii_grid(ss2, prepend, maximum, max1_, max2_,
+                   [this, i](uint16_t y, uint16_t z) { return at(i, y, z); }))
+      ss << prepend << "x=" << i << "\n" << ss2.str();
+  }
+
+  return ss.str();
+}
+
+void BrickMap3D::export_csv(std::ostream& os) const
+{
+  for (uint16_t i = 0; i <= max0_; i++)
+  {
+    double total = 0;
+    std::stringstream ss2;
+    for (uint16_t j = 0; j <= max1_; j++)
+    {
+      for (uint16_t k = 0; k <= max2_; k++)
+      {
+        double v = to_double(at(i, j, k));
+        total += v;
+        ss2 << v;
+        if (k!=max2_)
+          ss2 << ", ";
+      }
+      ss2 << ";\n";
+    }
+    if (total != 0.0)
+    {
+      os << "x=" << i << "\n";
+      os << ss2.str();
+    }
+  }
+}
+
+}
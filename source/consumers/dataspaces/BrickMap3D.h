@@ -0,0 +1,77 @@
+#pragma once
+
+#include <core/Dataspace.h>
+#include <consumers/dataspaces/BlockMap.h>
+
+namespace DAQuiri
+{
+
+/// \brief 3D counts in dense cubic bricks, allocated when first touched
+///
+/// Memory grows with the number of occupied bricks and consecutive fills
+/// into the same brick skip the lookup, see BlockMap. Saved in the same
+/// layout as SparseMap3D.
+class BrickMap3D : public Dataspace
+{
+  public:
+    /// \param brick_shift log2 of the brick edge, 3 gives 8x8x8 bricks
+    explicit BrickMap3D(uint16_t brick_shift = 3);
+    BrickMap3D* clone() const override
+    { return new BrickMap3D(*this); }
+
+    bool empty() const override;
+    void clear() override;
+    void add(const Entry&) override;
+    void add_one(const Coords&) override;
+    using Dataspace::add_ones;
+    void add_ones(const size_t* begin, const size_t* end) override;
+    PreciseFloat get(const Coords&) const override;
+    EntryList range(std::vector<Pair> list) const override;
+    bool range_since(DataBlock& block, uint64_t since) const override;
+    bool tracks_changes() const override { return true; }
+    void recalc_axes() override;
+
+    void export_csv(std::ostream &) const override;
+
+    /// \brief all non-zero voxels with the given z
+    EntryList slab(uint16_t z) const;
+
+    inline size_t brick_edge() const { return bricks_.edge(); }
+    inline size_t brick_count() const { return bricks_.count(); }
+
+  protected:
+    BlockMap<uint64_t, 3> bricks_;
+
+    uint16_t max0_ {0};
+    uint16_t max1_ {0};
+    uint16_t max2_ {0};
+
+    PreciseFloat at(uint16_t x, uint16_t y, uint16_t z) const;
+
+    inline void bin_pair(const uint16_t& x, const uint16_t& y, const uint16_t& z,
+                         const PreciseFloat& count)
+    {
+      bricks_.add({x, y, z}, count, version_);
+      total_count_ += count;
+      max0_ = std::max(max0_, x);
+      max1_ = std::max(max1_, y);
+      max2_ = std::max(max2_, z);
+    }
+
+    inline void bin_one(const uint16_t& x, const uint16_t& y, const uint16_t& z)
+    {
+      bricks_.add_one({x, y, z}, version_);
+      total_count_ ++;
+      max0_ = std::max(max0_, x);
+      max1_ = std::max(max1_, y);
+      max2_ = std::max(max2_, z);
+    }
+
+    void data_merge(const Dataspace& other) override;
+    void data_save(const hdf5::node::Group&) const override;
+    void data_load(const hdf5::node::Group&) override;
+
+    std::string data_debug(const std::string& prepend) const override;
+};
+
+}
@@ -0,0 +1,177 @@
+#include <consumers/dataspaces/CountArray.h>
+#include <algorithm>
+#include <limits>
+
+namespace DAQuiri {
+
+void CountArray::resize(size_t size)
+{
+  switch (width_)
+  {
+    case Width::u32: u32_.resize(size, 0); break;
+    case Width::u64: u64_.resize(size, 0); break;
+    default: precise_.resize(size, PreciseFloat(0));
+  }
+  size_ = size;
+}
+
+void CountArray::clear()
+{
+  width_ = Width::u32;
+  size_ = 0;
+  u32_.clear();
+  u64_.clear();
+  precise_.clear();
+}
+
+void CountArray::add_one_wide(size_t bin)
+{
+  if (width_ == Width::u32)
+  {
+    // ++ in add_one wrapped around
+    u32_[bin]--;
+    widen(Width::u64);
+  }
+  if (width_ == Width::u64)
+    u64_[bin]++;
+  else
+    precise_[bin]++;
+}
+
+void CountArray::add_ones(const size_t* begin, const size_t* end)
+{
+  auto i = begin;
+  if (width_ == Width::u32)
+  {
+    uint32_t* data = u32_.data();
+    for (; i < end; ++i)
+      if (!++data[*i])
+      {
+        data[*i]--;
+        break;
+      }
+  }
+  for (; i < end; ++i)
+    add_one(*i);
+}
+
+void CountArray::add(size_t bin, PreciseFloat count)
+{
+  if (width_ != Width::precise)
+  {
+    // 2^64, exact in any PreciseFloat, the bin itself decides
+    // whether it has room for n or must widen
+    static const PreciseFloat limit =
+        PreciseFloat(4294967296.0) * PreciseFloat(4294967296.0);
+    uint64_t n = 0;
+    if ((count >= 0) && (count < limit))
+      n = static_cast<uint64_t>(count);
+    if (PreciseFloat(n) == count)
+    {
+      if (width_ == Width::u32)
+      {
+        uint64_t sum = uint64_t(u32_[bin]) + n;
+        if (sum <= std::numeric_limits<uint32_t>::max())
+        {
+          u32_[bin] = static_cast<uint32_t>(sum);
+          return;
+        }
+        widen(Width::u64);
+      }
+      if (u64_[bin] <= (std::numeric_limits<uint64_t>::max() - n))
+      {
+        u64_[bin] += n;
+        return;
+      }
+    }
+    widen(Width::precise);
+  }
+  precise_[bin] += count;
+}
+
+void CountArray::add(const CountArray& other)
+{
+  if (other.size_ > size_)
+    resize(other.size_);
+  size_t n = other.size_;
+
+  if ((width_ == Width::u32) && (other.width_ == Width::u32))
+  {
+    uint32_t* data = u32_.data();
+    const uint32_t* src = other.u32_.data();
+    bool overflow = false;
+    for (size_t i = 0; i < n; ++i)
+      overflow |= (data[i] > std::numeric_limits<uint32_t>::max() - src[i]);
+    if (!overflow)
+    {
+      for (size_t i = 0; i < n; ++i)
+        data[i] += src[i];
+      return;
+    }
+  }
+
+  if ((width_ != Width::precise) && (other.width_ != Width::precise))
+  {
+    widen(Width::u64);
+    uint64_t* data = u64_.data();
+    bool overflow = false;
+    for (size_t i = 0; i < n; ++i)
+    {
+      uint64_t v = (other.width_ == Width::u32) ? other.u32_[i] : other.u64_[i];
+      overflow |= (data[i] > std::numeric_limits<uint64_t>::max() - v);
+    }
+    if (!overflow)
+    {
+      for (size_t i = 0; i < n; ++i)
+        data[i] += (other.width_ == Width::u32) ? other.u32_[i] : other.u64_[i];
+      return;
+    }
+  }
+
+  widen(Width::precise);
+  for (size_t i = 0; i < n; ++i)
+    precise_[i] += other.get(i);
+}
+
+PreciseFloat CountArray::max() const
+{
+  if (!size_)
+    return 0;
+  switch (width_)
+  {
+    case Width::u32: return *std::max_element(u32_.begin(), u32_.end());
+    case Width::u64: return *std::max_element(u64_.begin(), u64_.end());
+    default: return *std::max_element(precise_.begin(), precise_.end());
+  }
+}
+
+size_t CountArray::bytes() const
+{
+  return u32_.capacity() * sizeof(uint32_t)
+      + u64_.capacity() * sizeof(uint64_t)
+      + precise_.capacity() * sizeof(PreciseFloat);
+}
+
+void CountArray::widen(Width width)
+{
+  if (width <= width_)
+    return;
+  if (width == Width::u64)
+  {
+    u64_.assign(u32_.begin(), u32_.end());
+    u32_ = std::vector<uint32_t>();
+  }
+  else if (width_ == Width::u32)
+  {
+    precise_.assign(u32_.begin(), u32_.end());
+    u32_ = std::vector<uint32_t>();
+  }
+  else
+  {
+    precise_.assign(u64_.begin(), u64_.end());
+    u64_ = std::vector<uint64_t>();
+  }
+  width_ = width;
+}
+
+}
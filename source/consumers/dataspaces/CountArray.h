@@ -0,0 +1,75 @@
+#pragma once
+
+#include <core/plugin/PreciseFloat.h>
+#include <vector>
+#include <cstdint>
+
+namespace DAQuiri
+{
+
+/// \brief dense array of bin counts
+///
+/// Counts are kept as uint32 and the whole array is widened to uint64 once a
+/// bin would overflow. Weights that are not non-negative integers (e.g.
+/// prebinned or loaded data), or sums beyond uint64, widen it to
+/// PreciseFloat. Conversion to PreciseFloat otherwise only happens when
+/// reading.
+class CountArray
+{
+  public:
+    enum class Width : uint8_t { u32, u64, precise };
+
+    inline size_t size() const { return size_; }
+    inline bool empty() const { return (size_ == 0); }
+    inline Width width() const { return width_; }
+
+    /// \brief new bins are zero
+    void resize(size_t size);
+    /// \brief forgets all bins and goes back to uint32 storage
+    void clear();
+
+    inline void add_one(size_t bin)
+    {
+      if ((width_ == Width::u32) && (++u32_[bin]))
+        return;
+      add_one_wide(bin);
+    }
+
+    /// \brief bins must be within size()
+    inline void add_ones(const std::vector<size_t>& bins)
+    {
+      add_ones(bins.data(), bins.data() + bins.size());
+    }
+    void add_ones(const size_t* begin, const size_t* end);
+
+    void add(size_t bin, PreciseFloat count);
+    /// \brief bin-wise sum, grows to other.size() if needed
+    void add(const CountArray& other);
+
+    inline PreciseFloat get(size_t bin) const
+    {
+      switch (width_)
+      {
+        case Width::u32: return u32_[bin];
+        case Width::u64: return u64_[bin];
+        default: return precise_[bin];
+      }
+    }
+
+    PreciseFloat max() const;
+
+    /// \brief allocated storage in bytes
+    size_t bytes() const;
+
+  private:
+    Width width_ {Width::u32};
+    size_t size_ {0};
+    std::vector<uint32_t> u32_;
+    std::vector<uint64_t> u64_;
+    std::vector<PreciseFloat> precise_;
+
+    void add_one_wide(size_t bin);
+    void widen(Width width);
+};
+
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <core/plugin/PreciseFloat.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace DAQuiri
+{
+
+/// \brief open-addressing hash map from packed coordinates to counts
+///         (or to any other small value, such as a block number)
+///
+/// Keys and values live in two contiguous arrays probed linearly, so filling
+/// allocates only when the table grows. The largest key value marks empty
+/// slots and is therefore kept in a slot of its own. Iteration order is
+/// arbitrary, use sorted() where order matters.
+template <typename Key, typename Value = PreciseFloat>
+class CountHash
+{
+  public:
+    using Item = std::pair<Key, Value>;
+
+    inline size_t size() const { return size_ + (has_last_ ? 1 : 0); }
+    inline bool empty() const { return !size(); }
+
+    /// \brief allocated storage in bytes
+    inline size_t bytes() const
+    {
+      return keys_.capacity() * sizeof(Key) + counts_.capacity() * sizeof(Value);
+    }
+
+    void clear()
+    {
+      keys_.clear();
+      counts_.clear();
+      size_ = 0;
+      mask_ = 0;
+      has_last_ = false;
+      last_ = 0;
+    }
+
+    /// \brief zero-initialized if not yet present
+    inline Value& operator[](Key key)
+    {
+      if (key == kEmpty)
+      {
+        if (!has_last_)
+        {
+          has_last_ = true;
+          last_ = 0;
+        }
+        return last_;
+      }
+
+      if ((size_ + 1) * 4 > keys_.size() * 3)
+        grow();
+
+      for (size_t i = slot(key);; i = (i + 1) & mask_)
+      {
+        if (keys_[i] == key)
+          return counts_[i];
+        if (keys_[i] == kEmpty)
+        {
+          keys_[i] = key;
+          counts_[i] = 0;
+          size_++;
+          return counts_[i];
+        }
+      }
+    }
+
+    /// \returns nullptr if not present
+    inline const Value* find(Key key) const
+    {
+      if (key == kEmpty)
+        return has_last_ ? &last_ : nullptr;
+      if (keys_.empty())
+        return nullptr;
+      for (size_t i = slot(key);; i = (i + 1) & mask_)
+      {
+        if (keys_[i] == key)
+          return &counts_[i];
+        if (keys_[i] == kEmpty)
+          return nullptr;
+      }
+    }
+
+    /// \brief visits every (key, count), in no particular order
+    template <typename Visitor>
+    void for_each(Visitor visit) const
+    {
+      for (size_t i = 0; i < keys_.size(); ++i)
+        if (keys_[i] != kEmpty)
+          visit(keys_[i], counts_[i]);
+      if (has_last_)
+        visit(kEmpty, last_);
+    }
+
+    /// \brief all items in ascending key order
+    std::vector<Item> sorted() const
+    {
+      std::vector<Item> ret;
+      ret.reserve(size());
+      for_each([&ret](Key k, const Value& c) { ret.emplace_back(k, c); });
+      sort(ret);
+      return ret;
+    }
+
+    /// \brief items whose keys pass keep(key), in ascending key order,
+    ///         only those are copied and sorted
+    template <typename Predicate>
+    std::vector<Item> sorted(Predicate keep) const
+    {
+      std::vector<Item> ret;
+      for_each([&ret, &keep](Key k, const Value& c)
+               {
+                 if (keep(k))
+                   ret.emplace_back(k, c);
+               });
+      sort(ret);
+      return ret;
+    }
+
+  private:
+    static constexpr Key kEmpty {std::numeric_limits<Key>::max()};
+
+    std::vector<Key> keys_;
+    std::vector<Value> counts_;
+    size_t size_ {0};
+    size_t mask_ {0};
+
+    bool has_last_ {false};
+    Value last_ {0};
+
+    static void sort(std::vector<Item>& items)
+    {
+      std::sort(items.begin(), items.end(),
+                [](const Item& a, const Item& b) { return a.first < b.first; });
+    }
+
+    inline size_t slot(Key key) const
+    {
+      // Fibonacci hashing, spreads neighbouring coordinates apart
+      return (static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull
+          >> 32) & mask_;
+    }
+
+    void grow()
+    {
+      std::vector<Key> keys(std::max(size_t(64), keys_.size() * 2), kEmpty);
+      std::vector<Value> counts(keys.size());
+      keys_.swap(keys);
+      counts_.swap(counts);
+      mask_ = keys_.size() - 1;
+      for (size_t j = 0; j < keys.size(); ++j)
+      {
+        if (keys[j] == kEmpty)
+          continue;
+        size_t i = slot(keys[j]);
+        while (keys_[i] != kEmpty)
+          i = (i + 1) & mask_;
+        keys_[i] = keys[j];
+        counts_[i] = counts[j];
+      }
+    }
+};
+
+}
@@ -1,5 +1,6 @@
 #include <consumers/dataspaces/Dense1D.h>
 #include <core/util/h5json.h>
+#include <algorithm>
 
 namespace DAQuiri {
 
@@ -15,40 +16,86 @@ void Dense1D::reserve(const Coords& limits)
 {
   if (limits.size() != dimensions())
     return;
-  spectrum_.resize(limits[0], PreciseFloat(0));
+  spectrum_.resize(limits[0]);
 }
 
 void Dense1D::clear()
 {
+  touch_all();
   total_count_ = 0;
   maxchan_ = 0;
   spectrum_.clear();
+  changed_.clear();
 }
 
 void Dense1D::add(const Entry& e)
 {
+  touch();
   if ((e.first.size() != dimensions()) || !e.second)
     return;
   const auto& bin = e.first[0];
   if (bin >= spectrum_.size())
-    spectrum_.resize(bin + 1, PreciseFloat(0));
+    spectrum_.resize(bin + 1);
 
-  spectrum_[bin] += e.second;
+  spectrum_.add(bin, e.second);
   total_count_ += e.second;
   maxchan_ = std::max(maxchan_, bin);
+  mark(bin);
 }
 
 void Dense1D::add_one(const Coords& coords)
 {
+  touch();
   if (coords.size() != dimensions())
     return;
   const auto& bin = coords[0];
   if (bin >= spectrum_.size())
-    spectrum_.resize(bin + 1, PreciseFloat(0));
+    spectrum_.resize(bin + 1);
 
-  spectrum_[bin]++;
+  spectrum_.add_one(bin);
   total_count_++;
   maxchan_ = std::max(maxchan_, bin);
+  mark(bin);
+}
+
+void Dense1D::add_ones(const size_t* begin, const size_t* end)
+{
+  touch();
+  if (begin == end)
+    return;
+  size_t top = *std::max_element(begin, end);
+  if (top >= spectrum_.size())
+    spectrum_.resize(top + 1);
+
+  spectrum_.add_ones(begin, end);
+  total_count_ += (end - begin);
+  maxchan_ = std::max(maxchan_, top);
+  for (auto i = begin; i < end; ++i)
+    mark(*i);
+}
+
+bool Dense1D::range_since(DataBlock& block, uint64_t since) const
+{
+  if (since < cleared_version_)
+  {
+    read_range(block, {});
+    return false;
+  }
+
+  block.reset_sparse(1);
+  for (size_t b = 0; b < changed_.size(); ++b)
+  {
+    if (changed_[b] <= since)
+      continue;
+    size_t end = std::min(spectrum_.size(), (b + 1) << 6);
+    for (size_t i = b << 6; i < end; ++i)
+    {
+      auto count = spectrum_.get(i);
+      if (count != 0)
+        block.push(i, to_double(count));
+    }
+  }
+  return true;
 }
 
 void Dense1D::recalc_axes()
@@ -64,7 +111,7 @@ PreciseFloat Dense1D::get(const Coords& coords) const
     return 0;
   const auto& bin = *coords.begin();
   if (bin < spectrum_.size())
-    return spectrum_.at(bin);
+    return spectrum_.get(bin);
   return 0;
 }
 
@@ -84,11 +131,53 @@ EntryList Dense1D::range(std::vector<Pair> list) const
 
   //TODO: only non-0s?
   for (size_t i = min; i <= max; ++i)
-    result->push_back({{i}, spectrum_[i]});
+    result->push_back({{i}, spectrum_.get(i)});
 
   return result;
 }
 
+void Dense1D::read_range(DataBlock& block, std::vector<Pair> list) const
+{
+  if (spectrum_.empty())
+  {
+    block.reset_dense({0}, {0});
+    return;
+  }
+
+  size_t min {0};
+  size_t max {spectrum_.size() - 1};
+  if (list.size() == dimensions())
+  {
+    min = list.begin()->first;
+    max = std::min(list.begin()->second, spectrum_.size() - 1);
+  }
+  if (min > max)
+  {
+    block.reset_dense({min}, {0});
+    return;
+  }
+
+  block.reset_dense({min}, {max - min + 1});
+  for (size_t i = min; i <= max; ++i)
+    block.counts[i - min] = to_double(spectrum_.get(i));
+}
+
+void Dense1D::data_merge(const Dataspace& other)
+{
+  auto o = dynamic_cast<const Dense1D*>(&other);
+  if (!o)
+  {
+    Dataspace::data_merge(other);
+    return;
+  }
+  spectrum_.add(o->spectrum_);
+  maxchan_ = std::max(maxchan_, o->maxchan_);
+  total_count_ += o->total_count_;
+  for (size_t i = 0; i < o->spectrum_.size(); ++i)
+    if (o->spectrum_.get(i) != 0)
+      mark(i);
+}
+
 void Dense1D::data_save(const hdf5::node::Group& g) const
 {
   if (!spectrum_.size())
@@ -98,7 +187,7 @@ void Dense1D::data_save(const hdf5::node::Group& g) const
   {
     std::vector<double> d(maxchan_ + 1);
     for (uint32_t i = 0; i <= maxchan_; i++)
-      d[i] = static_cast<double>(spectrum_[i]);
+      d[i] = static_cast<double>(spectrum_.get(i));
 
     auto dtype = hdf5::datatype::create<double>();
     auto dspace = hdf5::dataspace::Simple({d.size()});
@@ -124,18 +213,15 @@ void Dense1D::data_load(const hdf5::node::Group& g)
       dset.read(rdata);
     }
 
-    if (spectrum_.size() != rdata.size())
-    {
-      spectrum_.clear();
-      spectrum_.resize(rdata.size(), PreciseFloat(0));
-    }
+    spectrum_.clear();
+    spectrum_.resize(rdata.size());
 
     maxchan_ = 0;
     total_count_ = 0;
     for (size_t i = 0; i < rdata.size(); i++)
     {
       total_count_ += rdata[i];
-      spectrum_[i] = PreciseFloat(rdata[i]);
+      spectrum_.add(i, PreciseFloat(rdata[i]));
       if (rdata[i])
         maxchan_ = i;
     }
@@ -152,16 +238,14 @@ std::string Dense1D::data_debug(const std::string& prepend) const
   if (!spectrum_.size())
     return ss.str();
 
-  PreciseFloat max = spectrum_[0];
-  for (const auto& s : spectrum_)
-    max = std::max(max, s);
+  PreciseFloat max = spectrum_.max();
 
   uint64_t nstars = 60;
 
   bool print {false};
   for (uint32_t i = 0; i <= maxchan_; i++)
   {
-    double val = static_cast<double>(spectrum_[i]);
+    double val = static_cast<double>(spectrum_.get(i));
     if (val)
       print = true;
     if (print)
@@ -177,12 +261,9 @@ void Dense1D::export_csv(std::ostream& os) const
   if (!spectrum_.size())
     return;
 
-  for (uint32_t i = 0; i <= maxchan_; i++)
-  {
-    os << static_cast<double>(spectrum_[i]);
-    if (i != maxchan_)
-      os << ", ";
-  }
+  DataBlock block;
+  read_range(block, {{0, maxchan_}});
+  block.write_csv(os);
 }
 
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <core/Dataspace.h>
+#include <consumers/dataspaces/CountArray.h>
 
 namespace DAQuiri
 {
@@ -17,18 +18,34 @@ class Dense1D : public Dataspace
     void clear() override;
     void add(const Entry&) override;
     void add_one(const Coords&) override;
+    using Dataspace::add_ones;
+    void add_ones(const size_t* begin, const size_t* end) override;
     PreciseFloat get(const Coords&) const override;
     EntryList range(std::vector<Pair> list) const override;
+    void read_range(DataBlock& block, std::vector<Pair> list) const override;
+    bool range_since(DataBlock& block, uint64_t since) const override;
+    bool tracks_changes() const override { return true; }
     void recalc_axes() override;
 
     void export_csv(std::ostream& os) const override;
 
   protected:
     // data
-    std::vector<PreciseFloat> spectrum_;
+    CountArray spectrum_;
     size_t maxchan_ {0};
 
+    /// version of the last change to each block of 64 bins
+    std::vector<uint64_t> changed_;
+
+    inline void mark(size_t bin)
+    {
+      if ((bin >> 6) >= changed_.size())
+        changed_.resize((bin >> 6) + 1, 0);
+      changed_[bin >> 6] = version_;
+    }
+
     std::string data_debug(const std::string& prepend) const override;
+    void data_merge(const Dataspace& other) override;
     void data_save(const hdf5::node::Group&) const override;
     void data_load(const hdf5::node::Group&) override;
 };
@@ -24,12 +24,15 @@ void DenseMatrix2D::reserve(const Coords& limits)
 
 void DenseMatrix2D::clear()
 {
+  touch_all();
   total_count_ = 0;
   spectrum_.setZero();
+  changed_.clear();
 }
 
 void DenseMatrix2D::add(const Entry& e)
 {
+  touch();
   if ((e.first.size() != dimensions()) || !e.second)
     return;
   bin_pair(e.first[0], e.first[1], e.second);
@@ -37,11 +40,19 @@ void DenseMatrix2D::add(const Entry& e)
 
 void DenseMatrix2D::add_one(const Coords& coords)
 {
+  touch();
   if (coords.size() != dimensions())
     return;
   bin_one(coords[0], coords[1]);
 }
 
+void DenseMatrix2D::add_ones(const size_t* begin, const size_t* end)
+{
+  touch();
+  for (auto i = begin; i + 1 < end; i += 2)
+    bin_one(i[0], i[1]);
+}
+
 void DenseMatrix2D::recalc_axes()
 {
   auto ax0 = axis(0);
@@ -56,7 +67,10 @@ void DenseMatrix2D::recalc_axes()
 PreciseFloat DenseMatrix2D::get(const Coords&  coords) const
 {
   if (coords.size() != dimensions())
-    return 0;  
+    return 0;
+  if ((coords[0] >= static_cast<size_t>(spectrum_.rows())) ||
+      (coords[1] >= static_cast<size_t>(spectrum_.cols())))
+    return 0;
   return spectrum_.coeff(coords[0], coords[1]);
 }
 
@@ -87,6 +101,65 @@ EntryList DenseMatrix2D::range(std::vector<Pair> list) const
   return result;
 }
 
+void DenseMatrix2D::read_range(DataBlock& block, std::vector<Pair> list) const
+{
+  size_t min0, min1, max0, max1;
+  if (list.size() != dimensions())
+  {
+    min0 = min1 = 0;
+    max0 = limits_[0];
+    max1 = limits_[1];
+  }
+  else
+  {
+    const auto& range0 = *list.begin();
+    const auto& range1 = *(list.begin() + 1);
+    min0 = std::min(range0.first, range0.second);
+    max0 = std::max(range0.first, range0.second);
+    min1 = std::min(range1.first, range1.second);
+    max1 = std::max(range1.first, range1.second);
+  }
+
+  max0 = std::min(max0, static_cast<size_t>(spectrum_.rows()) - 1);
+  max1 = std::min(max1, static_cast<size_t>(spectrum_.cols()) - 1);
+  if ((min0 > max0) || (min1 > max1))
+  {
+    block.reset_dense({min0, min1}, {0, 0});
+    return;
+  }
+
+  block.reset_dense({min0, min1}, {max0 - min0 + 1, max1 - min1 + 1});
+  size_t i = 0;
+  for (size_t k = min0; k <= max0; ++k)
+    for (size_t l = min1; l <= max1; ++l)
+      block.counts[i++] = spectrum_.coeff(k, l);
+}
+
+bool DenseMatrix2D::range_since(DataBlock& block, uint64_t since) const
+{
+  if (since < cleared_version_)
+  {
+    read_range(block, {});
+    return false;
+  }
+
+  block.reset_sparse(2);
+  size_t rows = std::min(changed_.size(), static_cast<size_t>(spectrum_.rows()));
+  size_t cols = std::min(limits_[1] + 1, static_cast<size_t>(spectrum_.cols()));
+  for (size_t x = 0; x < rows; ++x)
+  {
+    if (changed_[x] <= since)
+      continue;
+    for (size_t y = 0; y < cols; ++y)
+    {
+      auto count = spectrum_.coeff(x, y);
+      if (count)
+        block.push(x, y, count);
+    }
+  }
+  return true;
+}
+
 void DenseMatrix2D::fill_list(EntryList& result,
                          size_t min0, size_t max0,
                          size_t min1, size_t max1) const
@@ -102,6 +175,26 @@ void DenseMatrix2D::fill_list(EntryList& result,
   }
 }
 
+void DenseMatrix2D::data_merge(const Dataspace& other)
+{
+  auto o = dynamic_cast<const DenseMatrix2D*>(&other);
+  if (!o)
+  {
+    Dataspace::data_merge(other);
+    return;
+  }
+  auto rows = std::max(spectrum_.rows(), o->spectrum_.rows());
+  auto cols = std::max(spectrum_.cols(), o->spectrum_.cols());
+  if ((rows != spectrum_.rows()) || (cols != spectrum_.cols()))
+    spectrum_.conservativeResizeLike(data_type_t::Zero(rows, cols));
+  spectrum_.block(0, 0, o->spectrum_.rows(), o->spectrum_.cols()) += o->spectrum_;
+  // whole matrices are summed, any bin may have changed
+  touch_all();
+  limits_[0] = std::max(limits_[0], o->limits_[0]);
+  limits_[1] = std::max(limits_[1], o->limits_[1]);
+  total_count_ += o->total_count_;
+}
+
 void DenseMatrix2D::data_save(const hdf5::node::Group& g) const
 {
   std::vector<uint16_t> dx(spectrum_.size());
@@ -18,12 +18,15 @@ class DenseMatrix2D : public Dataspace
     void clear() override;
     void add(const Entry&) override;
     void add_one(const Coords&) override;
+    using Dataspace::add_ones;
+    void add_ones(const size_t* begin, const size_t* end) override;
     PreciseFloat get(const Coords&) const override;
     EntryList range(std::vector<Pair> list) const override;
+    void read_range(DataBlock& block, std::vector<Pair> list) const override;
+    bool range_since(DataBlock& block, uint64_t since) const override;
+    bool tracks_changes() const override { return true; }
     void recalc_axes() override;
 
-    void export_csv(std::ostream &) const override {} //TODO: implement
-
   protected:
     typedef Eigen::Matrix<uint64_t, Eigen::Dynamic, Eigen::Dynamic> data_type_t;
 
@@ -31,6 +34,8 @@ class DenseMatrix2D : public Dataspace
     data_type_t spectrum_;
 
     Coords limits_ {0,0};
+    /// version of the last change, by row
+    std::vector<uint64_t> changed_;
 
     inline void adjust_maxima(const uint16_t& x, const uint16_t& y)
     {
@@ -43,10 +48,18 @@ class DenseMatrix2D : public Dataspace
         this->reserve(limits_);
     }
 
+    inline void mark(uint16_t x)
+    {
+      if (changed_.size() <= x)
+        changed_.resize(size_t(x) + 1, 0);
+      changed_[x] = version_;
+    }
+
     inline void bin_pair(const uint16_t& x, const uint16_t& y,
                          const PreciseFloat& count)
     {
       adjust_maxima(x,y);
+      mark(x);
       spectrum_.coeffRef(x, y) += count;
       total_count_ += count;
     }
@@ -54,6 +67,7 @@ class DenseMatrix2D : public Dataspace
     inline void bin_one(const uint16_t& x, const uint16_t& y)
     {
       adjust_maxima(x,y);
+      mark(x);
       spectrum_(x, y) += 1;
       total_count_ ++;
     }
@@ -65,6 +79,7 @@ class DenseMatrix2D : public Dataspace
                    size_t min1, size_t max1) const;
 
 
+    void data_merge(const Dataspace& other) override;
     void data_save(const hdf5::node::Group&) const override;
     void data_load(const hdf5::node::Group&) override;
     std::string data_debug(const std::string& prepend) const override;
@@ -17,6 +17,7 @@ void Scalar::reserve(const Coords&)
 
 void Scalar::clear()
 {
+  touch_all();
   total_count_ = 0;
   has_data_ = false;
   data_ = 0.0;
@@ -26,6 +27,7 @@ void Scalar::clear()
 
 void Scalar::add(const Entry& e)
 {
+  touch();
   if ((e.first.size() != dimensions()))
     return;
 
@@ -43,6 +45,7 @@ void Scalar::add(const Entry& e)
 
 void Scalar::add_one(const Coords& coords)
 {
+  touch();
   if (coords.size() != dimensions())
     return;
 
@@ -84,6 +87,55 @@ EntryList Scalar::range(std::vector<Pair>) const
   return result;
 }
 
+bool Scalar::range_since(DataBlock& block, uint64_t since) const
+{
+  block.reset_sparse(0);
+  if (has_data_ && (since < version_))
+    block.push(Coords(), to_double(data_));
+  return (since >= cleared_version_);
+}
+
+void Scalar::update_from(const Dataspace& source, const DataBlock& changes)
+{
+  auto o = dynamic_cast<const Scalar*>(&source);
+  if (!o)
+  {
+    Dataspace::update_from(source, changes);
+    return;
+  }
+  // the latest sample replaces rather than adds up, and there is
+  // hardly more to copy than the change itself
+  *this = *o;
+}
+
+void Scalar::data_merge(const Dataspace& other)
+{
+  auto o = dynamic_cast<const Scalar*>(&other);
+  if (!o)
+  {
+    Dataspace::data_merge(other);
+    return;
+  }
+  if (!o->has_data_)
+    return;
+  // a scalar holds the latest sample rather than a sum, so adding values
+  // would be meaningless; other is taken as the later run, as Spectrum
+  // does with times, and its last sample becomes current
+  data_ = o->data_;
+  if (has_data_)
+  {
+    max_val_ = std::max(max_val_, o->max_val_);
+    min_val_ = std::min(min_val_, o->min_val_);
+  }
+  else
+  {
+    max_val_ = o->max_val_;
+    min_val_ = o->min_val_;
+  }
+  total_count_ += o->total_count_;
+  has_data_ = true;
+}
+
 void Scalar::data_save(const hdf5::node::Group& g) const
 {
   if (!has_data_)
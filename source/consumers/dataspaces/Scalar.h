@@ -18,6 +18,9 @@ class Scalar : public Dataspace
     void add_one(const Coords&) override;
     PreciseFloat get(const Coords&) const override;
     EntryList range(std::vector<Pair> list) const override;
+    bool range_since(DataBlock& block, uint64_t since) const override;
+    bool tracks_changes() const override { return true; }
+    void update_from(const Dataspace& source, const DataBlock& changes) override;
     void recalc_axes() override;
 
     void export_csv(std::ostream &) const override;
@@ -31,6 +34,7 @@ class Scalar : public Dataspace
     PreciseFloat min_val_ {0};
 
     std::string data_debug(const std::string& prepend) const override;
+    void data_merge(const Dataspace& other) override;
     void data_save(const hdf5::node::Group&) const override;
     void data_load(const hdf5::node::Group&) override;
 };
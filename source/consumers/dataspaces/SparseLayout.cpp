@@ -0,0 +1,89 @@
+#include <consumers/dataspaces/SparseLayout.h>
+
+namespace DAQuiri {
+
+void range_bounds(const std::vector<Pair>& ranges, const Coords& maxima,
+                  Coords& lo, Coords& hi)
+{
+  lo.assign(maxima.size(), 0);
+  hi = maxima;
+  if (ranges.size() != maxima.size())
+    return;
+  for (size_t d = 0; d < ranges.size(); ++d)
+  {
+    lo[d] = std::min(ranges[d].first, ranges[d].second);
+    hi[d] = std::max(ranges[d].first, ranges[d].second);
+  }
+}
+
+void save_entries(const hdf5::node::Group& g, const EntryList_t& entries,
+                  uint16_t dimensions)
+{
+  if (entries.empty())
+    return;
+
+  std::vector<double> dc(entries.size());
+  for (size_t i = 0; i < entries.size(); ++i)
+    dc[i] = static_cast<double>(entries[i].second);
+
+  using namespace hdf5;
+
+  property::DatasetCreationList dcpl;
+  dcpl.layout(property::DatasetLayout::CHUNKED);
+
+  size_t chunksize = dc.size();
+  if (chunksize > 128)
+    chunksize = 128;
+
+  dataspace::Simple i_space({dc.size(), dimensions});
+  dcpl.chunk({chunksize, dimensions});
+  auto didx = g.create_dataset("indices", datatype::create<uint16_t>(), i_space, dcpl);
+
+  dataspace::Simple c_space({dc.size()});
+  dcpl.chunk({chunksize});
+  auto dcts = g.create_dataset("counts", datatype::create<double>(), c_space, dcpl);
+
+  dataspace::Hyperslab slab({0, 0}, {dc.size(), 1});
+  std::vector<uint16_t> di(entries.size());
+  for (uint16_t d = 0; d < dimensions; ++d)
+  {
+    for (size_t i = 0; i < entries.size(); ++i)
+      di[i] = entries[i].first[d];
+    slab.offset({0, d});
+    didx.write(di, slab);
+  }
+
+  dcts.write(dc);
+}
+
+bool load_entries(const hdf5::node::Group& g, uint16_t dimensions,
+                  std::vector<std::vector<uint16_t>>& indices,
+                  std::vector<double>& counts)
+{
+  using namespace hdf5;
+
+  if (!g.has_dataset("indices") ||
+      !g.has_dataset("counts"))
+    return false;
+
+  auto didx = hdf5::node::Group(g).get_dataset("indices");
+  auto dcts = hdf5::node::Group(g).get_dataset("counts");
+
+  auto didx_ds = dataspace::Simple(didx.dataspace()).current_dimensions();
+  auto dcts_ds = dataspace::Simple(dcts.dataspace()).current_dimensions();
+
+  dataspace::Hyperslab slab({0, 0}, {static_cast<size_t>(didx_ds[0]), 1});
+
+  indices.assign(dimensions, std::vector<uint16_t>(didx_ds[0], 0));
+  for (uint16_t d = 0; d < dimensions; ++d)
+  {
+    slab.offset({0, d});
+    didx.read(indices[d], slab);
+  }
+
+  counts.assign(dcts_ds[0], 0.0);
+  dcts.read(counts);
+  return true;
+}
+
+}
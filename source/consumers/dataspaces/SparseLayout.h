@@ -0,0 +1,51 @@
+#pragma once
+
+#include <core/Dataspace.h>
+#include <core/util/ascii_tree.h>
+#include <ostream>
+
+namespace DAQuiri
+{
+
+/// Helpers shared by the sparse and block dataspaces, which are all saved as
+/// "indices" (N x dimensions, uint16) and "counts" (N, double)
+
+/// \brief inclusive bounds of the requested ranges, [0, maxima] if there is
+///         not one range per dimension
+void range_bounds(const std::vector<Pair>& ranges, const Coords& maxima,
+                  Coords& lo, Coords& hi);
+
+/// \brief writes entries in the shared sparse layout, nothing if empty
+void save_entries(const hdf5::node::Group& g, const EntryList_t& entries,
+                  uint16_t dimensions);
+
+/// \brief reads the shared sparse layout, indices[d] holding coordinate d
+/// \returns false if the group holds no such data
+bool load_entries(const hdf5::node::Group& g, uint16_t dimensions,
+                  std::vector<std::vector<uint16_t>>& indices,
+                  std::vector<double>& counts);
+
+/// \brief one row of gray levels per x in [0, max0], one character per y
+///         in [0, max1], at(x, y) giving the count
+/// \returns sum of printed levels, 0 if the grid is blank
+template <typename At>
+double ascii_grid(std::ostream& os, const std::string& prepend,
+                  double maximum, uint16_t max0, uint16_t max1, At at)
+{
+  std::string representation(ASCII_grayscale94);
+  double total = 0;
+  for (uint16_t i = 0; i <= max0; i++)
+  {
+    os << prepend << "|";
+    for (uint16_t j = 0; j <= max1; j++)
+    {
+      uint16_t v = to_double(at(i, j)) / maximum * 93;
+      total += v;
+      os << representation[v];
+    }
+    os << "\n";
+  }
+  return total;
+}
+
+}
@@ -16,14 +16,17 @@ bool SparseMap2D::empty() const
 
 void SparseMap2D::clear()
 {
+  touch_all();
   total_count_ = 0;
   spectrum_.clear();
+  changed_.clear();
   max0_ = 0;
   max1_ = 0;
 }
 
 void SparseMap2D::add(const Entry& e)
 {
+  touch();
   if ((e.first.size() != dimensions()) || !e.second)
     return;
   bin_pair(e.first[0], e.first[1], e.second);
@@ -31,11 +34,19 @@ void SparseMap2D::add(const Entry& e)
 
 void SparseMap2D::add_one(const Coords& coords)
 {
+  touch();
   if (coords.size() != dimensions())
     return;
   bin_one(coords[0], coords[1]);
 }
 
+void SparseMap2D::add_ones(const size_t* begin, const size_t* end)
+{
+  touch();
+  for (auto i = begin; i + 1 < end; i += 2)
+    bin_one(i[0], i[1]);
+}
+
 void SparseMap2D::recalc_axes()
 {
   auto ax0 = axis(0);
@@ -47,16 +58,17 @@ void SparseMap2D::recalc_axes()
   set_axis(1, ax1);
 }
 
+PreciseFloat SparseMap2D::at(uint16_t x, uint16_t y) const
+{
+  auto count = spectrum_.find(key(x, y));
+  return count ? *count : PreciseFloat(0);
+}
+
 PreciseFloat SparseMap2D::get(const Coords& coords) const
 {
   if (coords.size() != dimensions())
     return 0;
-
-  std::pair<uint16_t,uint16_t> point(coords[0], coords[1]);
-
-  if (spectrum_.count(point))
-    return spectrum_.at(point);
-  return 0;
+  return at(coords[0], coords[1]);
 }
 
 EntryList SparseMap2D::range(std::vector<Pair> list) const
@@ -86,19 +98,89 @@ EntryList SparseMap2D::range(std::vector<Pair> list) const
   return result;
 }
 
+void SparseMap2D::read_range(DataBlock& block, std::vector<Pair> list) const
+{
+  size_t min0, min1, max0, max1;
+  if (list.size() != dimensions())
+  {
+    min0 = min1 = 0;
+    max0 = max0_;
+    max1 = max1_;
+  }
+  else
+  {
+    const auto& range0 = *list.begin();
+    const auto& range1 = *(list.begin() + 1);
+    min0 = std::min(range0.first, range0.second);
+    max0 = std::max(range0.first, range0.second);
+    min1 = std::min(range1.first, range1.second);
+    max1 = std::max(range1.first, range1.second);
+  }
+
+  block.reset_sparse(2);
+  spectrum_.for_each([&](uint32_t k, const PreciseFloat& c)
+                     {
+                       size_t co0 = k >> 16;
+                       size_t co1 = k & 0xFFFF;
+                       if ((min0 > co0) || (co0 > max0) ||
+                           (min1 > co1) || (co1 > max1))
+                         return;
+                       block.push(co0, co1, to_double(c));
+                     });
+}
+
+bool SparseMap2D::range_since(DataBlock& block, uint64_t since) const
+{
+  if (since < cleared_version_)
+  {
+    read_range(block, {});
+    return false;
+  }
+
+  // a pass over the table, but nothing is copied except changed rows
+  block.reset_sparse(2);
+  if (since >= version_)
+    return true;
+  spectrum_.for_each([&](uint32_t k, const PreciseFloat& c)
+                     {
+                       size_t co0 = k >> 16;
+                       if (changed_[co0] > since)
+                         block.push(co0, k & 0xFFFF, to_double(c));
+                     });
+  return true;
+}
+
 void SparseMap2D::fill_list(EntryList& result,
                           size_t min0, size_t max0,
                           size_t min1, size_t max1) const
 {
-  for (const auto& it : spectrum_)
+  auto inside = [=](uint32_t k)
   {
-    const auto& co0 = it.first.first;
-    const auto& co1 = it.first.second;
-    if ((min0 > co0) || (co0 > max0) ||
-        (min1 > co1) || (co1 > max1))
-      continue;
-    result->push_back({{co0, co1}, it.second});
+    size_t co0 = k >> 16;
+    size_t co1 = k & 0xFFFF;
+    return (min0 <= co0) && (co0 <= max0) && (min1 <= co1) && (co1 <= max1);
+  };
+  for (const auto& it : spectrum_.sorted(inside))
+    result->push_back({{size_t(it.first >> 16), size_t(it.first & 0xFFFF)},
+                       it.second});
+}
+
+void SparseMap2D::data_merge(const Dataspace& other)
+{
+  auto o = dynamic_cast<const SparseMap2D*>(&other);
+  if (!o)
+  {
+    Dataspace::data_merge(other);
+    return;
   }
+  o->spectrum_.for_each([this](uint32_t k, const PreciseFloat& c)
+                        {
+                          spectrum_[k] += c;
+                          mark(k >> 16);
+                        });
+  max0_ = std::max(max0_, o->max0_);
+  max1_ = std::max(max1_, o->max1_);
+  total_count_ += o->total_count_;
 }
 
 void SparseMap2D::data_save(const hdf5::node::Group& g) const
@@ -112,11 +194,11 @@ void SparseMap2D::data_save(const hdf5::node::Group& g) const
     std::vector<uint16_t> dy(spectrum_.size());
     std::vector<double> dc(spectrum_.size());
     size_t i = 0;
-    for (auto it = spectrum_.begin(); it != spectrum_.end(); ++it)
+    for (const auto& it : spectrum_.sorted())
     {
-      dx[i] = it->first.first;
-      dy[i] = it->first.second;
-      dc[i] = static_cast<long double>(it->second);
+      dx[i] = it.first >> 16;
+      dy[i] = it.first & 0xFFFF;
+      dc[i] = static_cast<double>(it.second);
       i++;
     }
 
@@ -195,8 +277,10 @@ void SparseMap2D::data_load(const hdf5::node::Group& g)
 std::string SparseMap2D::data_debug(__attribute__((unused)) const std::string &prepend) const
 {
   double maximum {0};
-  for (auto &b : spectrum_)
-    maximum = std::max(maximum, to_double(b.second));
+  spectrum_.for_each([&maximum](uint32_t, const PreciseFloat& c)
+                     {
+                       maximum = std::max(maximum, to_double(c));
+                     });
 
   std::string representation(ASCII_grayscale94);
   std::stringstream ss;
@@ -210,9 +294,7 @@ std::string SparseMap2D::data_debug(__attribute__((unused)) const std::string &p
     ss << prepend << "|";
     for (uint16_t j = 0; j <= max1_; j++)
     {
-      uint16_t v = 0;
-      if (spectrum_.count(std::pair<uint16_t, uint16_t>(i,j)))
-        v = spectrum_.at(std::pair<uint16_t, uint16_t>(i,j));
+      uint16_t v = static_cast<uint16_t>(at(i, j));
       ss << representation[v / maximum * 93];
     }
     ss << "\n";
@@ -221,35 +303,15 @@ std::string SparseMap2D::data_debug(__attribute__((unused)) const std::string &p
   return ss.str();
 }
 
-void SparseMap2D::export_csv(std::ostream& os) const
-{
-  for (uint16_t i = 0; i <= max0_; i++)
-  {
-    for (uint16_t j = 0; j <= max1_; j++)
-    {
-      double v = 0;
-      if (spectrum_.count(std::pair<uint16_t, uint16_t>(i, j)))
-        v = spectrum_.at(std::pair<uint16_t, uint16_t>(i, j));
-      os << v;
-      if (j != max1_)
-        os << ", ";
-    }
-    os << ";\n";
-  }
-}
-
 bool SparseMap2D::is_symmetric()
 {
   bool symmetric = true;
-  for (auto &q : spectrum_)
-  {
-    std::pair<uint16_t,uint16_t> point(q.first.second, q.first.first);
-    if ((!spectrum_.count(point)) || (spectrum_.at(point) != q.second))
-    {
-      symmetric = false;
-      break;
-    }
-  }
+  spectrum_.for_each([this, &symmetric](uint32_t k, const PreciseFloat& c)
+                     {
+                       auto mirror = spectrum_.find(key(k & 0xFFFF, k >> 16));
+                       if (!mirror || (*mirror != c))
+                         symmetric = false;
+                     });
   return symmetric;
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <core/Dataspace.h>
+#include <consumers/dataspaces/CountHash.h>
 
 namespace DAQuiri
 {
@@ -16,24 +17,45 @@ class SparseMap2D : public Dataspace
     void clear() override;
     void add(const Entry&) override;
     void add_one(const Coords&) override;
+    using Dataspace::add_ones;
+    void add_ones(const size_t* begin, const size_t* end) override;
     PreciseFloat get(const Coords&) const override;
     EntryList range(std::vector<Pair> list) const override;
+    void read_range(DataBlock& block, std::vector<Pair> list) const override;
+    bool range_since(DataBlock& block, uint64_t since) const override;
+    bool tracks_changes() const override { return true; }
     void recalc_axes() override;
 
-    void export_csv(std::ostream &) const override;
-
   protected:
-    typedef std::map<std::pair<uint16_t,uint16_t>, PreciseFloat> SpectrumMap2D;
+    /// keyed on (x << 16) | y, so sorted order is the same as (x, y)
+    typedef CountHash<uint32_t> SpectrumMap2D;
 
     //the data itself
     SpectrumMap2D spectrum_;
+    /// version of the last change, by x
+    std::vector<uint64_t> changed_;
     uint16_t max0_ {0};
     uint16_t max1_ {0};
 
+    static inline uint32_t key(uint16_t x, uint16_t y)
+    {
+      return (uint32_t(x) << 16) | y;
+    }
+
+    PreciseFloat at(uint16_t x, uint16_t y) const;
+
+    inline void mark(uint16_t x)
+    {
+      if (changed_.size() <= x)
+        changed_.resize(size_t(x) + 1, 0);
+      changed_[x] = version_;
+    }
+
     inline void bin_pair(const uint16_t& x, const uint16_t& y,
                          const PreciseFloat& count)
     {
-      spectrum_[std::pair<uint16_t, uint16_t>(x,y)] += count;
+      spectrum_[key(x, y)] += count;
+      mark(x);
       total_count_ += count;
       max0_ = std::max(max0_, x);
       max1_ = std::max(max1_, y);
@@ -41,7 +63,8 @@ class SparseMap2D : public Dataspace
 
     inline void bin_one(const uint16_t& x, const uint16_t& y)
     {
-      spectrum_[std::pair<uint16_t, uint16_t>(x,y)] ++;
+      spectrum_[key(x, y)] ++;
+      mark(x);
       total_count_ ++;
       max0_ = std::max(max0_, x);
       max1_ = std::max(max1_, y);
@@ -53,6 +76,7 @@ class SparseMap2D : public Dataspace
                    size_t min0, size_t max0,
                    size_t min1, size_t max1) const;
 
+    void data_merge(const Dataspace& other) override;
     void data_save(const hdf5::node::Group&) const override;
     void data_load(const hdf5::node::Group&) override;
     std::string data_debug(const std::string& prepend) const override;
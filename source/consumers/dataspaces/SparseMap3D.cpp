@@ -16,15 +16,18 @@ bool SparseMap3D::empty() const
 
 void SparseMap3D::clear()
 {
+  touch_all();
   max0_ = 0;
   max1_ = 0;
   max2_ = 0;
   total_count_ = 0;
   spectrum_.clear();
+  changed_.clear();
 }
 
 void SparseMap3D::add(const Entry& e)
 {
+  touch();
   if ((e.first.size() != dimensions()) || !e.second)
     return;
   bin_pair(e.first[0], e.first[1], e.first[2], e.second);
@@ -32,11 +35,19 @@ void SparseMap3D::add(const Entry& e)
 
 void SparseMap3D::add_one(const Coords& coords)
 {
+  touch();
   if (coords.size() != dimensions())
     return;
   bin_one(coords[0], coords[1], coords[2]);
 }
 
+void SparseMap3D::add_ones(const size_t* begin, const size_t* end)
+{
+  touch();
+  for (auto i = begin; i + 2 < end; i += 3)
+    bin_one(i[0], i[1], i[2]);
+}
+
 void SparseMap3D::recalc_axes()
 {
   auto ax0 = axis(0);
@@ -95,6 +106,28 @@ EntryList SparseMap3D::range(std::vector<Pair> list) const
   return result;
 }
 
+bool SparseMap3D::range_since(DataBlock& block, uint64_t since) const
+{
+  if (since < cleared_version_)
+  {
+    read_range(block, {});
+    return false;
+  }
+
+  // the map is sorted on x, so each changed x is one contiguous run
+  block.reset_sparse(3);
+  for (size_t x = 0; x < changed_.size(); ++x)
+  {
+    if (changed_[x] <= since)
+      continue;
+    for (auto it = spectrum_.lower_bound(tripple(x, 0, 0));
+         (it != spectrum_.end()) && (std::get<0>(it->first) == x); ++it)
+      block.push({x, std::get<1>(it->first), std::get<2>(it->first)},
+                 to_double(it->second));
+  }
+  return true;
+}
+
 void SparseMap3D::fill_list(EntryList& result,
                             size_t min0, size_t max0,
                             size_t min1, size_t max1,
@@ -113,6 +146,28 @@ void SparseMap3D::fill_list(EntryList& result,
   }
 }
 
+void SparseMap3D::data_merge(const Dataspace& other)
+{
+  auto o = dynamic_cast<const SparseMap3D*>(&other);
+  if (!o)
+  {
+    Dataspace::data_merge(other);
+    return;
+  }
+  // both sorted, so each insertion is hinted at the right place
+  auto it = spectrum_.begin();
+  for (const auto& e : o->spectrum_)
+  {
+    it = spectrum_.emplace_hint(it, e.first, PreciseFloat(0));
+    (it++)->second += e.second;
+    mark(std::get<0>(e.first));
+  }
+  max0_ = std::max(max0_, o->max0_);
+  max1_ = std::max(max1_, o->max1_);
+  max2_ = std::max(max2_, o->max2_);
+  total_count_ += o->total_count_;
+}
+
 void SparseMap3D::data_save(const hdf5::node::Group& g) const
 {
   if (!spectrum_.size())
@@ -16,8 +16,12 @@ class SparseMap3D : public Dataspace
     void clear() override;
     void add(const Entry&) override;
     void add_one(const Coords&) override;
+    using Dataspace::add_ones;
+    void add_ones(const size_t* begin, const size_t* end) override;
     PreciseFloat get(const Coords&) const override;
     EntryList range(std::vector<Pair> list) const override;
+    bool range_since(DataBlock& block, uint64_t since) const override;
+    bool tracks_changes() const override { return true; }
     void recalc_axes() override;
 
     void export_csv(std::ostream &) const override;
@@ -28,14 +32,25 @@ class SparseMap3D : public Dataspace
 
     //the data itself
     SpectrumMap3D spectrum_;
+    /// version of the last change, by x
+    std::vector<uint64_t> changed_;
+
     uint16_t max0_ {0};
     uint16_t max1_ {0};
     uint16_t max2_ {0};
 
+    inline void mark(uint16_t x)
+    {
+      if (changed_.size() <= x)
+        changed_.resize(size_t(x) + 1, 0);
+      changed_[x] = version_;
+    }
+
     inline void bin_pair(const uint16_t& x, const uint16_t& y, const uint16_t& z,
                          const PreciseFloat& count)
     {
       spectrum_[tripple(x,y,z)] += count;
+      mark(x);
       total_count_ += count;
       max0_ = std::max(max0_, x);
       max1_ = std::max(max1_, y);
@@ -45,6 +60,7 @@ class SparseMap3D : public Dataspace
     inline void bin_one(const uint16_t& x, const uint16_t& y, const uint16_t& z)
     {
       spectrum_[tripple(x,y,z)] ++;
+      mark(x);
       total_count_ ++;
       max0_ = std::max(max0_, x);
       max1_ = std::max(max1_, y);
@@ -58,6 +74,7 @@ class SparseMap3D : public Dataspace
                    size_t min1, size_t max1,
                    size_t min2, size_t max2) const;
 
+    void data_merge(const Dataspace& other) override;
     void data_save(const hdf5::node::Group&) const override;
     void data_load(const hdf5::node::Group&) override;
 
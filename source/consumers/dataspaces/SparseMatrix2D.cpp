@@ -23,13 +23,16 @@ void SparseMatrix2D::reserve(const Coords& limits)
 
 void SparseMatrix2D::clear()
 {
+  touch_all();
   total_count_ = 0;
   spectrum_.setZero();
+  changed_.clear();
   limits_ = {0,0};
 }
 
 void SparseMatrix2D::add(const Entry& e)
 {
+  touch();
   if ((e.first.size() != dimensions()) || !e.second)
     return;
   bin_pair(e.first[0], e.first[1], e.second);
@@ -37,11 +40,28 @@ void SparseMatrix2D::add(const Entry& e)
 
 void SparseMatrix2D::add_one(const Coords& coords)
 {
+  touch();
   if (coords.size() != dimensions())
     return;
   bin_one(coords[0], coords[1]);
 }
 
+void SparseMatrix2D::add_ones(const size_t* begin, const size_t* end)
+{
+  touch();
+  for (auto i = begin; i + 1 < end; i += 2)
+    bin_one(i[0], i[1]);
+}
+
+void SparseMatrix2D::add_many(const std::vector<size_t>& coords,
+                              const std::vector<PreciseFloat>& counts)
+{
+  touch();
+  for (size_t i = 0; (i < counts.size()) && (2 * i + 1 < coords.size()); ++i)
+    if (counts[i])
+      bin_pair(coords[2 * i], coords[2 * i + 1], counts[i]);
+}
+
 void SparseMatrix2D::recalc_axes()
 {
   auto ax0 = axis(0);
@@ -89,6 +109,26 @@ EntryList SparseMatrix2D::range(std::vector<Pair> list) const
   return result;
 }
 
+bool SparseMatrix2D::range_since(DataBlock& block, uint64_t since) const
+{
+  if (since < cleared_version_)
+  {
+    read_range(block, {});
+    return false;
+  }
+
+  block.reset_sparse(2);
+  size_t cols = std::min(changed_.size(), static_cast<size_t>(spectrum_.outerSize()));
+  for (size_t k = 0; k < cols; ++k)
+  {
+    if (changed_[k] <= since)
+      continue;
+    for (data_type_t::InnerIterator it(spectrum_, k); it; ++it)
+      block.push(it.row(), it.col(), it.value());
+  }
+  return true;
+}
+
 void SparseMatrix2D::fill_list(EntryList& result,
                                int64_t min0, int64_t max0,
                                int64_t min1, int64_t max1) const
@@ -108,6 +148,32 @@ void SparseMatrix2D::fill_list(EntryList& result,
   }
 }
 
+void SparseMatrix2D::data_merge(const Dataspace& other)
+{
+  auto o = dynamic_cast<const SparseMatrix2D*>(&other);
+  if (!o)
+  {
+    Dataspace::data_merge(other);
+    return;
+  }
+  auto rows = std::max(spectrum_.rows(), o->spectrum_.rows());
+  auto cols = std::max(spectrum_.cols(), o->spectrum_.cols());
+  spectrum_.conservativeResize(rows, cols);
+  if ((o->spectrum_.rows() == rows) && (o->spectrum_.cols() == cols))
+    spectrum_ += o->spectrum_;
+  else
+  {
+    data_type_t theirs = o->spectrum_;
+    theirs.conservativeResize(rows, cols);
+    spectrum_ += theirs;
+  }
+  // whole matrices are summed, any bin may have changed
+  touch_all();
+  limits_[0] = std::max(limits_[0], o->limits_[0]);
+  limits_[1] = std::max(limits_[1], o->limits_[1]);
+  total_count_ += o->total_count_;
+}
+
 void SparseMatrix2D::data_save(const hdf5::node::Group& g) const
 {
   if (spectrum_.nonZeros() == 0)
@@ -229,23 +295,6 @@ std::string SparseMatrix2D::data_debug(__attribute__((unused)) const std::string
   return ss.str();
 }
 
-void SparseMatrix2D::export_csv(std::ostream& os) const
-{
-  if (!spectrum_.size())
-    return;
-
-  for (uint16_t i = 0; i <= limits_[0]; i++)
-  {
-    for (uint16_t j = 0; j <= limits_[1]; j++)
-    {
-      os << spectrum_.coeff(i, j);
-      if (j < limits_[1])
-        os << ", ";
-    }
-    os << ";\n";
-  }
-}
-
 bool SparseMatrix2D::is_symmetric()
 {
   for (int k = 0; k < spectrum_.outerSize(); ++k)
@@ -18,12 +18,16 @@ class SparseMatrix2D : public Dataspace
     void clear() override;
     void add(const Entry&) override;
     void add_one(const Coords&) override;
+    using Dataspace::add_ones;
+    void add_ones(const size_t* begin, const size_t* end) override;
+    void add_many(const std::vector<size_t>& coords,
+                  const std::vector<PreciseFloat>& counts) override;
     PreciseFloat get(const Coords&) const override;
     EntryList range(std::vector<Pair> list) const override;
+    bool range_since(DataBlock& block, uint64_t since) const override;
+    bool tracks_changes() const override { return true; }
     void recalc_axes() override;
 
-    void export_csv(std::ostream&) const  override;
-
   protected:
     typedef Eigen::SparseMatrix<double> data_type_t;
 
@@ -31,6 +35,8 @@ class SparseMatrix2D : public Dataspace
     data_type_t spectrum_;
 
     Coords limits_ {0,0};
+    /// version of the last change, by column (the outer index)
+    std::vector<uint64_t> changed_;
 
     inline void adjust_maxima(const uint16_t& x, const uint16_t& y)
     {
@@ -43,10 +49,18 @@ class SparseMatrix2D : public Dataspace
         this->reserve(limits_);
     }
 
+    inline void mark(uint16_t y)
+    {
+      if (changed_.size() <= y)
+        changed_.resize(size_t(y) + 1, 0);
+      changed_[y] = version_;
+    }
+
     inline void bin_pair(const uint16_t& x, const uint16_t& y,
                          const PreciseFloat& count)
     {
       adjust_maxima(x,y);
+      mark(y);
       spectrum_.coeffRef(x, y) += count;
       total_count_ += count;
     }
@@ -54,6 +68,7 @@ class SparseMatrix2D : public Dataspace
     inline void bin_one(const uint16_t& x, const uint16_t& y)
     {
       adjust_maxima(x,y);
+      mark(y);
       spectrum_.coeffRef(x, y) ++;
       total_count_ ++;
     }
@@ -64,6 +79,7 @@ class SparseMatrix2D : public Dataspace
                    int64_t min0, int64_t max0,
                    int64_t min1, int64_t max1) const;
 
+    void data_merge(const Dataspace& other) override;
     void data_save(const hdf5::node::Group&) const override;
     void data_load(const hdf5::node::Group&) override;
 
@@ -0,0 +1,156 @@
+#include <consumers/dataspaces/TileMap2D.h>
+#include <consumers/dataspaces/SparseLayout.h>
+
+namespace DAQuiri {
+
+TileMap2D::TileMap2D(uint16_t tile_shift)
+    : Dataspace(2)
+    , tiles_(std::max(uint16_t(1), std::min(tile_shift, uint16_t(8))))
+{}
+
+bool TileMap2D::empty() const
+{
+  return tiles_.empty();
+}
+
+void TileMap2D::clear()
+{
+  touch_all();
+  max0_ = 0;
+  max1_ = 0;
+  total_count_ = 0;
+  tiles_.clear();
+}
+
+void TileMap2D::add(const Entry& e)
+{
+  touch();
+  if ((e.first.size() != dimensions()) || !e.second)
+    return;
+  bin_pair(e.first[0], e.first[1], e.second);
+}
+
+void TileMap2D::add_one(const Coords& coords)
+{
+  touch();
+  if (coords.size() != dimensions())
+    return;
+  bin_one(coords[0], coords[1]);
+}
+
+void TileMap2D::add_ones(const size_t* begin, const size_t* end)
+{
+  touch();
+  for (auto i = begin; i + 1 < end; i += 2)
+    bin_one(i[0], i[1]);
+}
+
+void TileMap2D::add_many(const std::vector<size_t>& coords,
+                         const std::vector<PreciseFloat>& counts)
+{
+  touch();
+  for (size_t i = 0; (i < counts.size()) && (2 * i + 1 < coords.size()); ++i)
+    if (counts[i])
+      bin_pair(coords[2 * i], coords[2 * i + 1], counts[i]);
+}
+
+void TileMap2D::recalc_axes()
+{
+  auto ax0 = axis(0);
+  ax0.expand_domain(max0_);
+  set_axis(0, ax0);
+
+  auto ax1 = axis(1);
+  ax1.expand_domain(max1_);
+  set_axis(1, ax1);
+}
+
+PreciseFloat TileMap2D::at(uint16_t x, uint16_t y) const
+{
+  return tiles_.get({x, y});
+}
+
+PreciseFloat TileMap2D::get(const Coords& coords) const
+{
+  if (coords.size() != dimensions())
+    return 0;
+  return at(coords[0], coords[1]);
+}
+
+EntryList TileMap2D::range(std::vector<Pair> list) const
+{
+  Coords lo, hi;
+  range_bounds(list, {max0_, max1_}, lo, hi);
+  EntryList result(new EntryList_t);
+  tiles_.fill(*result, lo, hi);
+  return result;
+}
+
+void TileMap2D::read_range(DataBlock& block, std::vector<Pair> list) const
+{
+  Coords lo, hi;
+  range_bounds(list, {max0_, max1_}, lo, hi);
+  tiles_.read(block, lo, hi);
+}
+
+bool TileMap2D::range_since(DataBlock& block, uint64_t since) const
+{
+  if (since < cleared_version_)
+  {
+    read_range(block, {});
+    return false;
+  }
+  tiles_.read_since(block, since);
+  return true;
+}
+
+void TileMap2D::data_save(const hdf5::node::Group& g) const
+{
+  if (tiles_.empty())
+    return;
+
+  try
+  {
+    EntryList_t entries;
+    tiles_.fill(entries, {0, 0}, {max0_, max1_});
+    save_entries(g, entries, 2);
+  }
+  catch (...)
+  {
+    std::throw_with_nested(std::runtime_error("<TileMap2D> Could not save"));
+  }
+}
+
+void TileMap2D::data_load(const hdf5::node::Group& g)
+{
+  try
+  {
+    std::vector<std::vector<uint16_t>> indices;
+    std::vector<double> counts;
+    if (!load_entries(g, 2, indices, counts))
+      return;
+
+    clear();
+    for (size_t i = 0; i < indices[0].size(); ++i)
+      bin_pair(indices[0][i], indices[1][i], counts[i]);
+  }
+  catch (...)
+  {
+    std::throw_with_nested(std::runtime_error("<TileMap2D> Could not load"));
+  }
+}
+
+std::string TileMap2D::data_debug(__attribute__((unused)) const std::string& prepend) const
+{
+  double maximum = to_double(tiles_.max());
+
+  std::stringstream ss;
+  ss << prepend << "Maximum=" << maximum
+     << " tiles=" << tiles_.count() << "\n";
+  if (maximum)
+    ascii_grid(ss, prepend, maximum, max0_, max1_,
+               [this](uint16_t x, uint16_t y) { return at(x, y); });
+  return ss.str();
+}
+
+}
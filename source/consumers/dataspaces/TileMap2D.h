@@ -0,0 +1,72 @@
+#pragma once
+
+#include <core/Dataspace.h>
+#include <consumers/dataspaces/BlockMap.h>
+
+namespace DAQuiri
+{
+
+/// \brief 2D counts in dense square tiles, allocated when first touched
+///
+/// Meant for streaming increments: a fill is a tile lookup (skipped when
+/// the previous fill hit the same tile) plus an integer increment, and
+/// growing the extent never moves existing tiles, see BlockMap. Saved in
+/// the same layout as SparseMatrix2D and SparseMap2D.
+class TileMap2D : public Dataspace
+{
+  public:
+    /// \param tile_shift log2 of the tile edge, 5 gives 32x32 tiles
+    explicit TileMap2D(uint16_t tile_shift = 5);
+    TileMap2D* clone() const override
+    { return new TileMap2D(*this); }
+
+    bool empty() const override;
+    void clear() override;
+    void add(const Entry&) override;
+    void add_one(const Coords&) override;
+    using Dataspace::add_ones;
+    void add_ones(const size_t* begin, const size_t* end) override;
+    void add_many(const std::vector<size_t>& coords,
+                  const std::vector<PreciseFloat>& counts) override;
+    PreciseFloat get(const Coords&) const override;
+    EntryList range(std::vector<Pair> list) const override;
+    void read_range(DataBlock& block, std::vector<Pair> list) const override;
+    bool range_since(DataBlock& block, uint64_t since) const override;
+    bool tracks_changes() const override { return true; }
+    void recalc_axes() override;
+
+    inline size_t tile_edge() const { return tiles_.edge(); }
+    inline size_t tile_count() const { return tiles_.count(); }
+
+  protected:
+    BlockMap<uint32_t, 2> tiles_;
+
+    uint16_t max0_ {0};
+    uint16_t max1_ {0};
+
+    PreciseFloat at(uint16_t x, uint16_t y) const;
+
+    inline void bin_pair(const uint16_t& x, const uint16_t& y,
+                         const PreciseFloat& count)
+    {
+      tiles_.add({x, y}, count, version_);
+      total_count_ += count;
+      max0_ = std::max(max0_, x);
+      max1_ = std::max(max1_, y);
+    }
+
+    inline void bin_one(const uint16_t& x, const uint16_t& y)
+    {
+      tiles_.add_one({x, y}, version_);
+      total_count_ ++;
+      max0_ = std::max(max0_, x);
+      max1_ = std::max(max1_, y);
+    }
+
+    void data_save(const hdf5::node::Group&) const override;
+    void data_load(const hdf5::node::Group&) override;
+
+    std::string data_debug(const std::string& prepend) const override;
+};
+
+}
@@ -15,6 +15,10 @@ Consumer::Consumer()
   stream.set_flag("stream");
   attributes.branches.add(stream);
 
+  SettingMeta dropped("dropped_spills", SettingType::integer, "Dropped spills");
+  dropped.set_flag("readonly");
+  attributes.branches.add(dropped);
+
   metadata_.overwrite_all_attributes(attributes);
 }
 
@@ -60,6 +64,7 @@ void Consumer::_set_detectors(const std::vector<Detector>& dets)
 void Consumer::from_prototype(const ConsumerMetadata& newtemplate)
 {
   UNIQUE_LOCK_EVENTUALLY_ST
+  detach_data();
 
   if (metadata_.type() != newtemplate.type())
     return;
@@ -71,6 +76,7 @@ void Consumer::from_prototype(const ConsumerMetadata& newtemplate)
     metadata_.set_attribute(a);
     this->_apply_attributes();
   }
+  subscription_version_++;
 
   metadata_.detectors.clear(); // really?
 }
@@ -78,9 +84,26 @@ void Consumer::from_prototype(const ConsumerMetadata& newtemplate)
 void Consumer::push_spill(const Spill& spill)
 {
   UNIQUE_LOCK_EVENTUALLY_ST
+  detach_data();
   this->_push_spill(spill);
 }
 
+std::set<std::string> Consumer::streams() const
+{
+  SHARED_LOCK_ST
+  return this->_streams();
+}
+
+uint64_t Consumer::subscription_version() const
+{
+  return subscription_version_;
+}
+
+std::set<std::string> Consumer::_streams() const
+{
+  return {stream_id_};
+}
+
 bool Consumer::_accept_spill(const Spill& spill)
 {
   return (spill.stream_id == stream_id_);
@@ -98,8 +121,10 @@ void Consumer::_push_spill(const Spill& spill)
   this->_push_stats_pre(spill);
 
   if (this->_accept_spill(spill) && this->_accept_events(spill))
-    for (auto& q : spill.events)
-      this->_push_event(q);
+  {
+    if (!spill.columns || !this->_push_columns(*spill.columns))
+      this->_push_events(spill.event_buffer());
+  }
 
   this->_push_stats_post(spill);
 
@@ -109,12 +134,59 @@ void Consumer::_push_spill(const Spill& spill)
 //      << addspill_timer.us() / double(spill.events.size()) << " us/hit";
 }
 
+void Consumer::_push_events(const EventBuffer& events)
+{
+  for (const auto& q : events)
+    this->_push_event(q);
+}
+
+void Consumer::add_dropped_spills(size_t count)
+{
+  UNIQUE_LOCK_EVENTUALLY_ST
+  auto dropped = metadata_.get_attribute("dropped_spills");
+  dropped.set_number(dropped.get_number() + count);
+  metadata_.set_attribute(dropped);
+  changed_ = true;
+}
+
 void Consumer::flush()
 {
   UNIQUE_LOCK_EVENTUALLY_ST
+  detach_data();
+  collect_data();
   this->_flush();
 }
 
+void Consumer::check_merge(const Consumer& other) const
+{
+  if (&other == this)
+    throw std::runtime_error("<Consumer> Cannot merge into itself");
+  if (other.type() != type())
+    throw std::runtime_error("<Consumer> Cannot merge " + other.type()
+                                 + " into " + type());
+  auto theirs = other.data();
+  SHARED_LOCK_ST
+  if (data_ && theirs)
+    data_->check_merge(*theirs);
+}
+
+void Consumer::merge(const Consumer& other)
+{
+  check_merge(other);
+  auto theirs = other.data();
+  auto their_metadata = other.metadata();
+
+  UNIQUE_LOCK_EVENTUALLY_ST
+  detach_data();
+  collect_data();
+  if (!data_ || !theirs)
+    return;
+  data_->merge(*theirs);
+  this->_merge(their_metadata);
+  this->_recalc_axes();
+  changed_ = true;
+}
+
 bool Consumer::changed() const
 {
   SHARED_LOCK_ST
@@ -124,6 +196,7 @@ bool Consumer::changed() const
 void Consumer::set_detectors(const std::vector<Detector>& dets)
 {
   UNIQUE_LOCK_EVENTUALLY_ST
+  detach_data();
   this->_set_detectors(dets);
   changed_ = true;
 }
@@ -141,12 +214,66 @@ ConsumerMetadata Consumer::metadata() const
   return metadata_;
 }
 
-DataspacePtr Consumer::data() const
+DataspaceConstPtr Consumer::data() const
 {
-  SHARED_LOCK_ST
-  if (!data_)
-    return nullptr;
-  return DataspacePtr(data_->clone());
+  {
+    SHARED_LOCK_ST
+    if (!data_)
+      return nullptr;
+    if (snapshot_current_ && !data_stale_)
+      return snapshot_;
+  }
+  // the first reader after a change brings the copy up to date,
+  // which is why this is not quite const
+  UNIQUE_LOCK_EVENTUALLY_ST
+  auto self = const_cast<Consumer*>(this);
+  self->collect_data();
+  self->publish_data();
+  return snapshot_;
+}
+
+void Consumer::detach_data()
+{
+  snapshot_current_ = false;
+}
+
+void Consumer::collect_data()
+{
+  if (!data_stale_)
+    return;
+  detach_data();
+  this->_sync_data();
+  data_stale_ = false;
+}
+
+void Consumer::publish_data()
+{
+  if (snapshot_current_ || !data_)
+    return;
+  // readers keep the copy they got, a new one is started for the others,
+  // so the consumer itself never holds more than one copy
+  if (snapshot_.use_count() > 1)
+    snapshot_.reset();
+  refresh(snapshot_);
+  snapshot_current_ = true;
+}
+
+void Consumer::refresh(DataspacePtr& copy) const
+{
+  auto version = data_->version();
+  bool changed = copy && (copy->version() != version);
+  if (!copy || (copy->version() > version)
+      || (changed && (!data_->tracks_changes()
+                      || (copy->version() < data_->cleared_version()))))
+  {
+    copy = DataspacePtr(data_->clone());
+    return;
+  }
+
+  DataBlock changes;
+  if (changed)
+    data_->range_since(changes, copy->version());
+  copy->update_from(*data_, changes);
 }
 
 std::string Consumer::type() const
@@ -165,6 +292,7 @@ uint16_t Consumer::dimensions() const
 
 std::string Consumer::debug(std::string prepend, bool verbose) const
 {
+  auto data = this->data();
   SHARED_LOCK_ST
   std::stringstream ss;
   ss << "COMSUMER";
@@ -173,8 +301,8 @@ std::string Consumer::debug(std::string prepend, bool verbose) const
   ss << "\n";
   ss << prepend << k_branch_mid_B
      << metadata_.debug(prepend + k_branch_pre_B, verbose);
-  if (data_)
-    ss << prepend << k_branch_end_B << data_->debug(prepend + "  ");
+  if (data)
+    ss << prepend << k_branch_end_B << data->debug(prepend + "  ");
   else
     ss << prepend << k_branch_end_B << "NODATA";
   return ss.str();
@@ -185,16 +313,20 @@ std::string Consumer::debug(std::string prepend, bool verbose) const
 void Consumer::set_attribute(const Setting& setting, bool greedy)
 {
   UNIQUE_LOCK_EVENTUALLY_ST
+  detach_data();
   metadata_.set_attribute(setting, greedy);
   this->_apply_attributes();
+  subscription_version_++;
   changed_ = true;
 }
 
 void Consumer::set_attributes(const Setting& settings)
 {
   UNIQUE_LOCK_EVENTUALLY_ST
+  detach_data();
   metadata_.set_attributes(settings.branches.data(), true);
   this->_apply_attributes();
+  subscription_version_++;
   changed_ = true;
 }
 
@@ -204,6 +336,8 @@ void Consumer::set_attributes(const Setting& settings)
 void Consumer::load(hdf5::node::Group& g, bool withdata)
 {
   UNIQUE_LOCK_EVENTUALLY_ST
+  detach_data();
+  collect_data();
   if (!g.has_group("metadata"))
     return;
 
@@ -219,6 +353,7 @@ void Consumer::load(hdf5::node::Group& g, bool withdata)
       data_->load(g);
 
     this->_init_from_file();
+    subscription_version_++;
   }
   catch (...)
   {
@@ -229,6 +364,7 @@ void Consumer::load(hdf5::node::Group& g, bool withdata)
 
 void Consumer::save(hdf5::node::Group& g) const
 {
+  auto data = this->data();
   SHARED_LOCK_ST
   try
   {
@@ -238,8 +374,8 @@ void Consumer::save(hdf5::node::Group& g) const
     auto mdg = hdf5::require_group(g, "metadata");
     hdf5::from_json(json(metadata_), mdg);
 
-    if (data_)
-      data_->save(g);
+    if (data)
+      data->save(g);
   }
   catch (...)
   {
@@ -11,6 +11,8 @@
 #include <core/ConsumerMetadata.h>
 #include <core/Spill.h>
 #include <core/Dataspace.h>
+#include <atomic>
+#include <set>
 
 namespace DAQuiri {
 
@@ -25,12 +27,16 @@ class Consumer
     ConsumerMetadata metadata_;
     DataspacePtr data_;
     bool changed_ {false};
+    /// set when data_ lags behind data kept elsewhere (e.g. partial results
+    /// of parallel filling), _sync_data() is then called before it is used
+    bool data_stale_ {false};
 
   public:
     Consumer();
     Consumer(const Consumer& other)
       : metadata_(other.metadata_)
       , changed_ {true} // \todo: really?
+      , data_stale_ {other.data_stale_}
     {
         if (other.data_)
             data_ = DataspacePtr(other.data_->clone());
@@ -48,8 +54,26 @@ class Consumer
     void push_spill(const Spill&);
     void flush();
 
+    /// \brief adds the data of another consumer of the same type, such as
+    ///         one filled in parallel or opened from another file
+    void merge(const Consumer& other);
+    /// \brief throws if merge(other) would, without changing anything
+    void check_merge(const Consumer& other) const;
+    /// \brief accounts for spills discarded before reaching this consumer
+    void add_dropped_spills(size_t count);
+
     ConsumerMetadata metadata() const;
-    DataspacePtr data() const;
+    /// \brief read-only copy of the latest data, the same one for repeated
+    ///         reads until the data changes, readers may keep it for as long
+    ///         as they like
+    DataspaceConstPtr data() const;
+
+    /// \brief ids of all streams whose spills this consumer may accept
+    std::set<std::string> streams() const;
+
+    /// \brief incremented whenever this consumer's attributes change,
+    ///         which may change its streams()
+    uint64_t subscription_version() const;
 
     void reset_changed();
     bool changed() const;
@@ -65,6 +89,10 @@ class Consumer
     void set_detectors(const std::vector<Detector>& dets);
 
   protected:
+    /// \brief to be called with the lock held before data_ is modified,
+    ///         so the next data() brings the readers' copy up to date
+    void detach_data();
+
     //////////////////////////////////////////
     //////////THIS IS THE MEAT////////////////
     ///implement these to make custom types///
@@ -81,17 +109,45 @@ class Consumer
     /// source file and not anywhere else. Get rid of virtual?
     virtual void _push_spill(const Spill&);
 
+    /// must include every stream_id for which _accept_spill may be true
+    virtual std::set<std::string> _streams() const;
     virtual bool _accept_spill(const Spill& spill) = 0;
     virtual bool _accept_events(const Spill& spill) = 0;
 
     virtual void _push_stats_pre(const Spill&) {}
-    virtual void _push_event(const Event&) = 0;
+    virtual void _push_event(const EventView&) = 0;
+    /// default calls _push_event for every event,
+    /// override to process the whole buffer at once
+    virtual void _push_events(const EventBuffer&);
+    /// called for spills with undecoded events (see EventColumns),
+    /// return false to have them decoded and passed to _push_events instead
+    virtual bool _push_columns(const EventColumns&) { return false; }
     virtual void _push_stats_post(const Spill&) {}
 
     virtual void _flush() {}
+    /// called after the data of another consumer was merged into data_,
+    /// to combine statistics kept in metadata
+    virtual void _merge(const ConsumerMetadata&) {}
+    /// brings data_ up to date while data_stale_ is set
+    virtual void _sync_data() {}
 
   private:
     std::string stream_id_;
+
+    /// what data() hands out, a copy of data_ kept current unless data_
+    /// changed since, shared with readers until the next change
+    DataspacePtr snapshot_;
+    bool snapshot_current_ {false};
+
+    /// \brief calls _sync_data() if needed, with the lock held
+    void collect_data();
+    /// \brief makes snapshot_ current, with the lock held
+    void publish_data();
+    /// \brief brings a copy up to date, only the bins that changed if
+    ///         data_ can tell which
+    void refresh(DataspacePtr& copy) const;
+
+    std::atomic<uint64_t> subscription_version_ {0};
 };
 
 }
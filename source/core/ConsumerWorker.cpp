@@ -0,0 +1,96 @@
+#include <core/ConsumerWorker.h>
+
+namespace DAQuiri {
+
+ConsumerWorker::ConsumerWorker(ConsumerPtr consumer, size_t backlog)
+    : consumer_(consumer)
+    , backlog_(std::max(backlog, size_t(1)))
+{
+  thread_ = std::thread(&ConsumerWorker::run, this);
+}
+
+ConsumerWorker::~ConsumerWorker()
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  work_.notify_all();
+  idle_.notify_all();
+  thread_.join();
+}
+
+void ConsumerWorker::enqueue(const SpillPtr& spill)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (queue_.size() >= backlog_)
+  {
+    if (spill->type == Spill::Type::running)
+    {
+      dropped_++;
+      unreported_++;
+      return;
+    }
+    idle_.wait(lock, [this] { return stop_ || (queue_.size() < backlog_); });
+    if (stop_)
+      return;
+  }
+  queue_.push_back(spill);
+  work_.notify_one();
+}
+
+void ConsumerWorker::drain()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_.wait(lock, [this] { return stop_ || (queue_.empty() && !busy_); });
+}
+
+size_t ConsumerWorker::size() const
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  return queue_.size();
+}
+
+size_t ConsumerWorker::dropped_spills() const
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  return dropped_;
+}
+
+void ConsumerWorker::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true)
+  {
+    work_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+    if (stop_)
+      return;
+
+    SpillPtr spill = queue_.front();
+    queue_.pop_front();
+    size_t dropped = unreported_;
+    unreported_ = 0;
+    busy_ = true;
+    idle_.notify_all();
+    lock.unlock();
+
+    if (dropped)
+      consumer_->add_dropped_spills(dropped);
+    consumer_->push_spill(*spill);
+
+    lock.lock();
+    if (queue_.empty() && unreported_)
+    {
+      // nothing else coming to carry the count, report it now
+      dropped = unreported_;
+      unreported_ = 0;
+      lock.unlock();
+      consumer_->add_dropped_spills(dropped);
+      lock.lock();
+    }
+    busy_ = false;
+    idle_.notify_all();
+  }
+}
+
+}
@@ -0,0 +1,62 @@
+/* Copyright (C) 2016-2020 European Spallation Source, ERIC. See LICENSE file */
+//===----------------------------------------------------------------------===//
+///
+/// \file ConsumerWorker.h
+///
+/// \brief bounded input queue and thread feeding spills to one consumer
+///
+/// Decouples a consumer from the rest of the project, so that a slow one only
+/// falls behind on its own. Once backlog spills are waiting, further running
+/// spills are dropped and counted in the consumer's "dropped_spills"
+/// attribute. Start, stop and status spills are never dropped, enqueue waits
+/// for room instead.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <core/Consumer.h>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+namespace DAQuiri {
+
+class ConsumerWorker
+{
+ public:
+  ConsumerWorker(ConsumerPtr consumer, size_t backlog);
+  ~ConsumerWorker(); ///< spills still waiting are discarded
+
+  ConsumerWorker(const ConsumerWorker&) = delete;
+  ConsumerWorker& operator=(const ConsumerWorker&) = delete;
+
+  void enqueue(const SpillPtr& spill);
+
+  /// \brief blocks until all enqueued spills have been pushed to the consumer
+  void drain();
+
+  ConsumerPtr consumer() const { return consumer_; }
+  size_t backlog() const { return backlog_; }
+  size_t size() const;
+  size_t dropped_spills() const;
+
+ private:
+  ConsumerPtr consumer_;
+  size_t backlog_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable work_;
+  std::condition_variable idle_;
+  std::deque<SpillPtr> queue_;
+  bool busy_ {false};
+  bool stop_ {false};
+
+  size_t dropped_ {0};
+  size_t unreported_ {0}; ///< dropped, but not yet added to consumer attribute
+
+  std::thread thread_;
+
+  void run();
+};
+
+}
@@ -2,11 +2,92 @@
 #include <core/util/ascii_tree.h>
 #include <core/util/h5json.h>
 
+#include <algorithm>
 #include <codecvt>
+#include <limits>
 #include <locale>
 
 namespace DAQuiri {
 
+void DataBlock::reset_sparse(size_t dimensions)
+{
+  layout = Layout::sparse;
+  origin.clear();
+  shape.clear();
+  coords.resize(dimensions);
+  for (auto& c : coords)
+    c.clear();
+  counts.clear();
+}
+
+void DataBlock::reset_dense(const Coords& o, const Coords& s)
+{
+  layout = Layout::dense;
+  origin = o;
+  shape = s;
+  coords.clear();
+  size_t total = s.empty() ? 0 : 1;
+  for (auto n : s)
+    total *= n;
+  counts.assign(total, 0.0);
+}
+
+void DataBlock::push(const Coords& c, double count)
+{
+  for (size_t d = 0; d < coords.size(); ++d)
+    coords[d].push_back(c[d]);
+  counts.push_back(count);
+}
+
+void DataBlock::densify()
+{
+  if (layout == Layout::dense)
+    return;
+
+  Coords s(coords.size(), 0);
+  for (size_t d = 0; d < coords.size(); ++d)
+    if (!coords[d].empty())
+      s[d] = *std::max_element(coords[d].begin(), coords[d].end()) + 1;
+
+  std::vector<std::vector<size_t>> sparse_coords;
+  std::vector<double> sparse_counts;
+  sparse_coords.swap(coords);
+  sparse_counts.swap(counts);
+
+  reset_dense(Coords(s.size(), 0), s);
+  for (size_t i = 0; i < sparse_counts.size(); ++i)
+  {
+    size_t idx = 0;
+    for (size_t d = 0; d < s.size(); ++d)
+      idx = idx * s[d] + sparse_coords[d][i];
+    counts[idx] += sparse_counts[i];
+  }
+}
+
+void DataBlock::write_csv(std::ostream& os) const
+{
+  if (layout == Layout::sparse)
+  {
+    DataBlock dense(*this);
+    dense.densify();
+    dense.write_csv(os);
+    return;
+  }
+
+  if (shape.empty() || counts.empty())
+    return;
+
+  size_t cols = shape.back();
+  for (size_t i = 0; i < counts.size(); ++i)
+  {
+    os << counts[i];
+    if ((i + 1) % cols)
+      os << ", ";
+    else if (shape.size() > 1)
+      os << ";\n";
+  }
+}
+
 DataAxis::DataAxis(Calibration c, int16_t resample_shift)
 {
   calibration = c;
@@ -92,7 +173,40 @@ Dataspace::Dataspace(uint16_t dimensions)
 }
 
 Dataspace::Dataspace(const Dataspace& other)
-    : axes_(other.axes_), dimensions_(other.dimensions_), total_count_(other.total_count_) {}
+    : axes_(other.axes_), dimensions_(other.dimensions_), total_count_(other.total_count_)
+    , version_(other.version_), cleared_version_(other.cleared_version_) {}
+
+void Dataspace::add_ones(const std::vector<size_t>& coords)
+{
+  this->add_ones(coords.data(), coords.data() + coords.size());
+}
+
+void Dataspace::add_ones(const size_t* begin, const size_t* end)
+{
+  if (!dimensions_)
+    return;
+  Coords c(dimensions_);
+  for (auto i = begin; i + dimensions_ <= end; i += dimensions_)
+  {
+    std::copy(i, i + dimensions_, c.begin());
+    this->add_one(c);
+  }
+}
+
+void Dataspace::add_many(const std::vector<size_t>& coords,
+                         const std::vector<PreciseFloat>& counts)
+{
+  if (!dimensions_)
+    return;
+  Entry e{Coords(dimensions_), 0};
+  for (size_t i = 0; (i < counts.size()) && ((i + 1) * dimensions_ <= coords.size()); ++i)
+  {
+    std::copy(coords.begin() + i * dimensions_,
+              coords.begin() + (i + 1) * dimensions_, e.first.begin());
+    e.second = counts[i];
+    this->add(e);
+  }
+}
 
 EntryList Dataspace::all_data() const
 {
@@ -102,6 +216,222 @@ EntryList Dataspace::all_data() const
   return this->range(ranges);
 }
 
+void Dataspace::read_range(DataBlock& block, std::vector<Pair> ranges) const
+{
+  block.reset_sparse(dimensions_);
+  auto entries = this->range(ranges);
+  if (!entries)
+    return;
+  for (const auto& e : *entries)
+    block.push(e.first, to_double(e.second));
+}
+
+void Dataspace::read_all(DataBlock& block) const
+{
+  std::vector<Pair> ranges;
+  for (auto a : axes_)
+    ranges.push_back(a.bounds());
+  this->read_range(block, ranges);
+}
+
+uint64_t Dataspace::version() const
+{
+  return version_;
+}
+
+uint64_t Dataspace::cleared_version() const
+{
+  return cleared_version_;
+}
+
+bool Dataspace::range_since(DataBlock& block, uint64_t since) const
+{
+  if (since >= version_)
+  {
+    block.reset_sparse(dimensions_);
+    return true;
+  }
+  this->read_range(block);
+  return false;
+}
+
+void Dataspace::update_from(const Dataspace& source, const DataBlock& changes)
+{
+  uint64_t target = source.version_;
+  changes.for_each([this, &source, target](const Coords& c, double)
+                   {
+                     auto delta = source.get(c) - this->get(c);
+                     if (delta == 0)
+                       return;
+                     // bins changed here are marked with the version of
+                     // source, as if they had been copied from it
+                     version_ = target - 1;
+                     this->add({c, delta});
+                   });
+  version_ = target;
+  // axes change without changing the version
+  for (uint16_t d = 0; d < dimensions_; ++d)
+    this->set_axis(d, source.axis(d));
+}
+
+void Dataspace::read_level(DataBlock& block, uint16_t level,
+                           std::vector<Pair> ranges) const
+{
+  if (!level || !dimensions_)
+  {
+    this->read_range(block, ranges);
+    return;
+  }
+
+  // widen to whole coarse bins
+  size_t width = size_t(1) << level;
+  for (auto& r : ranges)
+  {
+    auto lo = std::min(r.first, r.second);
+    auto hi = std::max(r.first, r.second);
+    r.first = (lo >> level) << level;
+    r.second = std::max(hi, ((hi >> level) << level) + width - 1);
+  }
+
+  DataBlock fine;
+  this->read_range(fine, ranges);
+  block.reset_sparse(dimensions_);
+  if (fine.empty())
+    return;
+
+  // coarse box spanned by the bins read
+  Coords lo(dimensions_, std::numeric_limits<size_t>::max());
+  Coords hi(dimensions_, 0);
+  fine.for_each([&lo, &hi](const Coords& c, double count)
+                {
+                  if (count == 0)
+                    return;
+                  for (size_t d = 0; d < c.size(); ++d)
+                  {
+                    lo[d] = std::min(lo[d], c[d]);
+                    hi[d] = std::max(hi[d], c[d]);
+                  }
+                });
+  if (lo[0] > hi[0])
+    return;
+
+  // a dense buffer unless the box is much larger than the data in it
+  size_t limit = std::max(4 * fine.size(), size_t(1) << 16);
+  Coords origin(dimensions_), shape(dimensions_);
+  size_t cells {1};
+  for (size_t d = 0; (d < dimensions_) && cells; ++d)
+  {
+    origin[d] = lo[d] >> level;
+    shape[d] = (hi[d] >> level) - origin[d] + 1;
+    cells = (shape[d] > limit / cells) ? 0 : (cells * shape[d]);
+  }
+
+  if (cells)
+  {
+    std::vector<double> coarse(cells, 0.0);
+    fine.for_each([&](const Coords& c, double count)
+                  {
+                    size_t i {0};
+                    for (size_t d = 0; d < c.size(); ++d)
+                      i = i * shape[d] + ((c[d] >> level) - origin[d]);
+                    coarse[i] += count;
+                  });
+
+    // nonzero bins only, in the same order as the dense box
+    Coords c = origin;
+    for (const auto& count : coarse)
+    {
+      if (count != 0)
+        block.push(c, count);
+      for (size_t d = c.size(); d-- > 0;)
+      {
+        if (++c[d] < origin[d] + shape[d])
+          break;
+        c[d] = origin[d];
+      }
+    }
+    return;
+  }
+
+  std::vector<std::pair<Coords, double>> coarse;
+  coarse.reserve(fine.size());
+  fine.for_each([&coarse, level](const Coords& c, double count)
+                {
+                  if (count == 0)
+                    return;
+                  Coords k = c;
+                  for (auto& i : k)
+                    i >>= level;
+                  coarse.emplace_back(std::move(k), count);
+                });
+  std::sort(coarse.begin(), coarse.end(),
+            [](const std::pair<Coords, double>& a,
+               const std::pair<Coords, double>& b)
+            {
+              return a.first < b.first;
+            });
+  for (size_t i = 0; i < coarse.size();)
+  {
+    double sum {0};
+    size_t j = i;
+    for (; (j < coarse.size()) && (coarse[j].first == coarse[i].first); ++j)
+      sum += coarse[j].second;
+    if (sum != 0)
+      block.push(coarse[i].first, sum);
+    i = j;
+  }
+}
+
+void Dataspace::check_merge(const Dataspace& other) const
+{
+  if (other.dimensions_ != dimensions_)
+    throw std::runtime_error("<Dataspace> Cannot merge "
+                                 + std::to_string(other.dimensions_) + "D data into "
+                                 + std::to_string(dimensions_) + "D");
+  for (size_t i = 0; i < axes_.size(); ++i)
+    if ((axes_[i].calibration != other.axes_[i].calibration) ||
+        (axes_[i].resample_shift_ != other.axes_[i].resample_shift_))
+      throw std::runtime_error("<Dataspace> Cannot merge, axis "
+                                   + std::to_string(i) + " calibrations differ");
+}
+
+void Dataspace::merge(const Dataspace& other)
+{
+  if (&other == this)
+  {
+    std::unique_ptr<Dataspace> copy(other.clone());
+    merge(*copy);
+    return;
+  }
+
+  check_merge(other);
+  if (other.empty())
+    return;
+  // data_merge marks the bins it changes with the new version
+  touch();
+  this->data_merge(other);
+  this->recalc_axes();
+}
+
+void Dataspace::data_merge(const Dataspace& other)
+{
+  auto entries = other.range({});
+  if (!entries)
+    return;
+  for (const auto& e : *entries)
+    if (e.second != 0)
+      this->add(e);
+}
+
+void Dataspace::export_csv(std::ostream& os) const
+{
+  if (this->empty())
+    return;
+  DataBlock block;
+  this->read_range(block);
+  block.write_csv(os);
+}
+
 DataAxis Dataspace::axis(uint16_t dimension) const
 {
   if (dimension < axes_.size())
@@ -147,6 +477,7 @@ void Dataspace::load(const hdf5::node::Group& g)
     }
 
     this->data_load(node::Group(dgroup["data"]));
+    touch_all();
   }
   catch (...)
   {
@@ -217,4 +548,14 @@ PreciseFloat Dataspace::total_count() const
   return total_count_;
 }
 
+std::string Dataspace::representation() const
+{
+  return "";
+}
+
+size_t Dataspace::memory_footprint() const
+{
+  return 0;
+}
+
 }
@@ -16,8 +16,93 @@ using Entry = std::pair<Coords, PreciseFloat>;
 using EntryList_t = std::vector<Entry>;
 using EntryList = std::shared_ptr<EntryList_t>;
 
+/// \brief bins of a dataspace range in flat arrays owned by the caller
+///
+/// Dense blocks hold every bin of the box origin..origin+shape-1, row-major
+/// (last dimension contiguous). Sparse blocks hold one coordinate column per
+/// dimension, parallel to counts, in no particular order. Resetting keeps
+/// allocated storage, so a block reused across refreshes stops allocating.
+class DataBlock
+{
+  public:
+    enum class Layout { sparse, dense };
+
+    Layout layout {Layout::sparse};
+    Coords origin;
+    Coords shape;
+    std::vector<std::vector<size_t>> coords;
+    std::vector<double> counts;
+
+    void reset_sparse(size_t dimensions);
+    //all bins zero
+    void reset_dense(const Coords& origin, const Coords& shape);
+
+    inline size_t dimensions() const
+    {
+      return (layout == Layout::dense) ? shape.size() : coords.size();
+    }
+
+    inline size_t size() const { return counts.size(); }
+    inline bool empty() const { return counts.empty(); }
+
+    inline void push(size_t x, double count)
+    {
+      coords[0].push_back(x);
+      counts.push_back(count);
+    }
+
+    inline void push(size_t x, size_t y, double count)
+    {
+      coords[0].push_back(x);
+      coords[1].push_back(y);
+      counts.push_back(count);
+    }
+
+    void push(const Coords& c, double count);
+
+    //visits (coords, count) of every bin held, zeros included if dense
+    template <typename Visitor>
+    void for_each(Visitor visit) const;
+
+    //converts sparse into dense, from all-zero coords to the largest ones
+    void densify();
+
+    //last dimension comma-separated, one row per line if more than one
+    void write_csv(std::ostream&) const;
+};
+
+template <typename Visitor>
+void DataBlock::for_each(Visitor visit) const
+{
+  Coords c(dimensions());
+  if (layout == Layout::sparse)
+  {
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+      for (size_t d = 0; d < c.size(); ++d)
+        c[d] = coords[d][i];
+      visit(c, counts[i]);
+    }
+    return;
+  }
+
+  c = origin;
+  for (size_t i = 0; i < counts.size(); ++i)
+  {
+    visit(c, counts[i]);
+    // odometer over the box, last dimension fastest
+    for (size_t d = c.size(); d-- > 0;)
+    {
+      if (++c[d] < origin[d] + shape[d])
+        break;
+      c[d] = origin[d];
+    }
+  }
+}
+
 class Dataspace;
 using DataspacePtr = std::shared_ptr<Dataspace>;
+using DataspaceConstPtr = std::shared_ptr<const Dataspace>;
 
 struct DataAxis
 {
@@ -58,14 +143,50 @@ class Dataspace
     //optimized retrieval of bulk data as list of Entries
     virtual EntryList range(std::vector<Pair> ranges = {}) const = 0;
     EntryList all_data() const;
+    //bulk retrieval into caller-provided columns, ranges as for range()
+    virtual void read_range(DataBlock& block, std::vector<Pair> ranges = {}) const;
+    void read_all(DataBlock& block) const;
+
+    //incremented by every modification, carried over by clone()
+    uint64_t version() const;
+    //version of the last change to all bins at once (e.g. clear or load)
+    uint64_t cleared_version() const;
+    //whether range_since narrows changes down at all,
+    //rather than reporting all bins whenever anything changed
+    virtual bool tracks_changes() const { return false; }
+    //bins modified after version since, returns false if changes cannot be
+    //narrowed down (e.g. after clear), block then holds all bins instead
+    virtual bool range_since(DataBlock& block, uint64_t since) const;
+    //brings this copy of source up to date in the bins listed in changes,
+    //as from source.range_since, and leaves it at the version of source
+    virtual void update_from(const Dataspace& source, const DataBlock& changes);
+    //as read_range, with bins merged 2^level to a side for zoomed-out views;
+    //block holds coarse coords (fine >> level), ranges stay in fine bins
+    virtual void read_level(DataBlock& block, uint16_t level,
+                            std::vector<Pair> ranges = {}) const;
+    //whether read_level is served from cached coarse levels, rather than
+    //aggregating a full-resolution read each time as the default does
+    virtual bool has_levels() const { return false; }
 
     virtual void clear() = 0;
     virtual void reserve(const Coords &) {}
     virtual void add(const Entry &) = 0;
     virtual void add_one(const Coords &) = 0;
+    //bulk insertion, coords packed as consecutive tuples of dimensions_ each
+    void add_ones(const std::vector<size_t> &coords);
+    //as above, for the coords in [begin, end), e.g. a slice of a larger batch
+    virtual void add_ones(const size_t *begin, const size_t *end);
+    virtual void add_many(const std::vector<size_t> &coords,
+                          const std::vector<PreciseFloat> &counts);
+    //throws if other cannot be merged, i.e. dimensions or axis
+    //calibrations differ
+    void check_merge(const Dataspace &other) const;
+    //adds all counts of other, which must pass check_merge
+    void merge(const Dataspace &other);
     virtual void recalc_axes() = 0;
 
-    virtual void export_csv(std::ostream &) const = 0;
+    //1D and 2D through read_range, higher dimensions must override
+    virtual void export_csv(std::ostream &) const;
 
     void load(const hdf5::node::Group &);
     void save(const hdf5::node::Group &) const;
@@ -80,11 +201,26 @@ class Dataspace
 
     PreciseFloat total_count() const;
 
+    //storage currently backing the data, for diagnostics
+    virtual std::string representation() const;
+    virtual size_t memory_footprint() const;
+
   protected:
 
     PreciseFloat total_count_ {0};
 
+    uint64_t version_ {0};
+    uint64_t cleared_version_ {0};
+
+    //to be called by every modification
+    inline void touch() { version_++; }
+    //to be called when all bins may have changed at once
+    inline void touch_all() { cleared_version_ = ++version_; }
+
     virtual std::string data_debug(const std::string &prepend) const;
+    //adds other entry by entry, override for faster paths between same types;
+    //overrides must mark the bins they change, merge() has touched already
+    virtual void data_merge(const Dataspace &other);
     virtual void data_load(const hdf5::node::Group&) = 0;
     virtual void data_save(const hdf5::node::Group&) const = 0;
 };
@@ -23,6 +23,17 @@ Engine::Engine()
   e2.set_val("min", 1);
   setting_definitions_[e2.id()] = e2;
 
+  SettingMeta e3 {"ConsumerThreads", SettingType::integer, "Consumer dispatch threads"};
+  e3.set_val("min", 1);
+  e3.set_val("description", "Number of threads feeding each spill to consumers in parallel");
+  setting_definitions_[e3.id()] = e3;
+
+  SettingMeta e4 {"ConsumerBacklog", SettingType::integer, "Spills queued per consumer"};
+  e4.set_val("min", 0);
+  e4.set_val("description", "If non-zero, each consumer runs in its own thread and drops "
+                            "running spills once this many are waiting");
+  setting_definitions_[e4.id()] = e4;
+
 //  settings_ = default_settings();
 }
 
@@ -32,6 +43,8 @@ Setting Engine::default_settings()
   ret.branches.add(Setting::text("ProfileDescr", "(no description)"));
   ret.branches.add(SettingMeta("DropPackets", SettingType::menu));
   ret.branches.add(SettingMeta("MaxPackets", SettingType::integer));
+  ret.branches.add(SettingMeta("ConsumerThreads", SettingType::integer));
+  ret.branches.add(SettingMeta("ConsumerBacklog", SettingType::integer));
   return ret;
 }
 
@@ -157,6 +170,16 @@ void Engine::_read_settings_bulk()
       set.enrich(setting_definitions_);
       set.set_number(max_packets_);
     }
+    else if (set.id() == "ConsumerThreads")
+    {
+      set.enrich(setting_definitions_);
+      set.set_number(consumer_threads_);
+    }
+    else if (set.id() == "ConsumerBacklog")
+    {
+      set.enrich(setting_definitions_);
+      set.set_number(consumer_backlog_);
+    }
     else if (!setting_definitions_.count(set.id()))
     {
       std::string name = set.get_text();
@@ -181,6 +204,14 @@ void Engine::_write_settings_bulk()
     {
       max_packets_ = set.get_number();
     }
+    else if (set.id() == "ConsumerThreads")
+    {
+      consumer_threads_ = set.get_number();
+    }
+    else if (set.id() == "ConsumerBacklog")
+    {
+      consumer_backlog_ = set.get_number();
+    }
     else if (!setting_definitions_.count(set.id()))
     {
       std::string name = set.get_text();
@@ -291,6 +322,9 @@ void Engine::acquire(ProjectPtr project, Interruptor &interruptor, uint64_t time
   /// \brief central shared queue for Spills
   SpillMultiqueue parsed_queue(drop_packets_, max_packets_);
 
+  project->dispatch_threads(consumer_threads_);
+  project->consumer_backlog(consumer_backlog_);
+
   //INFO("Launching thread Engine::builder_naive");
   auto builder = std::thread(&Engine::builder_naive, this, &parsed_queue, project);
 
@@ -423,6 +457,18 @@ ListData Engine::acquire_list(Interruptor& interruptor, uint64_t timeout)
 //////STUFF BELOW SHOULD NOT BE USED DIRECTLY////////////
 //////ASSUME YOU KNOW WHAT YOU'RE DOING WITH THREADS/////
 
+static SpillPtr engine_spill(SpillMultiqueue * data_queue, Spill::Type type)
+{
+  auto spill = data_queue->pool().acquire("engine", type);
+  auto pool_stats = data_queue->pool().stats();
+  spill->stats.set(SpillStats::queue_size, data_queue->size());
+  spill->stats.set(SpillStats::dropped_spills, data_queue->dropped_spills());
+  spill->stats.set(SpillStats::dropped_events, data_queue->dropped_events());
+  spill->stats.set(SpillStats::pool_hit_rate, pool_stats.hit_rate());
+  spill->stats.set(SpillStats::pool_peak_outstanding, pool_stats.peak_outstanding);
+  return spill;
+}
+
 void Engine::builder_naive(SpillMultiqueue * data_queue,
                            ProjectPtr project)
 {
@@ -430,10 +476,7 @@ void Engine::builder_naive(SpillMultiqueue * data_queue,
   uint64_t presort_events(0), presort_cycles(0);
 
   SpillPtr spill;
-  spill = std::make_shared<Spill>("engine", Spill::Type::start);
-  spill->state.branches.add_a(Setting::integer("queue_size", data_queue->size()));
-  spill->state.branches.add_a(Setting::integer("dropped_spills", data_queue->dropped_spills()));
-  spill->state.branches.add_a(Setting::integer("dropped_events", data_queue->dropped_events()));
+  spill = engine_spill(data_queue, Spill::Type::start);
   project->add_spill(spill);
 
   while (true)
@@ -444,22 +487,16 @@ void Engine::builder_naive(SpillMultiqueue * data_queue,
     //INFO("Got a spill with {} events", spill->events.size());
     Timer presort_timer(true);
     presort_cycles++; /// \todo unused currently
-    presort_events += spill->events.size();
+    presort_events += spill->event_count();
     project->add_spill(spill); /// \todo why add another thread for this?
 
-    spill = std::make_shared<Spill>("engine", Spill::Type::running);
-    spill->state.branches.add_a(Setting::integer("queue_size", data_queue->size()));
-    spill->state.branches.add_a(Setting::integer("dropped_spills", data_queue->dropped_spills()));
-    spill->state.branches.add_a(Setting::integer("dropped_events", data_queue->dropped_events()));
+    spill = engine_spill(data_queue, Spill::Type::running);
     project->add_spill(spill);
 
     time += presort_timer.s();
   }
 
-  spill = std::make_shared<Spill>("engine", Spill::Type::stop);
-  spill->state.branches.add_a(Setting::integer("queue_size", data_queue->size()));
-  spill->state.branches.add_a(Setting::integer("dropped_spills", data_queue->dropped_spills()));
-  spill->state.branches.add_a(Setting::integer("dropped_events", data_queue->dropped_events()));
+  spill = engine_spill(data_queue, Spill::Type::stop);
   project->add_spill(spill);
 
   Timer presort_timer(true);
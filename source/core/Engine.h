@@ -58,6 +58,8 @@ class Engine
     // {SettingMeta("Engine", SettingType::stem)};
     int drop_packets_{0};
     size_t max_packets_{100};
+    size_t consumer_threads_{1};
+    size_t consumer_backlog_{0};
 
     std::map<std::string, SettingMeta> setting_definitions_;
 
@@ -13,6 +13,8 @@
 
 namespace DAQuiri {
 
+class EventView;
+
 class Event
 {
 private:
@@ -35,6 +37,9 @@ public:
     }
   }
 
+  /// \brief deep copy of an event stored in an EventBuffer
+  explicit Event(const EventView& view);
+
   //Accessors
   inline uint64_t timestamp() const
   {
@@ -0,0 +1,110 @@
+#include <core/EventBuffer.h>
+
+namespace DAQuiri {
+
+Event::Event(const EventView& view)
+    : timestamp_(view.timestamp())
+{
+  values_.resize(view.value_count());
+  for (size_t i = 0; i < values_.size(); ++i)
+    values_[i] = view.value(i);
+  for (size_t i = 0; i < view.trace_count(); ++i)
+  {
+    auto t = view.trace(i);
+    traces_.push_back(std::vector<uint32_t>(t.begin(), t.end()));
+  }
+}
+
+void EventBuffer::reserve(size_t s, const Event& e)
+{
+  std::vector<size_t> trace_sizes;
+  for (size_t i = 0; i < e.trace_count(); ++i)
+    trace_sizes.push_back(e.trace(i).size());
+  set_layout(e.value_count(), trace_sizes);
+  grow(s);
+
+  for (size_t i = size_; i < s; ++i)
+  {
+    timestamps_[i] = e.timestamp();
+    for (size_t j = 0; j < value_count_; ++j)
+      values_[j * capacity_ + i] = e.value(j);
+    auto dest = traces_.begin() + i * trace_stride();
+    for (size_t j = 0; j < trace_sizes.size(); ++j)
+    {
+      const auto& t = e.trace(j);
+      std::copy(t.begin(), t.end(), dest + trace_offsets_[j]);
+    }
+  }
+  size_ = s;
+}
+
+void EventBuffer::reserve(size_t s, const EventModel& model)
+{
+  std::vector<size_t> trace_sizes;
+  for (const auto& dims : model.traces)
+  {
+    size_t product = 1;
+    for (auto d : dims)
+      product *= d;
+    trace_sizes.push_back(product);
+  }
+  set_layout(model.values.size(), trace_sizes);
+  grow(s);
+
+  if (s > size_)
+  {
+    for (size_t j = 0; j < value_count_; ++j)
+      std::fill(values_.begin() + j * capacity_ + size_,
+                values_.begin() + j * capacity_ + s, model.values[j]);
+    std::fill(timestamps_.begin() + size_, timestamps_.begin() + s, 0);
+    std::fill(traces_.begin() + size_ * trace_stride(),
+              traces_.begin() + s * trace_stride(), 0);
+  }
+  size_ = s;
+}
+
+void EventBuffer::set_layout(size_t value_count,
+                             const std::vector<size_t>& trace_sizes)
+{
+  std::vector<size_t> offsets{0};
+  for (auto s : trace_sizes)
+    offsets.push_back(offsets.back() + s);
+
+  if ((value_count == value_count_) && (offsets == trace_offsets_))
+    return;
+
+  // events of a different shape cannot share columns, start over
+  value_count_ = value_count;
+  trace_offsets_ = offsets;
+  timestamps_.clear();
+  values_.clear();
+  traces_.clear();
+  capacity_ = 0;
+  size_ = 0;
+  idx_ = 0;
+}
+
+void EventBuffer::grow(size_t s)
+{
+  if (s <= capacity_)
+    return;
+  // spills filled message by message must not reallocate for each
+  if (capacity_)
+    s = std::max(s, capacity_ * 2);
+
+  if (value_count_)
+  {
+    std::vector<uint32_t> values(value_count_ * s, 0);
+    for (size_t j = 0; j < value_count_; ++j)
+      std::copy(values_.begin() + j * capacity_,
+                values_.begin() + j * capacity_ + size_,
+                values.begin() + j * s);
+    values_ = std::move(values);
+  }
+
+  timestamps_.resize(s);
+  traces_.resize(s * trace_stride());
+  capacity_ = s;
+}
+
+}
@@ -0,0 +1,294 @@
+/* Copyright (C) 2016-2020 European Spallation Source, ERIC. See LICENSE file */
+//===----------------------------------------------------------------------===//
+///
+/// \file EventBuffer.h
+///
+/// \brief columnar (structure-of-arrays) storage for the events of a spill
+///
+/// Timestamps live in one contiguous array, each value has its own contiguous
+/// column and all trace samples share a single arena. Individual events are
+/// accessed through lightweight views that expose the same accessors as Event.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <core/Event.h>
+#include <algorithm>
+#include <iterator>
+
+namespace DAQuiri {
+
+/// \brief non-owning window onto the samples of one trace
+template<typename T>
+class TraceSpan
+{
+ public:
+  TraceSpan() {}
+  TraceSpan(T* data, size_t size) : data_(data), size_(size) {}
+
+  inline size_t size() const { return size_; }
+  inline bool empty() const { return (size_ == 0); }
+  inline T* data() const { return data_; }
+  inline T& operator[](size_t i) const { return data_[i]; }
+  inline T* begin() const { return data_; }
+  inline T* end() const { return data_ + size_; }
+
+ private:
+  T* data_{nullptr};
+  size_t size_{0};
+};
+
+/// \brief read-only view of one event stored in an EventBuffer
+class EventView
+{
+ public:
+  EventView(const uint64_t* time,
+            const uint32_t* values, size_t value_stride, size_t value_count,
+            const uint32_t* traces, const std::vector<size_t>* trace_offsets)
+      : time_(time), values_(values)
+      , value_stride_(value_stride), value_count_(value_count)
+      , traces_(traces), trace_offsets_(trace_offsets) {}
+
+  //Accessors
+  inline uint64_t timestamp() const
+  {
+    return *time_;
+  }
+
+  inline size_t value_count() const
+  {
+    return value_count_;
+  }
+
+  inline size_t trace_count() const
+  {
+    return trace_offsets_->size() - 1;
+  }
+
+  inline uint32_t value(size_t idx) const
+  {
+    return values_[idx * value_stride_];
+  }
+
+  inline TraceSpan<const uint32_t> trace(size_t idx) const
+  {
+    if (idx >= trace_count())
+      throw std::out_of_range("EventView: bad trace index");
+    const auto& o = *trace_offsets_;
+    return TraceSpan<const uint32_t>(traces_ + o[idx], o[idx + 1] - o[idx]);
+  }
+
+  inline std::string debug() const
+  {
+    return Event(*this).debug();
+  }
+
+ private:
+  const uint64_t* time_;
+  const uint32_t* values_;
+  size_t value_stride_;
+  size_t value_count_;
+  const uint32_t* traces_;
+  const std::vector<size_t>* trace_offsets_;
+};
+
+/// \brief writable handle to one event slot of an EventBuffer
+class EventRef
+{
+ public:
+  EventRef(uint64_t* time,
+           uint32_t* values, size_t value_stride, size_t value_count,
+           uint32_t* traces, const std::vector<size_t>* trace_offsets)
+      : time_(time), values_(values)
+      , value_stride_(value_stride), value_count_(value_count)
+      , traces_(traces), trace_offsets_(trace_offsets) {}
+
+  inline operator EventView() const
+  {
+    return EventView(time_, values_, value_stride_, value_count_,
+                     traces_, trace_offsets_);
+  }
+
+  //Accessors
+  inline uint64_t timestamp() const
+  {
+    return *time_;
+  }
+
+  inline size_t value_count() const
+  {
+    return value_count_;
+  }
+
+  inline size_t trace_count() const
+  {
+    return trace_offsets_->size() - 1;
+  }
+
+  inline uint32_t value(size_t idx) const
+  {
+    return values_[idx * value_stride_];
+  }
+
+  inline TraceSpan<uint32_t> trace(size_t idx)
+  {
+    if (idx >= trace_count())
+      throw std::out_of_range("EventRef: bad trace index");
+    const auto& o = *trace_offsets_;
+    return TraceSpan<uint32_t>(traces_ + o[idx], o[idx + 1] - o[idx]);
+  }
+
+  //Setters
+  inline void set_time(uint64_t t)
+  {
+    *time_ = t;
+  }
+
+  inline void set_value(size_t idx, uint32_t val)
+  {
+    values_[idx * value_stride_] = val;
+  }
+
+  /// \brief copies contents of event into this slot
+  ///         (values and traces beyond the slot's layout are ignored)
+  inline void assign(const Event& event)
+  {
+    *time_ = event.timestamp();
+    for (size_t i = 0; i < std::min(value_count_, event.value_count()); ++i)
+      set_value(i, event.value(i));
+    for (size_t i = 0; i < std::min(trace_count(), event.trace_count()); ++i)
+    {
+      auto dest = trace(i);
+      const auto& src = event.trace(i);
+      std::copy(src.begin(), src.begin() + std::min(src.size(), dest.size()),
+                dest.begin());
+    }
+  }
+
+ private:
+  uint64_t* time_;
+  uint32_t* values_;
+  size_t value_stride_;
+  size_t value_count_;
+  uint32_t* traces_;
+  const std::vector<size_t>* trace_offsets_;
+};
+
+class EventBuffer
+{
+ public:
+  class const_iterator
+  {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = EventView;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = EventView;
+
+    const_iterator(const EventBuffer* buffer, size_t i)
+        : buffer_(buffer), i_(i) {}
+
+    inline EventView operator*() const { return (*buffer_)[i_]; }
+    inline const_iterator& operator++()
+    {
+      ++i_;
+      return *this;
+    }
+    inline const_iterator operator++(int)
+    {
+      auto ret = *this;
+      ++i_;
+      return ret;
+    }
+    inline bool operator==(const const_iterator& other) const
+    {
+      return (i_ == other.i_) && (buffer_ == other.buffer_);
+    }
+    inline bool operator!=(const const_iterator& other) const
+    {
+      return !operator==(other);
+    }
+
+   private:
+    const EventBuffer* buffer_;
+    size_t i_;
+  };
+
+  EventBuffer() {}
+
+  inline size_t size() const { return size_; }
+  inline bool empty() const { return (size_ == 0); }
+
+  /// \brief resizes buffer to s event slots, new slots are initialized
+  ///         with values and traces of prototype event e
+  void reserve(size_t s, const Event& e);
+
+  /// \brief resizes buffer to s event slots, new slots are zero-initialized
+  ///         according to model, without constructing a prototype event
+  void reserve(size_t s, const EventModel& model);
+
+  inline EventRef last()
+  {
+    return EventRef(&timestamps_[idx_],
+                    values_.data() + idx_, capacity_, value_count_,
+                    traces_.data() + idx_ * trace_stride(), &trace_offsets_);
+  }
+
+  inline EventBuffer& operator++()
+  {
+    idx_++;
+    return *this;
+  }
+  inline EventBuffer operator++(int)
+  {
+    idx_++;
+    return *this;
+  }
+
+  inline void finalize() { size_ = idx_; }
+
+  /// \brief forgets all events but keeps layout and allocated storage
+  inline void clear()
+  {
+    size_ = 0;
+    idx_ = 0;
+  }
+
+  inline EventView operator[](size_t i) const
+  {
+    return EventView(&timestamps_[i],
+                     values_.data() + i, capacity_, value_count_,
+                     traces_.data() + i * trace_stride(), &trace_offsets_);
+  }
+
+  inline const_iterator begin() const { return const_iterator(this, 0); }
+  inline const_iterator end() const { return const_iterator(this, size_); }
+
+  /// \brief contiguous columns, each valid for [0, size())
+  inline const uint64_t* timestamps() const { return timestamps_.data(); }
+  inline const uint32_t* values(size_t idx) const
+  {
+    return values_.data() + idx * capacity_;
+  }
+  inline size_t value_count() const { return value_count_; }
+  inline size_t trace_count() const { return trace_offsets_.size() - 1; }
+
+ private:
+  std::vector<uint64_t> timestamps_;
+  std::vector<uint32_t> values_; ///< one column of capacity_ per value
+  std::vector<uint32_t> traces_; ///< trace_stride() samples per event
+  std::vector<size_t> trace_offsets_{0}; ///< per-event sample offsets of traces
+
+  size_t value_count_{0};
+  size_t capacity_{0};
+  size_t size_{0};
+  size_t idx_{0};
+
+  inline size_t trace_stride() const { return trace_offsets_.back(); }
+
+  void set_layout(size_t value_count, const std::vector<size_t>& trace_sizes);
+  void grow(size_t s);
+};
+
+}
@@ -0,0 +1,40 @@
+#include <core/EventColumns.h>
+
+namespace DAQuiri {
+
+EventColumns::EventColumns(std::shared_ptr<const void> owner,
+                           const uint32_t* times, const uint32_t* ids, size_t size,
+                           uint64_t time_offset, Decoder decoder,
+                           Validator validator)
+    : owner_(std::move(owner))
+    , times_(times), ids_(ids), size_(size)
+    , time_offset_(time_offset)
+    , decoder_(std::move(decoder))
+    , validator_(std::move(validator))
+{}
+
+const EventBuffer& EventColumns::events(const EventModel& model) const
+{
+  if (decoded())
+    return events_;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (decoded_.load(std::memory_order_relaxed))
+    return events_;
+
+  events_.reserve(size_, model);
+  for (size_t i = 0; i < size_; ++i)
+  {
+    auto evt = events_.last();
+    if (decoder_ && !decoder_(evt, ids_[i]))
+      continue;
+    evt.set_time(timestamp(i));
+    ++events_;
+  }
+  events_.finalize();
+
+  decoded_.store(true, std::memory_order_release);
+  return events_;
+}
+
+}
@@ -0,0 +1,96 @@
+/* Copyright (C) 2016-2020 European Spallation Source, ERIC. See LICENSE file */
+//===----------------------------------------------------------------------===//
+///
+/// \file EventColumns.h
+///
+/// \brief events left in the buffer they arrived in
+///
+/// Holds on to a received message (e.g. a Kafka flatbuffer) and exposes its
+/// time and id arrays directly. Consumers that only need timestamps or ids
+/// read the columns; the first consumer asking for full events has them
+/// decoded once into an EventBuffer, which is then shared by everyone else.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <core/EventBuffer.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace DAQuiri {
+
+class EventColumns
+{
+ public:
+  /// \brief fills in values of one event from its id,
+  ///         returns false if the event should be skipped
+  using Decoder = std::function<bool(EventRef&, uint32_t)>;
+
+  /// \brief tells whether the decoder would keep an event with this id,
+  ///         without decoding it
+  using Validator = std::function<bool(uint32_t)>;
+
+  /// \param owner keeps the memory behind times and ids alive
+  /// \param times per-event times, relative to time_offset
+  /// \param ids per-event ids (e.g. pixel ids)
+  EventColumns(std::shared_ptr<const void> owner,
+               const uint32_t* times, const uint32_t* ids, size_t size,
+               uint64_t time_offset, Decoder decoder,
+               Validator validator = nullptr);
+
+  EventColumns(const EventColumns&) = delete;
+  EventColumns& operator=(const EventColumns&) = delete;
+
+  inline size_t size() const { return size_; }
+  inline bool empty() const { return (size_ == 0); }
+
+  inline uint64_t time_offset() const { return time_offset_; }
+  inline const uint32_t* times() const { return times_; }
+  inline const uint32_t* ids() const { return ids_; }
+
+  inline uint64_t timestamp(size_t i) const
+  {
+    return time_offset_ + times_[i];
+  }
+
+  /// \brief false if the decoder may reject events and there is no
+  ///         validator to tell which, i.e. only decoding will do
+  inline bool validates() const
+  {
+    return (!decoder_ || validator_);
+  }
+
+  /// \brief whether event i survives decoding, assumes validates()
+  inline bool valid(size_t i) const
+  {
+    return (!validator_ || validator_(ids_[i]));
+  }
+
+  /// \brief decodes events according to model on first call,
+  ///         safe to call from several consumers at once
+  const EventBuffer& events(const EventModel& model) const;
+
+  inline bool decoded() const
+  {
+    return decoded_.load(std::memory_order_acquire);
+  }
+
+ private:
+  std::shared_ptr<const void> owner_;
+  const uint32_t* times_ {nullptr};
+  const uint32_t* ids_ {nullptr};
+  size_t size_ {0};
+  uint64_t time_offset_ {0};
+  Decoder decoder_;
+  Validator validator_;
+
+  mutable std::mutex mutex_;
+  mutable std::atomic<bool> decoded_ {false};
+  mutable EventBuffer events_;
+};
+
+using EventColumnsPtr = std::shared_ptr<const EventColumns>;
+
+}
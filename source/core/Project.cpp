@@ -23,6 +23,80 @@ Project::Project(const Project& other)
 }
 
 
+void Project::dispatch_threads(size_t threads)
+{
+  UNIQUE_LOCK_EVENTUALLY
+  if (threads == dispatch_threads())
+    return;
+  if (threads > 1)
+    pool_ = std::make_unique<ThreadPool>(threads);
+  else
+    pool_.reset();
+}
+
+size_t Project::dispatch_threads() const
+{
+  return pool_ ? pool_->size() : 1;
+}
+
+void Project::consumer_backlog(size_t backlog)
+{
+  UNIQUE_LOCK_EVENTUALLY
+  if (backlog == consumer_backlog_)
+    return;
+  for (auto& w : workers_)
+    w.second->drain();
+  workers_.clear();
+  consumer_backlog_ = backlog;
+  routes_dirty_ = true;
+}
+
+size_t Project::consumer_backlog() const
+{
+  UNIQUE_LOCK_EVENTUALLY
+  return consumer_backlog_;
+}
+
+void Project::_rebuild_routes()
+{
+  //private, no lock needed
+  routes_epoch_ = _subscription_epoch();
+  routes_.clear();
+  for (auto& q : consumers_)
+    for (const auto& stream : q->streams())
+      routes_[stream].push_back(q);
+  routes_dirty_ = false;
+
+  if (consumer_backlog_)
+    _sync_workers();
+}
+
+uint64_t Project::_subscription_epoch() const
+{
+  //private, no lock needed
+  // consumers only ever count up, so the sum changes with any of them
+  uint64_t ret {0};
+  for (auto& q : consumers_)
+    ret += q->subscription_version();
+  return ret;
+}
+
+void Project::_sync_workers()
+{
+  //private, no lock needed
+  std::map<Consumer*, std::unique_ptr<ConsumerWorker>> workers;
+  for (auto& q : consumers_)
+  {
+    auto it = workers_.find(q.get());
+    if (it != workers_.end())
+      workers[q.get()] = std::move(it->second);
+    else
+      workers[q.get()] = std::make_unique<ConsumerWorker>(q, consumer_backlog_);
+  }
+  // workers of consumers no longer in project are discarded here
+  workers_ = std::move(workers);
+}
+
 void Project::save_spills(bool ss)
 {
   UNIQUE_LOCK_EVENTUALLY
@@ -55,7 +129,9 @@ void Project::_clear()
       || !spills_.empty())
     changed_ = true;
 
+  workers_.clear();
   consumers_.clear();
+  routes_dirty_ = true;
   spills_.clear();
   has_data_ = false;
 }
@@ -64,6 +140,9 @@ void Project::flush()
 {
   UNIQUE_LOCK_EVENTUALLY
 
+  for (auto& w : workers_)
+    w.second->drain();
+
   if (!consumers_.empty())
     for (auto& q: consumers_)
       q->flush();
@@ -127,6 +206,8 @@ void Project::reset()
     q = ConsumerFactory::singleton().create_from_prototype(q->metadata().prototype());
 
   spills_.clear();
+  // consumers were replaced, routes and workers still point to the old ones
+  routes_dirty_ = true;
 
   changed_ = true;
   ready_ = true;
@@ -138,6 +219,7 @@ void Project::up(size_t i)
 {
   UNIQUE_LOCK_EVENTUALLY
   consumers_.up(i);
+  routes_dirty_ = true;
   changed_ = true;
   ready_ = true;
   // cond_.notify_one();
@@ -147,6 +229,7 @@ void Project::down(size_t i)
 {
   UNIQUE_LOCK_EVENTUALLY
   consumers_.down(i);
+  routes_dirty_ = true;
   changed_ = true;
   ready_ = true;
   // cond_.notify_one();
@@ -185,6 +268,7 @@ void Project::_add_consumer(ConsumerPtr consumer)
     return;
 
   consumers_.add_a(consumer);
+  routes_dirty_ = true;
   if (!consumer->data()->empty())
     has_data_ = true;
   changed_ = true;
@@ -197,6 +281,7 @@ void Project::replace(size_t idx, ConsumerPtr consumer)
   UNIQUE_LOCK_EVENTUALLY
 
   consumers_.replace(idx, consumer);
+  routes_dirty_ = true;
   if (!consumer->data()->empty())
     has_data_ = true;
 
@@ -214,6 +299,7 @@ void Project::delete_consumer(size_t idx)
     return;
 
   consumers_.remove(idx);
+  routes_dirty_ = true;
   changed_ = true;
   ready_ = true;
   // cond_.notify_one();
@@ -224,16 +310,53 @@ void Project::add_spill(SpillPtr one_spill)
   UNIQUE_LOCK_EVENTUALLY
 
   //INFO("<Project> add_spill()");
-  for (auto& q: consumers_) {
-    //INFO("consumer {} push_spill()", q->type());
-    q->push_spill(*one_spill);
+  if (routes_dirty_ || (routes_epoch_ != _subscription_epoch()))
+    _rebuild_routes();
+
+  auto route = routes_.find(one_spill->stream_id);
+  if (route != routes_.end())
+  {
+    const auto& targets = route->second;
+    if (consumer_backlog_)
+    {
+      for (auto& q : targets)
+      {
+        auto w = workers_.find(q.get());
+        if (w != workers_.end())
+          w->second->enqueue(one_spill);
+        else
+          q->push_spill(*one_spill); // no worker yet, feed it directly
+      }
+    }
+    else if (pool_)
+    {
+      // consumers are independent of each other, each one still sees
+      // spills in order because this returns only once all are done
+      const Spill& spill = *one_spill;
+      pool_->parallel_for(targets.size(),
+                          [&targets, &spill](size_t i)
+                          {
+                            targets[i]->push_spill(spill);
+                          });
+    }
+    else
+    {
+      for (auto& q : targets) {
+        //INFO("consumer {} push_spill()", q->type());
+        q->push_spill(*one_spill);
+      }
+    }
   }
 
   if (save_spills_)
   {
-    one_spill->raw.clear();
-    one_spill->events = EventBuffer();
-    spills_.push_back(*one_spill);
+    // keep only metadata, spill itself may still be shared with others
+    Spill stripped(one_spill->stream_id, one_spill->type);
+    stripped.time = one_spill->time;
+    stripped.state = one_spill->state;
+    stripped.stats = one_spill->stats;
+    stripped.event_model = one_spill->event_model;
+    spills_.push_back(stripped);
   }
 
   changed_ = true;
@@ -369,6 +492,31 @@ void Project::open(std::string file_name, bool with_consumers, bool with_full_co
   }
 }
 
+void Project::merge(std::string file_name)
+{
+  Project other;
+  other.open(file_name);
+  auto theirs = other.get_consumers();
+  auto their_spills = other.spills();
+
+  UNIQUE_LOCK_EVENTUALLY
+
+  if (theirs.size() != consumers_.size())
+    throw std::runtime_error("<Project> Cannot merge '" + file_name + "' with "
+                                 + std::to_string(theirs.size()) + " consumers into "
+                                 + std::to_string(consumers_.size()));
+
+  // all or nothing, so a mismatch further down leaves this project as it was
+  for (size_t i = 0; i < theirs.size(); ++i)
+    consumers_.get(i)->check_merge(*theirs.get(i));
+  for (size_t i = 0; i < theirs.size(); ++i)
+    consumers_.get(i)->merge(*theirs.get(i));
+  spills_.insert(spills_.end(), their_spills.begin(), their_spills.end());
+
+  has_data_ = has_data_ || other.has_data();
+  changed_ = true;
+}
+
 void Project::_save_metadata(std::string file_name)
 {
   //private, no lock needed
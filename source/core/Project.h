@@ -1,6 +1,8 @@
 #pragma once
 
 #include <core/Consumer.h>
+#include <core/ConsumerWorker.h>
+#include <core/ThreadPool.h>
 #include <condition_variable>
 
 namespace DAQuiri {
@@ -33,6 +35,15 @@ class Project
     void add_spill(SpillPtr one_spill); // feeds events to all consumers
     void flush();
 
+    // number of threads feeding a spill to the consumers, 1 = serial
+    void dispatch_threads(size_t);
+    size_t dispatch_threads() const;
+
+    // if non-zero, every consumer gets its own worker thread with
+    // a queue of this many spills, dispatch threads are then unused
+    void consumer_backlog(size_t);
+    size_t consumer_backlog() const;
+
     // consumers access
     void add_consumer(ConsumerPtr consumer);
     void replace(size_t idx, ConsumerPtr consumer);
@@ -53,6 +64,10 @@ class Project
     void open(std::string file_name,
               bool with_consumers = true,
               bool with_full_consumers = true);
+    // adds data from another project file to the consumer at the same
+    // position, consumers must match in number, type and axis calibrations,
+    // otherwise nothing is merged
+    void merge(std::string file_name);
 
 
 
@@ -70,6 +85,14 @@ class Project
     // data
     Container<ConsumerPtr> consumers_;
 
+    // dispatch
+    std::unique_ptr<ThreadPool> pool_;
+    std::map<std::string, std::vector<ConsumerPtr>> routes_; ///< by stream_id
+    bool routes_dirty_ {true};
+    uint64_t routes_epoch_ {0}; ///< _subscription_epoch() the routes are of
+    size_t consumer_backlog_ {0};
+    std::map<Consumer*, std::unique_ptr<ConsumerWorker>> workers_;
+
     // spills
     std::list<Spill> spills_;
     bool save_spills_ {false};
@@ -82,6 +105,10 @@ class Project
     void _clear();
     void _save_metadata(std::string file_name);
     void _add_consumer(ConsumerPtr consumer);
+    void _rebuild_routes();
+    // changes whenever a consumer of this project changes its subscriptions
+    uint64_t _subscription_epoch() const;
+    void _sync_workers();
 };
 
 }
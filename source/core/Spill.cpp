@@ -39,7 +39,46 @@ Spill::Spill(std::string id, Spill::Type t)
 
 bool Spill::empty()
 {
-  return (raw.empty() && events.empty() && !state);
+  return (raw.empty() && events.empty() && !columns && !state && stats.empty());
+}
+
+const EventBuffer& Spill::event_buffer() const
+{
+  if (columns)
+    return columns->events(event_model);
+  return events;
+}
+
+size_t Spill::event_count() const
+{
+  if (columns)
+    return columns->size();
+  return events.size();
+}
+
+Setting Spill::full_state() const
+{
+  if (stats.empty())
+    return state;
+  Setting ret = state ? state : Setting::stem("stats");
+  stats.to_setting(ret);
+  return ret;
+}
+
+bool Spill::find_stat(SpillStats::Field field, PreciseFloat& value) const
+{
+  if (stats.has(field))
+  {
+    value = stats.get(field);
+    return true;
+  }
+  if (state.branches.empty())
+    return false;
+  auto s = state.find(Setting(SpillStats::name(field)));
+  if (!s || !s.numeric())
+    return false;
+  value = s.is(SettingType::precise) ? s.precise() : s.get_number();
+  return true;
 }
 
 std::string Spill::debug(std::string prepend) const
@@ -53,13 +92,14 @@ std::string Spill::debug(std::string prepend) const
   ss << prepend << k_branch_mid_B << "event model: "
      << event_model.debug() << "\n";
 
-  if (events.size())
-    ss << prepend << k_branch_mid_B << "event_count=" << events.size() << "\n";
+  if (event_count())
+    ss << prepend << k_branch_mid_B << "event_count=" << event_count()
+       << (columns ? " (undecoded)" : "") << "\n";
   if (raw.size())
     ss << prepend << k_branch_mid_B << "raw_size=" << (raw.size() * sizeof(char)) << "\n";
 
   ss << prepend << k_branch_end_B
-     << state.debug(prepend + "  ", false);
+     << full_state().debug(prepend + "  ", false);
 
   return ss.str();
 }
@@ -73,8 +113,9 @@ void to_json(json& j, const Spill& s)
 //  j["number_of_events"] = events.size();
   j["event_model"] = s.event_model;
 
-  if (s.state)
-    j["state"] = s.state;
+  auto state = s.full_state();
+  if (state)
+    j["state"] = state;
 }
 
 void from_json(const json& j, Spill& s)
@@ -85,7 +126,10 @@ void from_json(const json& j, Spill& s)
   s.event_model = j["event_model"];
 
   if (j.count("state"))
+  {
     s.state = j["state"];
+    s.stats.from_setting(s.state);
+  }
 }
 
 }
@@ -3,16 +3,16 @@
 ///
 /// \file Spill.h
 ///
-/// \brief key primitive (name?) - defines classes: Spill, EventBuffer
-///
-/// \todo split in multiple files?
+/// \brief key primitive (name?) - defines classes: Spill, StreamInfo
 ///
 //===----------------------------------------------------------------------===//
 #pragma once
 
 #include <core/plugin/Setting.h>
 #include <core/Detector.h>
-#include <core/Event.h>
+#include <core/EventBuffer.h>
+#include <core/EventColumns.h>
+#include <core/SpillStats.h>
 
 namespace DAQuiri
 {
@@ -30,38 +30,6 @@ struct StreamInfo
 
 using StreamManifest = std::map<std::string, StreamInfo>;
 
-class EventBuffer
-{
- public:
-  EventBuffer() {}
-
-  inline size_t size() const { return data_.size(); }
-  inline bool empty() const { return data_.empty(); }
-
-  inline void reserve(size_t s, const Event& e) { data_.resize(s, e); }
-  inline Event& last() { return data_[idx_]; }
-
-  inline EventBuffer& operator++()
-  {
-    idx_++;
-    return *this;
-  }
-  inline EventBuffer operator++(int)
-  {
-    idx_++;
-    return *this;
-  }
-
-  inline void finalize() { data_.resize(idx_); }
-
-  inline std::vector<Event>::const_iterator begin() const { return data_.begin(); }
-  inline std::vector<Event>::const_iterator end() const { return data_.end(); }
-
- private:
-  std::vector<Event> data_;
-  size_t idx_{0};
-};
-
 /// \brief contains EventBuffer
 /// \todo it is unclear what Spill signifies
 class Spill
@@ -79,14 +47,29 @@ class Spill
   Type type{Type::daq_status};
   hr_time_t time{std::chrono::system_clock::now()};
   Setting state; /// \todo confusing naming (see Engine.cpp)
+  SpillStats stats; ///< well-known clocks and counters, not part of state
 
   std::vector<char> raw; // raw from device
   EventModel event_model;
   EventBuffer events;
+  EventColumnsPtr columns; ///< if set, events are still in the received message
 
  public:
   bool empty();
+
+  /// \brief events, decoded from columns on first use if necessary
+  const EventBuffer& event_buffer() const;
+
+  /// \brief number of events, without decoding columns
+  size_t event_count() const;
   std::string debug(std::string prepend = "") const;
+
+  /// \brief state with stats merged in, for display and saving
+  Setting full_state() const;
+
+  /// \brief typed stat if present, otherwise a numeric state branch
+  ///         of the same name (for producers that do not fill stats)
+  bool find_stat(SpillStats::Field field, PreciseFloat& value) const;
 };
 
 void to_json(json& j, const Spill& s);
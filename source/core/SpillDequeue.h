@@ -3,18 +3,22 @@
 ///
 /// \file SpillDequeue.h
 ///
-/// \brief key primitives transferring data from consumers to gui (I think), SpillDequeue, SmartSpillDequeue, SpillMultiQueue
+/// \brief key primitives transferring data from producers to the engine, SpillDeque, SpillMultiqueue
 /// \todo split up into separate files?
 ///
 //===----------------------------------------------------------------------===//
 #pragma once
 
-#include <core/Spill.h>
+#include <core/SpillRing.h>
+#include <core/SpillPool.h>
 #include <deque>
 #include <condition_variable>
 #include <map>
 #include <mutex>
 #include <atomic>
+#include <chrono>
+#include <limits>
+#include <thread>
 
 #include <core/util/logger.h>
 
@@ -67,112 +71,137 @@ private:
   std::condition_variable cond_;
 };
 
-struct SmartSpillDeque
-{
-    // returns true if spill is dropped
-    bool push(const SpillPtr& s, bool drop, size_t max_buffers)
-    {
-      if (drop &&
-          (s->type == Spill::Type::running) &&
-          (recent_running_spills >= max_buffers))
-        return true;
-
-      if (s->type == Spill::Type::running)
-        recent_running_spills++;
-
-      if (earliest == hr_time_t())
-        earliest = s->time;
-
-      queue.push_back(s);
-
-      return false;
-    }
-
-    // Must be non-empty
-    SpillPtr pop()
-    {
-      SpillPtr f = queue.front();
-      queue.pop_front();
-
-      if (f->type == Spill::Type::running)
-        recent_running_spills--;
-
-      if (queue.size())
-        earliest = queue.front()->time;
-      else
-        earliest = hr_time_t();
-
-      return f;
-    }
-
-    size_t size() const
-    {
-      return queue.size();
-    }
-
-    bool empty() const
-    {
-      return queue.empty();
-    }
-
-    hr_time_t earliest;
-    std::deque<SpillPtr> queue;
-    size_t recent_running_spills {0};
-};
-
-
+/// \brief merges spills from any number of producer threads
+///
+/// Every (producer thread, stream) pair gets its own SpillRing (a lane), so
+/// enqueue never contends with other producers or with the consumer. Rings
+/// are registered under a mutex only the first time a thread enqueues to a
+/// stream. A single consumer thread dequeues.
+///
+/// Streams run on clocks of their own, so across streams spills come out
+/// by wall clock (Spill::time). Within a stream fed by several threads the
+/// lanes are merged on the spill timestamp, pulse_time or else native_time
+/// (see SpillStats): the start spill always comes first and the stop spill
+/// last, and a spill is held back until every other active lane of its
+/// stream has reported a later timestamp. A lane is active if it enqueued
+/// within the last hold period, and no spill is held longer than hold after
+/// its Spill::time, so an idle or stalled thread delays a stream by at most
+/// hold. Spills of a stream fed by one thread come out as enqueued.
+///
+/// If dropping is enabled, running spills of a stream are dropped while
+/// max_buffers of them are already queued. Other spills are never dropped.
+///
+/// Unlike the unbounded SpillDeque, each lane holds at most ring_capacity
+/// spills. A producer whose ring is full yields until the consumer makes
+/// room or stop() is called, so with dropping disabled a stalled consumer
+/// stalls its producers too. Size ring_capacity for the longest stall that
+/// must be absorbed without blocking acquisition.
 class SpillMultiqueue
 {
 public:
-  inline SpillMultiqueue(bool drop, size_t max_buffers)
+  inline SpillMultiqueue(bool drop, size_t max_buffers,
+                         size_t ring_capacity = 1024,
+                         std::chrono::milliseconds hold = std::chrono::milliseconds(100))
     : drop_(drop)
     , max_buffers_(max_buffers)
+    , ring_capacity_(std::max(ring_capacity, max_buffers + 1))
+    , hold_(hold)
+    , id_(next_id())
+    , pool_(SpillPool::create())
   {}
 
+  SpillMultiqueue(const SpillMultiqueue&) = delete;
+  SpillMultiqueue& operator=(const SpillMultiqueue&) = delete;
+
+  inline ~SpillMultiqueue()
+  {
+    Lane* l = lanes_.load();
+    while (l)
+    {
+      Lane* next = l->next;
+      delete l;
+      l = next;
+    }
+  }
+
   // will enqueue to appropriate stream
   inline void enqueue(const SpillPtr& data)
   {
-    std::unique_lock<std::mutex> lock(mutex_);
+    Lane* lane = lane_for(data->stream_id);
+    bool running = (data->type == Spill::Type::running);
+    if (data->type == Spill::Type::start)
+      lane->stream->stopped = false;
 
-    if (streams_[data->stream_id].push(data, drop_, max_buffers_))
+    if (running &&
+        (lane->stream->running.fetch_add(1) >= max_buffers_) && drop_)
     {
-      dropped_spills_ ++;
-      dropped_events_ += data->events.size();
+      drop(lane, data);
       return;
     }
-    accepted_events_ += data->events.size();
+
+    while (!lane->ring.push(data))
+    {
+      if (running && drop_)
+      {
+        drop(lane, data);
+        return;
+      }
+      if (stop_.load())
+        return;
+      std::this_thread::yield();
+    }
+    accepted_events_ += data->event_count();
+
+    // what this thread has reported so far, for the merge within the stream;
+    // the clock is only needed once other threads feed the stream too
+    double t;
+    if (timestamp(*data, t) && (t > lane->watermark.load(std::memory_order_relaxed)))
+      lane->watermark.store(t, std::memory_order_relaxed);
+    if (lane->stream->threads.load(std::memory_order_relaxed) > 1)
+      lane->pushed_at.store(steady_now(), std::memory_order_release);
+    if (data->type == Spill::Type::stop)
+      lane->stream->stopped = true;
 
     // only do this if enqeued properly
     size_++;
-    cond_.notify_one();
+    if (waiting_.load())
+      cond_.notify_one();
   }
 
   // return nullptr if terminating
   inline SpillPtr dequeue()
   {
-    std::unique_lock<std::mutex> lock(mutex_);
-
     // will not release if empty
-    while (!size_ && !stop_) {
-      cond_.wait(lock);
-    }
-
-    // this is the end...
-    if (stop_)
-      return nullptr;
-
-    // selecting earliest ensures chronological queue
-    SmartSpillDeque* earliest = &streams_[""];
-    for (auto& s : streams_)
+    size_t spins {0};
+    while (!stop_.load())
     {
-      if (!s.second.empty() &&
-          ((earliest->earliest == hr_time_t())
-          || (earliest->earliest > s.second.earliest)))
-        earliest = &s.second;
+      bool held {false};
+      if (size_.load())
+      {
+        SpillPtr ret = pop_next();
+        if (ret)
+          return ret;
+        // all queued spills wait for a thread that is behind
+        held = true;
+      }
+
+      if (!held && (++spins < 64))
+      {
+        std::this_thread::yield();
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(wait_mutex_);
+      waiting_ = true;
+      if (held)
+        cond_.wait_for(lock, std::chrono::milliseconds(1));
+      else
+        cond_.wait_for(lock, std::chrono::milliseconds(1),
+                       [this] { return size_.load() || stop_.load(); });
+      waiting_ = false;
     }
 
-    size_--;
-    return earliest->pop();
+    // this is the end...
+    return nullptr;
   }
 
   inline void stop()
@@ -201,12 +230,260 @@ public:
     return accepted_events_.load();
   }
 
+  /// \brief number of (producer thread, stream) rings registered so far
+  inline size_t lanes()
+  {
+    size_t count {0};
+    for (Lane* l = lanes_.load(std::memory_order_acquire); l; l = l->next)
+      count++;
+    return count;
+  }
+
+  /// \brief producers should take their spills from here
+  inline SpillPool& pool()
+  {
+    return *pool_;
+  }
+
 private:
-  std::mutex mutex_;
-  std::condition_variable cond_;
-  bool stop_ {false};
+  struct Lane;
 
-  std::map<std::string, SmartSpillDeque> streams_;
+  struct Stream
+  {
+    std::string id;
+    std::atomic<size_t> running {0}; // queued running spills, for drop policy
+    std::atomic<bool> stopped {false}; // stop spill enqueued, nothing to wait for
+    std::atomic<size_t> threads {0}; // lanes registered
+
+    // consumer side only
+    bool started {false};    ///< start spill dequeued
+    uint64_t pass {0};       ///< pop_next pass the fields below belong to
+    size_t lanes {0};
+    Lane* best {nullptr};    ///< lane with the next spill of the stream
+  };
+
+  struct Lane
+  {
+    Lane(Stream* s, size_t capacity) : stream(s), ring(capacity) {}
+    Stream* stream;
+    SpillRing ring;
+    /// latest timestamp enqueued
+    std::atomic<double> watermark {-std::numeric_limits<double>::infinity()};
+    /// steady clock of the last enqueue, in ns
+    std::atomic<int64_t> pushed_at {0};
+    Lane* next {nullptr};
+  };
+
+  /// lanes recently used by a thread, across all queues; ids are never
+  /// reused, so entries of destroyed queues are never matched again
+  struct LaneCache
+  {
+    struct Item
+    {
+      uint64_t queue_id;
+      std::string stream_id;
+      Lane* lane;
+    };
+    static constexpr size_t max_items {32};
+    std::deque<Item> items;
+  };
+
+  static inline int64_t steady_now()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  /// \returns false if the spill carries neither pulse_time nor native_time
+  static inline bool timestamp(const Spill& s, double& t)
+  {
+    if (s.stats.has(SpillStats::pulse_time))
+      t = to_double(s.stats.get(SpillStats::pulse_time));
+    else if (s.stats.has(SpillStats::native_time))
+      t = to_double(s.stats.get(SpillStats::native_time));
+    else
+      return false;
+    return true;
+  }
+
+  /// start first, stop last
+  static inline int rank(const Spill& s)
+  {
+    if (s.type == Spill::Type::start)
+      return 0;
+    if (s.type == Spill::Type::stop)
+      return 2;
+    return 1;
+  }
+
+  /// \brief order within a stream: rank, then untimed before timed spills,
+  ///         then timestamp, then wall clock
+  static inline bool precedes(const Spill& a, const Spill& b)
+  {
+    if (rank(a) != rank(b))
+      return rank(a) < rank(b);
+    double ta, tb;
+    bool has_a = timestamp(a, ta);
+    bool has_b = timestamp(b, tb);
+    if (has_a != has_b)
+      return !has_a;
+    if (has_a && (ta != tb))
+      return ta < tb;
+    return a.time < b.time;
+  }
+
+  /// \returns whether the next spill of the stream must wait for other lanes
+  inline bool held(const Stream& stream, const Spill& next) const
+  {
+    if ((stream.lanes < 2) || (rank(next) != 1) || stream.stopped.load() ||
+        ((std::chrono::system_clock::now() - next.time) >= hold_))
+      return false;
+
+    // the start may still be on its way from another thread
+    if (!stream.started)
+      return true;
+
+    double t;
+    if (!timestamp(next, t))
+      return false;
+
+    int64_t active_since = steady_now() -
+        std::chrono::duration_cast<std::chrono::nanoseconds>(hold_).count();
+    for (Lane* l = lanes_.load(std::memory_order_acquire); l; l = l->next)
+    {
+      // lanes with spills queued are at or past this one
+      if ((l->stream != &stream) || (l == stream.best) || l->ring.front())
+        continue;
+      if ((l->pushed_at.load(std::memory_order_acquire) > active_since) &&
+          (l->watermark.load(std::memory_order_relaxed) < t))
+        return true;
+    }
+    return false;
+  }
+
+  /// \returns the next spill to go out, nullptr if all are held
+  inline SpillPtr pop_next()
+  {
+    Lane* first = lanes_.load(std::memory_order_acquire);
+
+    // next spill of each stream
+    pass_++;
+    for (Lane* l = first; l; l = l->next)
+    {
+      Stream* s = l->stream;
+      if (s->pass != pass_)
+      {
+        s->pass = pass_;
+        s->lanes = 0;
+        s->best = nullptr;
+      }
+      s->lanes++;
+      Spill* f = l->ring.front();
+      if (!f)
+        continue;
+      if (!s->best || precedes(*f, *s->best->ring.front()))
+        s->best = l;
+    }
+
+    // earliest by wall clock among streams that are not held back
+    Lane* earliest {nullptr};
+    Spill* earliest_front {nullptr};
+    for (Lane* l = first; l; l = l->next)
+    {
+      Stream* s = l->stream;
+      if (s->best != l)
+        continue;
+      Spill* f = l->ring.front();
+      if (held(*s, *f))
+        continue;
+      if (!earliest_front ||
+          (f->time < earliest_front->time) ||
+          ((f->time == earliest_front->time) &&
+              (s->id < earliest->stream->id)))
+      {
+        earliest = l;
+        earliest_front = f;
+      }
+    }
+
+    if (!earliest)
+      return nullptr;
+
+    SpillPtr ret = earliest->ring.pop();
+    if (ret->type == Spill::Type::running)
+      earliest->stream->running--;
+    else if (ret->type == Spill::Type::start)
+      earliest->stream->started = true;
+    else if (ret->type == Spill::Type::stop)
+      earliest->stream->started = false;
+    size_--;
+    return ret;
+  }
+
+  inline void drop(Lane* lane, const SpillPtr& data)
+  {
+    lane->stream->running--;
+    dropped_spills_++;
+    dropped_events_ += data->event_count();
+  }
+
+  inline Lane* lane_for(const std::string& stream_id)
+  {
+    static thread_local LaneCache cache;
+    for (const auto& i : cache.items)
+      if ((i.queue_id == id_) && (i.stream_id == stream_id))
+        return i.lane;
+
+    Lane* lane = register_lane(stream_id);
+    if (cache.items.size() >= LaneCache::max_items)
+      cache.items.pop_front();
+    cache.items.push_back({id_, stream_id, lane});
+    return lane;
+  }
+
+  /// finds or creates the lane of the calling thread for a stream, so a
+  /// thread evicted from the cache or coming back gets its old lane again
+  inline Lane* register_lane(const std::string& stream_id)
+  {
+    std::unique_lock<std::mutex> lock(registry_mutex_);
+    auto& lane = lane_index_[{std::this_thread::get_id(), stream_id}];
+    if (lane)
+      return lane;
+
+    auto& stream = streams_[stream_id];
+    if (!stream)
+    {
+      stream = std::make_unique<Stream>();
+      stream->id = stream_id;
+    }
+    // lanes that fed the stream alone so far count as active from now on
+    int64_t now = steady_now();
+    for (Lane* l = lanes_.load(std::memory_order_relaxed); l; l = l->next)
+      if (l->stream == stream.get())
+        l->pushed_at.store(now, std::memory_order_release);
+    stream->threads++;
+    lane = new Lane(stream.get(), ring_capacity_);
+    lane->next = lanes_.load(std::memory_order_relaxed);
+    lanes_.store(lane, std::memory_order_release);
+    return lane;
+  }
+
+  static inline uint64_t next_id()
+  {
+    static std::atomic<uint64_t> counter {0};
+    return ++counter;
+  }
+
+  std::atomic<Lane*> lanes_ {nullptr};
+
+  std::mutex registry_mutex_;
+  std::map<std::string, std::unique_ptr<Stream>> streams_;
+  std::map<std::pair<std::thread::id, std::string>, Lane*> lane_index_;
+
+  std::mutex wait_mutex_;
+  std::condition_variable cond_;
+  std::atomic<bool> waiting_ {false};
+  std::atomic<bool> stop_ {false};
 
   std::atomic<size_t> size_ {0};
   std::atomic<size_t> dropped_spills_ {0};
@@ -215,6 +492,12 @@ private:
 
   bool drop_ {false};
   size_t max_buffers_ {10};
+  size_t ring_capacity_ {1024};
+  hr_duration_t hold_;
+  uint64_t id_ {0};
+  uint64_t pass_ {0};
+
+  SpillPoolPtr pool_;
 };
 
 
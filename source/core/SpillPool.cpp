@@ -0,0 +1,97 @@
+#include <core/SpillPool.h>
+
+namespace DAQuiri {
+
+SpillPoolPtr SpillPool::create(size_t max_idle)
+{
+  return SpillPoolPtr(new SpillPool(max_idle));
+}
+
+SpillPool::SpillPool(size_t max_idle)
+    : max_idle_(max_idle)
+{
+  idle_.reserve(max_idle_);
+}
+
+SpillPool::~SpillPool()
+{
+  for (auto s : idle_)
+    delete s;
+}
+
+SpillPtr SpillPool::acquire(const std::string& stream_id, Spill::Type type)
+{
+  Spill* spill {nullptr};
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stats_.acquired++;
+    stats_.outstanding++;
+    stats_.peak_outstanding = std::max(stats_.peak_outstanding, stats_.outstanding);
+    if (!idle_.empty())
+    {
+      spill = idle_.back();
+      idle_.pop_back();
+      stats_.reused++;
+    }
+  }
+
+  if (!spill)
+    spill = new Spill(stream_id, type);
+  else
+  {
+    // same state as a new Spill(stream_id, type), but keeps buffers
+    spill->stream_id = stream_id;
+    spill->type = type;
+    spill->time = std::chrono::system_clock::now();
+    if (type == Spill::Type::daq_status)
+      spill->state = Setting();
+    else if (spill->state.id() == "stats")
+      spill->state.branches.clear();
+    else
+      spill->state = Setting::stem("stats");
+    spill->stats.clear();
+    spill->raw.clear();
+    spill->event_model = EventModel();
+    spill->events.clear();
+    spill->columns.reset();
+  }
+
+  std::weak_ptr<SpillPool> pool = shared_from_this();
+  return SpillPtr(spill, [pool](Spill* s)
+  {
+    if (auto p = pool.lock())
+      p->release(s);
+    else
+      delete s;
+  });
+}
+
+void SpillPool::release(Spill* spill)
+{
+  // do not hold on to the message behind undecoded events while idle
+  spill->columns.reset();
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stats_.outstanding--;
+    if (idle_.size() < max_idle_)
+    {
+      idle_.push_back(spill);
+      return;
+    }
+  }
+  delete spill;
+}
+
+SpillPool::Stats SpillPool::stats() const
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+size_t SpillPool::idle() const
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  return idle_.size();
+}
+
+}
@@ -0,0 +1,64 @@
+/* Copyright (C) 2016-2020 European Spallation Source, ERIC. See LICENSE file */
+//===----------------------------------------------------------------------===//
+///
+/// \file SpillPool.h
+///
+/// \brief recycles spills and their event storage between producers and consumers
+///
+/// Spills handed out by acquire() find their way back into the pool once the
+/// last SpillPtr referring to them is released, keeping the capacity of their
+/// event buffers and raw data. A recycled spill is otherwise indistinguishable
+/// from a newly constructed one.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <core/Spill.h>
+#include <mutex>
+
+namespace DAQuiri {
+
+class SpillPool;
+
+using SpillPoolPtr = std::shared_ptr<SpillPool>;
+
+class SpillPool : public std::enable_shared_from_this<SpillPool>
+{
+ public:
+  struct Stats
+  {
+    uint64_t acquired {0};
+    uint64_t reused {0};
+    size_t outstanding {0};
+    size_t peak_outstanding {0};
+
+    inline double hit_rate() const
+    {
+      return acquired ? (double(reused) / double(acquired)) : 0.0;
+    }
+  };
+
+  /// \param max_idle spills kept for reuse, further returns are freed
+  static SpillPoolPtr create(size_t max_idle = 256);
+  ~SpillPool();
+
+  SpillPool(const SpillPool&) = delete;
+  SpillPool& operator=(const SpillPool&) = delete;
+
+  SpillPtr acquire(const std::string& stream_id, Spill::Type type);
+
+  Stats stats() const;
+  size_t idle() const;
+
+ private:
+  explicit SpillPool(size_t max_idle);
+
+  size_t max_idle_;
+  mutable std::mutex mutex_;
+  std::vector<Spill*> idle_;
+  Stats stats_;
+
+  void release(Spill* spill);
+};
+
+}
@@ -0,0 +1,97 @@
+/* Copyright (C) 2016-2020 European Spallation Source, ERIC. See LICENSE file */
+//===----------------------------------------------------------------------===//
+///
+/// \file SpillRing.h
+///
+/// \brief bounded single-producer/single-consumer ring of spills
+///
+/// Exactly one thread may push and exactly one (other) thread may peek/pop.
+/// No locks are taken, positions are exchanged through acquire/release atomics.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <core/Spill.h>
+#include <atomic>
+
+namespace DAQuiri {
+
+class SpillRing
+{
+ public:
+  /// capacity is rounded up to the next power of two
+  explicit SpillRing(size_t capacity)
+  {
+    size_t c = 2;
+    while (c < capacity)
+      c <<= 1;
+    slots_.resize(c);
+    mask_ = c - 1;
+  }
+
+  SpillRing(const SpillRing&) = delete;
+  SpillRing& operator=(const SpillRing&) = delete;
+
+  inline size_t capacity() const
+  {
+    return slots_.size();
+  }
+
+  /// producer side, returns false if ring is full
+  inline bool push(const SpillPtr& s)
+  {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if ((tail - cached_head_) > mask_)
+    {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if ((tail - cached_head_) > mask_)
+        return false;
+    }
+    slots_[tail & mask_] = s;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// consumer side, returns nullptr if ring is empty
+  inline Spill* front()
+  {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == cached_tail_)
+    {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head == cached_tail_)
+        return nullptr;
+    }
+    return slots_[head & mask_].get();
+  }
+
+  /// consumer side, must only be called after front() returned non-null
+  inline SpillPtr pop()
+  {
+    size_t head = head_.load(std::memory_order_relaxed);
+    SpillPtr ret = std::move(slots_[head & mask_]);
+    head_.store(head + 1, std::memory_order_release);
+    return ret;
+  }
+
+  /// approximate when called concurrently with push/pop
+  inline size_t size() const
+  {
+    return tail_.load(std::memory_order_acquire)
+        - head_.load(std::memory_order_acquire);
+  }
+
+ private:
+  std::vector<SpillPtr> slots_;
+  size_t mask_{1};
+
+  // consumer-owned
+  alignas(64) std::atomic<size_t> head_{0};
+  size_t cached_tail_{0};
+
+  // producer-owned
+  alignas(64) std::atomic<size_t> tail_{0};
+  size_t cached_head_{0};
+};
+
+}
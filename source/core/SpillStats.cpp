@@ -0,0 +1,67 @@
+#include <core/SpillStats.h>
+
+namespace DAQuiri {
+
+static const std::array<std::string, SpillStats::field_count> stat_names
+    {{
+         "native_time",
+         "live_time",
+         "live_trigger",
+         "pulse_time",
+         "dropped_buffers",
+         "queue_size",
+         "dropped_spills",
+         "dropped_events",
+         "pool_hit_rate",
+         "pool_peak_outstanding",
+         "out_of_range_pixels"
+     }};
+
+bool SpillStats::operator==(const SpillStats& other) const
+{
+  if (present_ != other.present_)
+    return false;
+  for (size_t i = 0; i < field_count; ++i)
+    if (has(Field(i)) && (values_[i] != other.values_[i]))
+      return false;
+  return true;
+}
+
+std::string SpillStats::name(Field f)
+{
+  if (f >= field_count)
+    return "";
+  return stat_names[f];
+}
+
+SpillStats::Field SpillStats::field(const std::string& name)
+{
+  for (size_t i = 0; i < field_count; ++i)
+    if (stat_names[i] == name)
+      return Field(i);
+  return field_count;
+}
+
+void SpillStats::to_setting(Setting& tree) const
+{
+  for (size_t i = 0; i < field_count; ++i)
+    if (has(Field(i)))
+      tree.branches.add_a(Setting::precise(stat_names[i], values_[i]));
+}
+
+void SpillStats::from_setting(Setting& tree)
+{
+  tree.branches.data().remove_if([this](const Setting& s)
+  {
+    auto f = field(s.id());
+    if ((f == field_count) || !s.numeric())
+      return false;
+    if (s.is(SettingType::precise))
+      set(f, s.precise());
+    else
+      set(f, s.get_number());
+    return true;
+  });
+}
+
+}
@@ -0,0 +1,77 @@
+/* Copyright (C) 2016-2020 European Spallation Source, ERIC. See LICENSE file */
+//===----------------------------------------------------------------------===//
+///
+/// \file SpillStats.h
+///
+/// \brief fixed set of well-known clocks and counters carried by a spill
+///
+/// These are filled by producers for every spill and read by consumers for
+/// every spill, so they are kept in plain typed slots instead of the state
+/// Setting tree. They are merged into a Setting tree only for display and
+/// saving (see Spill::full_state).
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <core/plugin/Setting.h>
+#include <array>
+
+namespace DAQuiri {
+
+class SpillStats
+{
+ public:
+  enum Field : uint8_t
+  {
+    native_time,
+    live_time,
+    live_trigger,
+    pulse_time,
+    dropped_buffers,
+    queue_size,
+    dropped_spills,
+    dropped_events,
+    pool_hit_rate,
+    pool_peak_outstanding,
+    out_of_range_pixels,
+    field_count
+  };
+
+  inline void set(Field f, PreciseFloat val)
+  {
+    values_[f] = val;
+    present_ |= (1u << f);
+  }
+
+  inline bool has(Field f) const
+  {
+    return (present_ & (1u << f));
+  }
+
+  /// \returns 0 if not present
+  inline PreciseFloat get(Field f) const
+  {
+    return has(f) ? values_[f] : PreciseFloat(0);
+  }
+
+  inline bool empty() const { return (present_ == 0); }
+  inline void clear() { present_ = 0; }
+
+  bool operator==(const SpillStats& other) const;
+
+  static std::string name(Field f);
+  /// \returns field_count if name is not a well-known stat
+  static Field field(const std::string& name);
+
+  /// \brief appends present stats to tree as precise settings
+  void to_setting(Setting& tree) const;
+
+  /// \brief moves branches of tree named like well-known stats into this
+  void from_setting(Setting& tree);
+
+ private:
+  std::array<PreciseFloat, field_count> values_ {};
+  uint16_t present_ {0};
+};
+
+}
@@ -0,0 +1,91 @@
+#include <core/ThreadPool.h>
+
+namespace DAQuiri {
+
+ThreadPool::ThreadPool(size_t threads)
+{
+  for (size_t i = 1; i < threads; ++i)
+    workers_.emplace_back(&ThreadPool::worker_run, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    terminate_ = true;
+  }
+  start_.notify_all();
+  for (auto& w : workers_)
+    w.join();
+}
+
+void ThreadPool::parallel_for(size_t count,
+                              const std::function<void(size_t)>& job)
+{
+  if (workers_.empty() || (count < 2))
+  {
+    for (size_t i = 0; i < count; ++i)
+      job(i);
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    job_ = &job;
+    count_ = count;
+    next_ = 0;
+    error_ = nullptr;
+    busy_ = workers_.size();
+    generation_++;
+  }
+  start_.notify_all();
+
+  run_jobs();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this] { return (busy_ == 0); });
+  job_ = nullptr;
+  if (error_)
+    std::rethrow_exception(error_);
+}
+
+void ThreadPool::worker_run()
+{
+  uint64_t seen {0};
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_.wait(lock, [this, seen] { return terminate_ || (generation_ != seen); });
+      if (terminate_)
+        return;
+      seen = generation_;
+    }
+
+    run_jobs();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (--busy_ == 0)
+      done_.notify_one();
+  }
+}
+
+void ThreadPool::run_jobs()
+{
+  size_t i;
+  while ((i = next_++) < count_)
+  {
+    try
+    {
+      (*job_)(i);
+    }
+    catch (...)
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (!error_)
+        error_ = std::current_exception();
+    }
+  }
+}
+
+}
@@ -0,0 +1,58 @@
+/* Copyright (C) 2016-2020 European Spallation Source, ERIC. See LICENSE file */
+//===----------------------------------------------------------------------===//
+///
+/// \file ThreadPool.h
+///
+/// \brief fixed set of worker threads for fork-join style fan-out
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DAQuiri {
+
+class ThreadPool
+{
+ public:
+  /// \param threads total concurrency, including the thread calling
+  ///        parallel_for, so threads - 1 workers are spawned
+  explicit ThreadPool(size_t threads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  size_t size() const { return workers_.size() + 1; }
+
+  /// \brief calls job(i) for every i in [0, count), distributed over the
+  ///        workers and the calling thread. Returns when all calls are done,
+  ///        rethrows the first exception thrown by any of them.
+  void parallel_for(size_t count, const std::function<void(size_t)>& job);
+
+ private:
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  bool terminate_ {false};
+  uint64_t generation_ {0};
+  size_t busy_ {0};
+
+  const std::function<void(size_t)>* job_ {nullptr};
+  size_t count_ {0};
+  std::atomic<size_t> next_ {0};
+  std::exception_ptr error_;
+
+  void worker_run();
+  void run_jobs();
+};
+
+}
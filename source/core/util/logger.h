@@ -12,6 +12,8 @@
 #include <string>
 
 #include <fmt/format.h>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <libgen.h>
 
@@ -28,6 +30,52 @@ void initLogger(const spdlog::level::level_enum& LoggingLevel,
                 std::ostream* gui_stream = nullptr);
 void closeLogger();
 
+/// \brief counts occurrences of a message, letting only the first few
+///        and then one summary per interval through to the log
+class RateLimit
+{
+ public:
+  RateLimit(uint64_t burst = 10, std::chrono::milliseconds interval
+      = std::chrono::seconds(10))
+      : burst_(burst), interval_(interval.count()) {}
+
+  /// \brief what to do with one occurrence
+  struct Verdict
+  {
+    bool log {false};         ///< whether to log this one
+    bool summary {false};     ///< past the burst, mention the suppressed
+    uint64_t suppressed {0};  ///< not logged since the last report
+  };
+
+  inline Verdict count()
+  {
+    if (++total_ <= burst_)
+      return {true, false, 0};
+
+    ++suppressed_;
+    int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t due = next_report_.load(std::memory_order_relaxed);
+    if ((now < due) ||
+        !next_report_.compare_exchange_strong(due, now + interval_))
+      return {};
+    // the first one past the burst only starts the clock
+    if (!due)
+      return {};
+    // this one is logged, so it is not among the suppressed
+    return {true, true, suppressed_.exchange(0) - 1};
+  }
+
+  inline uint64_t total() const { return total_.load(); }
+
+ private:
+  uint64_t burst_ {10};
+  int64_t interval_ {10000};
+  std::atomic<uint64_t> total_ {0};
+  std::atomic<uint64_t> suppressed_ {0};
+  std::atomic<int64_t> next_report_ {0};
+};
+
 }
 
 // Do not use directly use the defines below instead
@@ -42,3 +90,26 @@ void closeLogger();
 #define INFO(Format, ...) LOG(spdlog::level::info, Format, ##__VA_ARGS__)
 #define DBG(Format, ...) LOG(spdlog::level::debug, Format, ##__VA_ARGS__)
 #define TRC(Format, ...) LOG(spdlog::level::trace, Format, ##__VA_ARGS__)
+
+/// \brief logs through the given RateLimit, with the number suppressed
+/// since the last report once past its burst
+#define LOG_COUNTED(Limit, Severity, Format, ...)                             \
+  do {                                                                        \
+    auto verdict_ = (Limit).count();                                          \
+    if (verdict_.log && !verdict_.summary)                                    \
+      LOG(Severity, Format, ##__VA_ARGS__);                                   \
+    else if (verdict_.log)                                                    \
+      LOG(Severity, Format " ({} more suppressed)", ##__VA_ARGS__,            \
+          verdict_.suppressed);                                               \
+  } while (0)
+
+/// \brief for messages that may come once per event or message: logs the
+/// first few from each call site, then one per interval with a count
+#define LOG_LIMITED(Severity, Format, ...)                                    \
+  do {                                                                        \
+    static CustomLogger::RateLimit rate_limit_;                               \
+    LOG_COUNTED(rate_limit_, Severity, Format, ##__VA_ARGS__);                \
+  } while (0)
+
+#define ERR_LIMITED(Format, ...) LOG_LIMITED(spdlog::level::err, Format, ##__VA_ARGS__)
+#define WARN_LIMITED(Format, ...) LOG_LIMITED(spdlog::level::warn, Format, ##__VA_ARGS__)
@@ -46,7 +46,7 @@ void Consumer1D::update_data()
   plot_->clearPrimary();
 
   ConsumerMetadata md = consumer_->metadata();
-  DataspacePtr data = consumer_->data();
+  DataspaceConstPtr data = consumer_->data();
 
   double rescale  = md.get_attribute("rescale").get_number();
   if (!std::isfinite(rescale) || !rescale)
@@ -63,7 +63,6 @@ void Consumer1D::update_data()
   auto pen = QPen(QColor(QS(md.get_attribute("appearance").get_text())), 1);
 
   DataAxis axis;
-  EntryList spectrum_data;
 
   if (data)
   {
@@ -75,18 +74,16 @@ void Consumer1D::update_data()
       bounds.second--;
     }
 
-    spectrum_data = data->range({bounds});
+    data->read_range(block_, {bounds});
   }
 
   QPlot::HistMap1D hist;
-  if (spectrum_data)
+  if (data)
   {
-    for (auto it : *spectrum_data)
-    {
-      double xx = axis.domain[it.first[0]];
-      double yy = to_double( it.second ) * rescale;
-      hist[xx] = yy;
-    }
+    block_.for_each([&hist, &axis, rescale](const Coords& c, double count)
+                    {
+                      hist[axis.domain[c[0]]] = count * rescale;
+                    });
   }
 
   if (!hist.empty())
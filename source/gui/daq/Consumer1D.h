@@ -26,4 +26,7 @@ class Consumer1D : public AbstractConsumerWidget
   bool user_zoomed_{false};
 
   QPlot::Marker1D marker;
+
+  // reused across refreshes
+  DAQuiri::DataBlock block_;
 };
@@ -45,7 +45,7 @@ void Consumer2D::update_data()
 
   //  Timer guiside(true);
 
-  DataspacePtr data = consumer_->data();
+  DataspaceConstPtr data = consumer_->data();
   ConsumerMetadata md = consumer_->metadata();
 
   std::string new_label = md.get_attribute("name").get_text();
@@ -70,19 +70,47 @@ void Consumer2D::update_data()
     rescale = 1;
 
   QPlot::HistList2D hist;
-  if (data)
+  uint16_t level = 0;
+  // without cached levels a coarse read costs a full read and more,
+  // so those dataspaces keep the full and incremental reads below
+  if (data && data->has_levels() && !user_zoomed_)
   {
-    auto spectrum_data = data->all_data();
-    if (spectrum_data)
-      for (const auto& p : *spectrum_data) {
-        // p2d point2D ?  - push_back (x,y, value)
-        hist.push_back(QPlot::p2d(p.first[0],
-                                  p.first[1],
-                                  rescale * to_double(p.second)));
-      }
+    // fully zoomed out, a few bins per pixel are plenty
+    size_t pixels = std::max(plot_->width(), plot_->height());
+    size_t extent = std::max(data->axis(0).bounds().second,
+                             data->axis(1).bounds().second) + 1;
+    while (((extent >> level) > 2 * pixels) && (level < 15))
+      level++;
   }
 
-  if (!hist.empty())
+  // bins changed since the last refresh of the same consumer are written
+  // straight into the plot, as long as it still shows all the others
+  auto cells = qobject_cast<QCPColorMap*>(plot_->plottable());
+  bool incremental = false;
+  if (data && level)
+    data->read_level(block_, level);
+  else if (data)
+  {
+    bool same = cells && !shown_level_
+        && (consumer_.get() == shown_consumer_)
+        && (rescale == shown_rescale_)
+        && (data->axis(0).domain == x_domain)
+        && (data->axis(1).domain == y_domain);
+    incremental = same && data->range_since(block_, shown_version_);
+    if (!same)
+      data->read_all(block_);
+    shown_version_ = data->version();
+  }
+  shown_consumer_ = nullptr;
+
+  if (!incremental)
+    block_.for_each([&hist, rescale](const Coords& c, double count)
+                    {
+                      if (count != 0)
+                        hist.push_back(QPlot::p2d(c[0], c[1], rescale * count));
+                    });
+
+  if (!hist.empty() || incremental)
   {
     DataAxis axis_x = data->axis(0);
     DataAxis axis_y = data->axis(1);
@@ -94,11 +122,14 @@ void Consumer2D::update_data()
     uint32_t res_y = axis_y.bounds().second;
 
     plot_->clearExtras();
-    plot_->clearData();
-    plot_->setAxes(
-        QS(axis_x.label()), x_domain[0], x_domain[res_x],
-        QS(axis_y.label()), y_domain[0], y_domain[res_y],
-        "count");
+    if (!incremental)
+    {
+      plot_->clearData();
+      plot_->setAxes(
+          QS(axis_x.label()), x_domain[0], x_domain[res_x],
+          QS(axis_y.label()), y_domain[0], y_domain[res_y],
+          "count");
+    }
 
     if (box_visible)
     {
@@ -140,8 +171,24 @@ void Consumer2D::update_data()
       plot_->addLabels({label});
     }
 
-    plot_->updatePlot(res_x + 1, res_y + 1, hist);
+    if (incremental)
+    {
+      // counts only grow between full reads
+      auto range = cells->dataRange();
+      block_.for_each([cells, &range, rescale](const Coords& c, double count)
+                      {
+                        cells->data()->setCell(c[0], c[1], rescale * count);
+                        range.expand(rescale * count);
+                      });
+      cells->setDataRange(range);
+    }
+    else
+      plot_->updatePlot((res_x >> level) + 1, (res_y >> level) + 1, hist);
     plot_->replotExtras();
+
+    shown_consumer_ = consumer_.get();
+    shown_level_ = level;
+    shown_rescale_ = rescale;
   }
 
   if (!user_zoomed_)
@@ -32,4 +32,13 @@ class Consumer2D : public AbstractConsumerWidget
 
   std::vector<double> x_domain;
   std::vector<double> y_domain;
+
+  // reused across refreshes
+  DAQuiri::DataBlock block_;
+
+  // what the plot shows, updated in place from changes since shown_version_
+  DAQuiri::Consumer* shown_consumer_ {nullptr};
+  uint64_t shown_version_ {0};
+  uint16_t shown_level_ {0};
+  double shown_rescale_ {1};
 };
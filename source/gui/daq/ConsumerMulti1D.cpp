@@ -81,9 +81,8 @@ void ConsumerMulti1D::update_data()
     auto pen = QPen(QColor(QS(md.get_attribute("appearance").get_text())), 1);
 
     DataAxis axis;
-    EntryList spectrum_data;
 
-    DataspacePtr data = consumer->data();
+    DataspaceConstPtr data = consumer->data();
     if (data)
     {
       axis = data->axis(0);
@@ -94,18 +93,16 @@ void ConsumerMulti1D::update_data()
         bounds.second--;
       }
 
-      spectrum_data = data->range({bounds});
+      data->read_range(block_, {bounds});
     }
 
     QPlot::HistMap1D hist;
-    if (spectrum_data)
+    if (data)
     {
-      for (auto it : *spectrum_data)
-      {
-        double xx = axis.domain[it.first[0]];
-        double yy = to_double(it.second) * rescale;
-        hist[xx] = yy;
-      }
+      block_.for_each([&hist, &axis, rescale](const Coords& c, double count)
+                      {
+                        hist[axis.domain[c[0]]] = count * rescale;
+                      });
     }
 
     auto name = md.get_attribute("name").get_text();
@@ -44,4 +44,7 @@ class ConsumerMulti1D : public QWidget
   bool user_zoomed_{false};
 
   QPlot::Marker1D marker;
+
+  // reused across refreshes
+  DAQuiri::DataBlock block_;
 };
@@ -42,7 +42,7 @@ void ConsumerScalar::update_data()
     return;
 
   ConsumerMetadata md = consumer_->metadata();
-  DataspacePtr data = consumer_->data();
+  DataspaceConstPtr data = consumer_->data();
 
   auto app = md.get_attribute("appearance").get_text();
 
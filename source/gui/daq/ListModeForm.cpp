@@ -277,11 +277,12 @@ void ListModeForm::spill_selection_changed(QItemSelection, QItemSelection)
     SpillPtr sp = list_data_.at(row);
     if (sp)
     {
-      events_ = std::vector<Event>(sp->events.begin(), sp->events.end());
-      attr_model_.update(sp->state);
+      events_ = std::vector<Event>(sp->event_buffer().begin(), sp->event_buffer().end());
+      auto state = sp->full_state();
+      attr_model_.update(state);
 
-      ui->treeAttribs->setVisible(sp->state != Setting());
-      ui->labelState->setVisible(sp->state != Setting());
+      ui->treeAttribs->setVisible(state != Setting());
+      ui->labelState->setVisible(state != Setting());
       event_model_ = sp->event_model;
 
 //      DBG( "Received event model " << event_model_;
@@ -342,7 +343,7 @@ void ListModeForm::trace_selection_changed(QItemSelection, QItemSelection)
     SpillPtr sp3 = std::make_shared<Spill>(sp->stream_id, Spill::Type::running);
     sp3->event_model = sp->event_model;
     sp3->events.reserve(1, sp->event_model);
-    sp3->events.last() = events_[event_i];
+    sp3->events.last().assign(events_[event_i]);
     ++sp3->events;
     sp3->events.finalize();
     trace_->push_spill(*sp3);
@@ -1,4 +1,17 @@
 #include <producers/ESSStream/ESSGeometryPlugin.h>
+#include <core/util/logger.h>
+#include <limits>
+
+static bool fill_event(ESSGeometry& geometry, EventRef& event, uint32_t pixel_id)
+{
+  if (!geometry.valid_id(pixel_id)) //must be non0?
+    return false;
+  event.set_value(0, geometry.x(pixel_id));
+  event.set_value(1, geometry.y(pixel_id));
+  event.set_value(2, geometry.z(pixel_id));
+  event.set_value(3, geometry.p(pixel_id));
+  return true;
+}
 
 ESSGeometryPlugin::ESSGeometryPlugin()
 {
@@ -27,6 +40,8 @@ ESSGeometryPlugin::ESSGeometryPlugin()
   root.set_enum(i++, r + "/extent_z");
   root.set_enum(i++, r + "/panels");
   add_definition(root);
+
+  build_map();
 }
 
 Setting ESSGeometryPlugin::settings() const
@@ -43,10 +58,53 @@ Setting ESSGeometryPlugin::settings() const
 void ESSGeometryPlugin::settings(const Setting& settings)
 {
   std::string r{plugin_name()};
-  geometry_.nx(settings.find({r + "/extent_x"}).get_number());
-  geometry_.ny(settings.find({r + "/extent_y"}).get_number());
-  geometry_.nz(settings.find({r + "/extent_z"}).get_number());
-  geometry_.np(settings.find({r + "/panels"}).get_number());
+  uint32_t nx = settings.find({r + "/extent_x"}).get_number();
+  uint32_t ny = settings.find({r + "/extent_y"}).get_number();
+  uint32_t nz = settings.find({r + "/extent_z"}).get_number();
+  uint32_t np = settings.find({r + "/panels"}).get_number();
+
+  // settings come around often, the lookup table only needs the extents
+  if ((nx == geometry_.nx()) && (ny == geometry_.ny()) &&
+      (nz == geometry_.nz()) && (np == geometry_.np()))
+    return;
+
+  geometry_.nx(nx);
+  geometry_.ny(ny);
+  geometry_.nz(nz);
+  geometry_.np(np);
+  build_map();
+}
+
+void ESSGeometryPlugin::build_map()
+{
+  map_.reset();
+
+  size_t limit = std::numeric_limits<uint16_t>::max() + size_t(1);
+  if ((geometry_.nx() > limit) || (geometry_.ny() > limit) ||
+      (geometry_.nz() > limit) || (geometry_.np() > limit))
+    return;
+
+  // ids 1 to max are pixels, 0 and max + 1 are not
+  size_t size = size_t(geometry_.nx()) * geometry_.ny()
+      * geometry_.nz() * geometry_.np() + 2;
+  if ((size * sizeof(PixelMap::Coords) + size / 8) > max_map_bytes)
+  {
+    INFO("<ESSGeometryPlugin> {} pixels are too many for a lookup table", size - 2);
+    return;
+  }
+
+  auto map = std::make_shared<PixelMap>();
+  map->coords.resize(size, PixelMap::Coords{0, 0, 0, 0});
+  map->valid.resize((size + 63) / 64, 0);
+  for (size_t i = 0; i < (size - 1); ++i)
+  {
+    if (!geometry_.valid_id(i))
+      continue;
+    map->coords[i] = {uint16_t(geometry_.x(i)), uint16_t(geometry_.y(i)),
+                      uint16_t(geometry_.z(i)), uint16_t(geometry_.p(i))};
+    map->valid[i >> 6] |= (uint64_t(1) << (i & 63));
+  }
+  map_ = map;
 }
 
 void ESSGeometryPlugin::define(EventModel& definition)
@@ -57,13 +115,59 @@ void ESSGeometryPlugin::define(EventModel& definition)
   definition.add_value("panel", geometry_.np());
 }
 
-bool ESSGeometryPlugin::fill(Event& event, uint32_t pixel_id)
+bool ESSGeometryPlugin::fill(EventRef& event, uint32_t pixel_id)
 {
-  if (!geometry_.valid_id(pixel_id)) //must be non0?
-    return false;
-  event.set_value(0, geometry_.x(pixel_id));
-  event.set_value(1, geometry_.y(pixel_id));
-  event.set_value(2, geometry_.z(pixel_id));
-  event.set_value(3, geometry_.p(pixel_id));
-  return true;
-}
\ No newline at end of file
+  if (map_)
+    return map_->fill(event, pixel_id);
+  return fill_event(geometry_, event, pixel_id);
+}
+
+EventColumns::Decoder ESSGeometryPlugin::decoder() const
+{
+  if (map_)
+  {
+    auto map = map_;
+    return [map](EventRef& event, uint32_t pixel_id)
+    {
+      return map->fill(event, pixel_id);
+    };
+  }
+
+  auto geometry = geometry_;
+  return [geometry](EventRef& event, uint32_t pixel_id) mutable
+  {
+    return fill_event(geometry, event, pixel_id);
+  };
+}
+
+EventColumns::Validator ESSGeometryPlugin::validator() const
+{
+  if (map_)
+  {
+    auto map = map_;
+    return [map](uint32_t pixel_id)
+    {
+      return map->valid_id(pixel_id);
+    };
+  }
+
+  auto geometry = geometry_;
+  return [geometry](uint32_t pixel_id) mutable
+  {
+    return geometry.valid_id(pixel_id);
+  };
+}
+
+size_t ESSGeometryPlugin::invalid_count(const uint32_t* pixel_ids, size_t count)
+{
+  size_t ret {0};
+  if (map_)
+  {
+    for (size_t i = 0; i < count; ++i)
+      ret += !map_->valid_id(pixel_ids[i]);
+    return ret;
+  }
+  for (size_t i = 0; i < count; ++i)
+    ret += !geometry_.valid_id(pixel_ids[i]);
+  return ret;
+}
@@ -1,8 +1,9 @@
 #pragma once
 
 #include <core/plugin/Plugin.h>
-#include <core/Event.h>
+#include <core/EventColumns.h>
 #include <logical_geometry/ESSGeometry.h>
+#include <memory>
 
 using namespace DAQuiri;
 
@@ -16,8 +17,61 @@ class ESSGeometryPlugin : public Plugin
     void settings(const Setting&) override;
 
     void define(EventModel& definition);
-    bool fill(Event& event, uint32_t pixel_id);
+    bool fill(EventRef& event, uint32_t pixel_id);
+
+    /// \brief same as fill, with a copy of the current geometry
+    EventColumns::Decoder decoder() const;
+
+    /// \brief whether decoder would accept a pixel id
+    EventColumns::Validator validator() const;
+
+    /// \brief how many of the pixel ids decoder would reject
+    size_t invalid_count(const uint32_t* pixel_ids, size_t count);
+
+    /// \brief largest lookup table, beyond which pixels are mapped as they come
+    static constexpr size_t max_map_bytes {256 << 20};
 
   private:
     ESSGeometry geometry_{1, 1, 1, 1};
+
+    /// \brief x, y, z and panel of every pixel id, computed once per geometry
+    struct PixelMap
+    {
+      struct Coords
+      {
+        uint16_t x, y, z, p;
+      };
+
+      /// by pixel id, the last entry stands in for all ids out of range
+      std::vector<Coords> coords;
+      /// bitmap of valid pixel ids, same indexing as coords
+      std::vector<uint64_t> valid;
+
+      inline size_t index(uint32_t pixel_id) const
+      {
+        return std::min(size_t(pixel_id), coords.size() - 1);
+      }
+
+      inline bool valid_id(uint32_t pixel_id) const
+      {
+        size_t i = index(pixel_id);
+        return (valid[i >> 6] >> (i & 63)) & 1;
+      }
+
+      inline bool fill(EventRef& event, uint32_t pixel_id) const
+      {
+        size_t i = index(pixel_id);
+        const auto& c = coords[i];
+        event.set_value(0, c.x);
+        event.set_value(1, c.y);
+        event.set_value(2, c.z);
+        event.set_value(3, c.p);
+        return (valid[i >> 6] >> (i & 63)) & 1;
+      }
+    };
+
+    /// shared with decoders, null if the geometry is too large for it
+    std::shared_ptr<const PixelMap> map_;
+
+    void build_map();
 };
@@ -1,12 +1,16 @@
 #include <producers/ESSStream/ESSStream.h>
 
 #include <producers/ESSStream/ev42_parser.h>
+#include <producers/ESSStream/ev44_parser.h>
 #include <producers/ESSStream/mo01_parser.h>
 #include <producers/ESSStream/f142_parser.h>
 // #include <producers/ESSStream/SenvParser.h>
 // #include <producers/ESSStream/SenvParserWrong.h>
 
 #include <core/util/logger.h>
+#include <core/util/Timer.h>
+
+#include <algorithm>
 
 ESSStream::ESSStream()
 {
@@ -16,6 +20,7 @@ ESSStream::ESSStream()
   parser_names_["ChopperTDC"] = 3;
   // parser_names_["SenvParser"] = 4;
   // parser_names_["SenvParserWrong"] = 5;
+  parser_names_["ev44_events"] = 6; ///< efu event stream, by reference pulse
 
   std::string r {plugin_name()};
 
@@ -84,6 +89,7 @@ bool ESSStream::daq_stop()
 {
   terminate_.store(true);
 
+  // each stream joins its own workers
   for (auto& s : streams_)
     if (s.runner.joinable())
       s.runner.join();
@@ -173,7 +179,11 @@ void ESSStream::settings(const Setting& settings)
 
     select_parser(i, parser);
     if (streams_[i].parser && (streams_[i].parser->plugin_name() == parser))
+    {
       streams_[i].parser->settings(v.find({parser}));
+      for (auto& w : streams_[i].workers)
+        w->parser->settings(v.find({parser}));
+    }
     i++;
   }
 }
@@ -187,16 +197,25 @@ void ESSStream::select_parser(size_t i, std::string t)
     return;
   if (t.empty())
     streams_[i].parser.reset();
-  else if (t == "ev42_events")
-    streams_[i].parser = std::make_shared<ev42_events>();
+  else if (auto parser = make_parser(t))
+    streams_[i].parser = parser;
+}
+
+FBParserPtr ESSStream::make_parser(std::string t)
+{
+  if (t == "ev42_events")
+    return std::make_shared<ev42_events>();
+  else if (t == "ev44_events")
+    return std::make_shared<ev44_events>();
   else if (t == "mo01_nmx")
-    streams_[i].parser = std::make_shared<mo01_nmx>();
+    return std::make_shared<mo01_nmx>();
   else if (t == "ChopperTDC")
-    streams_[i].parser = std::make_shared<ChopperTDC>();
+    return std::make_shared<ChopperTDC>();
 //   else if (t == "SenvParser")
-//     streams_[i].parser = std::make_shared<SenvParser>();
+//     return std::make_shared<SenvParser>();
 //   else if (t == "SenvParserWrong")
-//     streams_[i].parser = std::make_shared<SenvParserWrong>();
+//     return std::make_shared<SenvParserWrong>();
+  return nullptr;
 }
 
 
@@ -219,7 +238,11 @@ void ESSStream::boot()
 
     status_ = ProducerStatus::loaded | ProducerStatus::can_boot;
 
-    s.consumer = kafka_config_.subscribe_topic(s.config.kafka_topic_name_);
+    s.workers.clear();
+    if (s.config.kafka_parallelism_ > 1)
+      assign_workers(s);
+    else
+      s.consumer = kafka_config_.subscribe_topic(s.config.kafka_topic_name_);
 
     if (!s.consumer)
     {
@@ -227,8 +250,9 @@ void ESSStream::boot()
       continue;
     }
 
-    INFO("<ESSStream:{}> booted with consumer {}",
-        s.config.kafka_topic_name_, s.consumer->low_level->name());
+    INFO("<ESSStream:{}> booted with consumer {} and {} more",
+        s.config.kafka_topic_name_, s.consumer->low_level->name(),
+        s.workers.size());
     total_valid++;
   }
 
@@ -243,18 +267,59 @@ void ESSStream::boot()
       ProducerStatus::booted | ProducerStatus::can_run;
 }
 
+/// \brief one consumer for s itself, and a worker with a parser of its own
+///         for every other share of the topic's partitions
+void ESSStream::assign_workers(Stream& s)
+{
+  std::vector<Kafka::ConsumerPtr> consumers;
+  try
+  {
+    consumers = kafka_config_.assign_topic(s.config.kafka_topic_name_,
+                                           s.config.kafka_parallelism_);
+  }
+  catch (std::exception& e)
+  {
+    ERR("<ESSStream:{}> Failed to assign partitions: {}",
+        s.config.kafka_topic_name_, e.what());
+  }
+
+  if (consumers.empty())
+    return;
+
+  s.consumer = consumers[0];
+  auto settings = s.parser->settings();
+  for (size_t i = 1; i < consumers.size(); ++i)
+  {
+    auto w = std::make_unique<Stream>();
+    w->config = s.config;
+    w->consumer = consumers[i];
+    w->parser = make_parser(s.parser->plugin_name());
+    w->parser->settings(settings);
+    w->parser->stream_state = s.parser->stream_state;
+    s.workers.push_back(std::move(w));
+  }
+}
+
 void ESSStream::die()
 {
 //  INFO( "<ESSStream> Shutting down";
   for (auto& s : streams_)
+  {
     if (s.consumer)
       s.consumer->low_level->close();
+    for (auto& w : s.workers)
+      if (w->consumer)
+        w->consumer->low_level->close();
+  }
 
   kafka_config_.decomission();
 
   for (auto& s : streams_)
+  {
     if (s.consumer)
       s.consumer.reset();
+    s.workers.clear();
+  }
 
   status_ = ProducerStatus::loaded | ProducerStatus::can_boot;
 }
@@ -265,43 +330,59 @@ void ESSStream::Stream::worker_run(SpillMultiqueue * spill_queue,
 {
   INFO("<ESSStream:{}> Starting run, timeout: {}", config.kafka_topic_name_, consume_timeout); //more info!!!
 
-  uint64_t spills {0};
+  for (auto& w : workers)
+    w->runner = std::thread(&ESSStream::Stream::consume, w.get(), spill_queue,
+                            consume_timeout, terminate);
 
-  while (!terminate->load())
+  consume(spill_queue, consume_timeout, terminate);
+
+  uint64_t total_spills {spills};
+  double time_spent {parser->stats.time_spent};
+  uint64_t good {MessagesGood};
+  uint64_t bad {MessagesBad};
+  for (auto& w : workers)
   {
-    auto message = consumer->consume(consume_timeout);
+    if (w->runner.joinable())
+      w->runner.join();
+    total_spills += w->spills;
+    time_spent += w->parser->stats.time_spent;
+    good += w->MessagesGood;
+    bad += w->MessagesBad;
+  }
 
-    if (!good(message)) {
-      MessagesBad++;
-      continue;
-    }
-    MessagesGood++;
+  // only after all workers are done, so that nothing follows it
+  total_spills += parser->stop(spill_queue);
 
-    if (get_fb_id(message) != parser->schema_id())
-    {
-//      auto ch = reinterpret_cast<char const *const>(message->low_level->payload());
-//      std::string c(ch, message->low_level->len());
-//      WARN("<ESSStream:{}> fb schema id mismatch {}!={}\ncontents:{}",
-//          config.kafka_topic_name_, get_fb_id(message), parser->schema_id());
-      continue;
-    }
+  INFO("<ESSStream:{}> Finished run, spills={}", config.kafka_topic_name_, total_spills);
 
-    spills += parser->process_payload(spill_queue, message->low_level->payload());
+  INFO("<ESSStream:{}>   time={}  messages good: {}, bad: {}, secs/spill={}  skipped buffers={}",
+      config.kafka_topic_name_, time_spent, good, bad,
+      time_spent / double(total_spills),
+      parser->stream_state->dropped_buffers.load());
+}
 
-    if (config.kafka_ff_)
-        parser->stats.dropped_buffers +=
-            ff_stream(message, config.kafka_max_backlog_);
-  }
+void ESSStream::Stream::consume(SpillMultiqueue * spill_queue,
+                                uint16_t consume_timeout,
+                                std::atomic<bool>* terminate)
+{
+  spills = 0;
+  std::vector<Kafka::MessagePtr> batch;
+  batch.reserve(config.kafka_batch_size_);
 
-  spills += parser->stop(spill_queue);
+  while (!terminate->load())
+  {
+    fill_batch(batch, consume_timeout);
+    if (batch.empty())
+      continue;
 
-  INFO("<ESSStream:{}> Finished run, spills={}", config.kafka_topic_name_, spills);
+    spills += parser->process_batch(spill_queue, batch);
 
-  INFO("<ESSStream:{}>   time={}  messages good: {}, bad: {}, secs/spill={}  skipped buffers={}",
-      config.kafka_topic_name_, parser->stats.time_spent,
-      MessagesGood, MessagesBad,
-      parser->stats.time_spent / double(spills),
-      parser->stats.dropped_buffers);
+    if (config.kafka_ff_)
+        parser->stream_state->dropped_buffers +=
+            ff_batch(batch, config.kafka_max_backlog_);
+
+    batch.clear();
+  }
 }
 
 bool ESSStream::good(Kafka::MessagePtr message)
@@ -309,11 +390,11 @@ bool ESSStream::good(Kafka::MessagePtr message)
   switch (message->low_level->err())
   {
     case RdKafka::ERR__UNKNOWN_TOPIC:
-      WARN("<ESSStream> Unknown topic! Err={}", message->low_level->errstr());
+      WARN_LIMITED("<ESSStream> Unknown topic! Err={}", message->low_level->errstr());
       return false;
 
     case RdKafka::ERR__UNKNOWN_PARTITION:
-      WARN("<ESSStream> topic:{}  Unknown partition! Err={}",
+      WARN_LIMITED("<ESSStream> topic:{}  Unknown partition! Err={}",
           message->low_level->topic_name(), message->low_level->errstr());
       return false;
 
@@ -323,7 +404,7 @@ bool ESSStream::good(Kafka::MessagePtr message)
       return false;
 
     case RdKafka::ERR__PARTITION_EOF:
-      WARN( "Kafka partition EOF error: {}", message->low_level->errstr());
+      WARN_LIMITED("Kafka partition EOF error: {}", message->low_level->errstr());
       return false;
 
           /* Last message */
@@ -355,7 +436,7 @@ bool ESSStream::good(Kafka::MessagePtr message)
       return (message->low_level->len() > 0);
 
     default:
-      WARN("<ESSStream> {}:{} Consume failed! Err={}",
+      WARN_LIMITED("<ESSStream> {}:{} Consume failed! Err={}",
           message->low_level->topic_name(),
           message->low_level->partition(),
           message->low_level->errstr());
@@ -363,11 +444,52 @@ bool ESSStream::good(Kafka::MessagePtr message)
   }
 }
 
+/// \brief the first message may take as long as consume_timeout,
+///         the rest of the batch as long as the batch latency allows
+///         counting from when the first one arrived
+void ESSStream::Stream::fill_batch(std::vector<Kafka::MessagePtr>& batch,
+                                   uint16_t consume_timeout)
+{
+  Timer timer;
+  uint16_t timeout = consume_timeout;
+  auto schema = parser->schema_id();
+
+  while (batch.size() < size_t(config.kafka_batch_size_))
+  {
+    auto message = consumer->consume(timeout);
+
+    if (!good(message)) {
+      MessagesBad++;
+    } else {
+      MessagesGood++;
+      if (has_fb_id(message, schema))
+      {
+        batch.push_back(message);
+        if (batch.size() == 1)
+          timer.restart();
+      }
+    }
+
+    double left = config.kafka_batch_latency_ - timer.us();
+    if (batch.empty() || (left <= 0))
+      return;
+    timeout = static_cast<uint16_t>(std::min(left / 1000.0, double(consume_timeout)));
+  }
+}
+
+bool ESSStream::has_fb_id(Kafka::MessagePtr message, const std::string& id)
+{
+  if ((message->low_level->len() < 8) || (id.size() != 4))
+    return (get_fb_id(message) == id);
+  auto ch = reinterpret_cast<const char*>(message->low_level->payload());
+  return (id.compare(0, 4, ch + 4, 4) == 0);
+}
+
 std::string ESSStream::get_fb_id(Kafka::MessagePtr message)
 {
   if (message->low_level->len() < 8)
   {
-    ERR("Could not extract id. Flatbuffer was only {} bytes. Expected ≥ 8 bytes.", message->low_level->len());
+    ERR_LIMITED("Could not extract id. Flatbuffer was only {} bytes. Expected ≥ 8 bytes.", message->low_level->len());
     return {};
   }
   auto ch = reinterpret_cast<char const *const>(message->low_level->payload());
@@ -375,6 +497,24 @@ std::string ESSStream::get_fb_id(Kafka::MessagePtr message)
 }
 
 
+uint64_t ESSStream::Stream::ff_batch(const std::vector<Kafka::MessagePtr>& batch,
+                                     int64_t kafka_max_backlog)
+{
+  // the last message of each partition tells how far behind that one is
+  std::vector<int32_t> partitions;
+  uint64_t ret {0};
+  for (auto it = batch.rbegin(); it != batch.rend(); ++it)
+  {
+    int32_t partition = (*it)->low_level->partition();
+    if (std::find(partitions.begin(), partitions.end(), partition)
+        != partitions.end())
+      continue;
+    partitions.push_back(partition);
+    ret += ff_stream(*it, kafka_max_backlog);
+  }
+  return ret;
+}
+
 uint64_t ESSStream::Stream::ff_stream(Kafka::MessagePtr message,
                                       int64_t kafka_max_backlog)
 {
@@ -57,22 +57,45 @@ class ESSStream : public Producer
       FBParserPtr parser;
       std::thread runner;
 
+      /// \brief runs the workers alongside its own consumer, stops the
+      ///         stream once all of them are done
       void worker_run(SpillMultiqueue * spill_queue, uint16_t consume_timeout,
                       std::atomic<bool>* terminate);
 
+      /// \brief consumes and parses until terminated, no start or stop
+      void consume(SpillMultiqueue * spill_queue, uint16_t consume_timeout,
+                   std::atomic<bool>* terminate);
+
+      /// \brief takes up to kafka_batch_size_ messages of the parser's schema
+      void fill_batch(std::vector<Kafka::MessagePtr>& batch,
+                      uint16_t consume_timeout);
+
       uint64_t ff_stream(Kafka::MessagePtr message, int64_t kafka_max_backlog);
+      /// \brief ff_stream for every partition the batch has messages of
+      uint64_t ff_batch(const std::vector<Kafka::MessagePtr>& batch,
+                        int64_t kafka_max_backlog);
 
       ///\brief Kafka stats
       std::uint64_t MessagesGood{0};
       std::uint64_t MessagesBad{0};
+      std::uint64_t spills{0};
+
+      ///\brief more threads on the same topic, each on its own partitions
+      ///        and with a parser sharing the stream state of this one
+      std::vector<std::unique_ptr<Stream>> workers;
     };
 
 
     std::vector<Stream> streams_;
 
     void select_parser(size_t, std::string);
+    void assign_workers(Stream&);
+
+    static FBParserPtr make_parser(std::string);
 
     static bool good(Kafka::MessagePtr message);
 
     static std::string get_fb_id(Kafka::MessagePtr message);
+    /// \brief same as get_fb_id(message) == id, without the copy
+    static bool has_fb_id(Kafka::MessagePtr message, const std::string& id);
 };
@@ -130,7 +130,7 @@ std::string KafkaConfigPlugin::random_string( size_t length )
   return str;
 }
 
-Kafka::ConsumerPtr KafkaConfigPlugin::subscribe_topic(std::string topic) const
+Kafka::ConsumerPtr KafkaConfigPlugin::create_consumer() const
 {
   auto conf = std::unique_ptr<RdKafka::Conf>(RdKafka::Conf::create(RdKafka::Conf::CONF_GLOBAL));
 
@@ -166,6 +166,15 @@ Kafka::ConsumerPtr KafkaConfigPlugin::subscribe_topic(std::string topic) const
     return nullptr;
   }
 
+  return ret;
+}
+
+Kafka::ConsumerPtr KafkaConfigPlugin::subscribe_topic(std::string topic) const
+{
+  auto ret = create_consumer();
+  if (!ret)
+    return nullptr;
+
   // Start consumer for topic+partition at start offset
   RdKafka::ErrorCode resp = ret->low_level->subscribe({topic});
   if (resp != RdKafka::ERR_NO_ERROR)
@@ -180,6 +189,50 @@ Kafka::ConsumerPtr KafkaConfigPlugin::subscribe_topic(std::string topic) const
   return ret;
 }
 
+std::vector<Kafka::ConsumerPtr> KafkaConfigPlugin::assign_topic(std::string topic,
+                                                                size_t count)
+{
+  std::vector<Kafka::ConsumerPtr> ret;
+
+  auto probe = create_consumer();
+  if (!probe)
+    return ret;
+  auto partitions = get_partitions(probe->low_level, topic);
+  probe->low_level->close();
+
+  if (partitions.empty())
+  {
+    ERR("<KafkaConfigPlugin> No partitions found for '{}'", topic);
+    return ret;
+  }
+
+  count = std::max(size_t(1), std::min(count, partitions.size()));
+  for (size_t i = 0; i < count; ++i)
+  {
+    // round robin, consumer i gets partitions i, i + count, ...
+    std::vector<RdKafka::TopicPartition*> assigned;
+    for (size_t p = i; p < partitions.size(); p += count)
+      assigned.push_back(partitions[p]);
+
+    auto consumer = create_consumer();
+    if (!consumer)
+      break;
+
+    RdKafka::ErrorCode resp = consumer->low_level->assign(assigned);
+    if (resp != RdKafka::ERR_NO_ERROR)
+    {
+      ERR("<KafkaConfigPlugin> Failed to assign partitions of '{}': {}",
+          topic, err2str(resp));
+      consumer->low_level->close();
+      break;
+    }
+    ret.push_back(consumer);
+  }
+
+  RdKafka::TopicPartition::destroy(partitions);
+  return ret;
+}
+
 void KafkaConfigPlugin::decomission() const
 {
   // Wait for RdKafka to decommission, avoids complaints of memory leak from
@@ -252,11 +305,32 @@ KafkaStreamConfig::KafkaStreamConfig()
   mb.set_val("units", "buffers");
   add_definition(mb);
 
+  SettingMeta bs(r + "/KafkaBatchSize", SettingType::integer, "Kafka batch size");
+  bs.set_val("min", 1);
+  bs.set_val("max", 100000);
+  bs.set_val("units", "buffers");
+  add_definition(bs);
+
+  SettingMeta bl(r + "/KafkaBatchLatency", SettingType::integer, "Kafka batch latency");
+  bl.set_val("min", 0);
+  bl.set_val("units", "us");
+  add_definition(bl);
+
+  SettingMeta par(r + "/KafkaParallelism", SettingType::integer, "Parser threads");
+  par.set_flag("preset");
+  par.set_val("min", 1);
+  par.set_val("max", 64);
+  par.set_val("description", "Each thread reads its own share of the topic's partitions");
+  add_definition(par);
+
   int32_t i {0};
   SettingMeta root(r, SettingType::stem, "Kafka topic configuration");
   root.set_enum(i++, r + "/KafkaTopic");
   root.set_enum(i++, r + "/KafkaFF");
   root.set_enum(i++, r + "/KafkaMaxBacklog");
+  root.set_enum(i++, r + "/KafkaBatchSize");
+  root.set_enum(i++, r + "/KafkaBatchLatency");
+  root.set_enum(i++, r + "/KafkaParallelism");
   add_definition(root);
 }
 
@@ -267,6 +341,9 @@ Setting KafkaStreamConfig::settings() const
   set.set(Setting::text(r + "/KafkaTopic", kafka_topic_name_));
   set.set(Setting::boolean(r + "/KafkaFF", kafka_ff_));
   set.set(Setting::integer(r + "/KafkaMaxBacklog", kafka_max_backlog_));
+  set.set(Setting::integer(r + "/KafkaBatchSize", kafka_batch_size_));
+  set.set(Setting::integer(r + "/KafkaBatchLatency", kafka_batch_latency_));
+  set.set(Setting::integer(r + "/KafkaParallelism", kafka_parallelism_));
   return set;
 }
 
@@ -276,4 +353,10 @@ void KafkaStreamConfig::settings(const Setting& set)
   kafka_topic_name_ = set.find({r + "/KafkaTopic"}).get_text();
   kafka_ff_ = set.find({r + "/KafkaFF"}).get_bool();
   kafka_max_backlog_ = set.find({r + "/KafkaMaxBacklog"}).get_int();
+  kafka_batch_size_ = std::max(integer_t(1),
+                               set.find({r + "/KafkaBatchSize"}).get_int());
+  kafka_batch_latency_ = std::max(integer_t(0),
+                                  set.find({r + "/KafkaBatchLatency"}).get_int());
+  kafka_parallelism_ = std::max(integer_t(1),
+                                set.find({r + "/KafkaParallelism"}).get_int());
 }
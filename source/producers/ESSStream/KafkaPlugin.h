@@ -63,6 +63,9 @@ class KafkaConfigPlugin : public DAQuiri::Plugin
     void settings(const DAQuiri::Setting&) override;
 
     Kafka::ConsumerPtr subscribe_topic(std::string topic) const;
+    /// \brief up to count consumers with the topic's partitions split
+    ///         between them, no more consumers than there are partitions
+    std::vector<Kafka::ConsumerPtr> assign_topic(std::string topic, size_t count);
     void decomission() const;
     std::vector<RdKafka::TopicPartition *> get_partitions(std::shared_ptr<RdKafka::KafkaConsumer>, std::string topic);
     std::unique_ptr<RdKafka::Metadata> get_kafka_metadata(std::shared_ptr<RdKafka::KafkaConsumer>) const;
@@ -74,6 +77,9 @@ class KafkaConfigPlugin : public DAQuiri::Plugin
 
     static std::string random_string( size_t length );
 
+    /// \brief consumer with a group of its own, not yet reading anything
+    Kafka::ConsumerPtr create_consumer() const;
+
     /// \brief load daquiri settings from environment variables
     void getEnvironmentSettings();
 
@@ -97,4 +103,7 @@ class KafkaStreamConfig : public DAQuiri::Plugin
     std::string kafka_topic_name_;
     bool kafka_ff_{false};
     int64_t kafka_max_backlog_{3};
+    int64_t kafka_batch_size_{1}; ///< messages parsed together
+    int64_t kafka_batch_latency_{1000}; ///< max wait for a batch to fill, in us
+    int64_t kafka_parallelism_{1}; ///< consumer/parser threads
 };
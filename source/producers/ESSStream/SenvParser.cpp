@@ -87,9 +87,9 @@ uint64_t SenvParser::stop(SpillMultiqueue * spill_queue)
   {
     for (size_t i=0; i <4; ++i) {
       auto sid = stream_id_base_ + std::to_string(i);
-      auto ret = std::make_shared<Spill>(sid, Spill::Type::stop);
-      ret->state.branches.add(Setting::precise("native_time", stats.time_end));
-      ret->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+      auto ret = spill_queue->pool().acquire(sid, Spill::Type::stop);
+      ret->stats.set(SpillStats::native_time, stats.time_end);
+      ret->stats.set(SpillStats::dropped_buffers, stats.dropped_buffers);
       spill_queue->enqueue(ret);
     }
     started_ = false;
@@ -103,9 +103,9 @@ uint64_t SenvParser::start(SpillMultiqueue * spill_queue)
   for (size_t i=0; i <4; ++i)
   {
     auto sid = stream_id_base_ + std::to_string(i);
-    auto run_spill = std::make_shared<Spill>(sid, Spill::Type::start);
-    run_spill->state.branches.add(Setting::precise("native_time", stats.time_start));
-    run_spill->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+    auto run_spill = spill_queue->pool().acquire(sid, Spill::Type::start);
+    run_spill->stats.set(SpillStats::native_time, stats.time_start);
+    run_spill->stats.set(SpillStats::dropped_buffers, stats.dropped_buffers);
     spill_queue->enqueue(run_spill);
   }
   return 4;
@@ -158,9 +158,9 @@ uint64_t SenvParser::process_payload(SpillMultiqueue * spill_queue, void* msg)
   }
 
   auto sid = stream_id_base_ + std::to_string(channel);
-  auto run_spill = std::make_shared<Spill>(sid, Spill::Type::running);
-  run_spill->state.branches.add(Setting::precise("native_time", Data->PacketTimestamp()));
-  run_spill->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+  auto run_spill = spill_queue->pool().acquire(sid, Spill::Type::running);
+  run_spill->stats.set(SpillStats::native_time, Data->PacketTimestamp());
+  run_spill->stats.set(SpillStats::dropped_buffers, stats.dropped_buffers);
   run_spill->state.branches.add(Setting::text("senv_name", source_name));
   run_spill->state.branches.add(Setting::integer("senv_chan", channel));
   run_spill->state.branches.add(Setting::floating("senv_delta", delta));
@@ -172,7 +172,7 @@ uint64_t SenvParser::process_payload(SpillMultiqueue * spill_queue, void* msg)
   {
     run_spill->event_model = event_model_;
     run_spill->events.reserve(1, event_model_);
-    auto& evt = run_spill->events.last();
+    auto evt = run_spill->events.last();
     evt.set_time(Data->PacketTimestamp());
     evt.set_value(0, channel);
 
@@ -85,9 +85,9 @@ uint64_t SenvParserWrong::stop(SpillMultiqueue * spill_queue)
   {
     for (size_t i=0; i <4; ++i) {
       auto sid = stream_id_base_ + std::to_string(i);
-      auto ret = std::make_shared<Spill>(sid, Spill::Type::stop);
-      ret->state.branches.add(Setting::precise("native_time", stats.time_end));
-      ret->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+      auto ret = spill_queue->pool().acquire(sid, Spill::Type::stop);
+      ret->stats.set(SpillStats::native_time, stats.time_end);
+      ret->stats.set(SpillStats::dropped_buffers, stats.dropped_buffers);
       spill_queue->enqueue(ret);
     }
     started_ = false;
@@ -101,9 +101,9 @@ uint64_t SenvParserWrong::start(SpillMultiqueue * spill_queue)
   for (size_t i=0; i <4; ++i)
   {
     auto sid = stream_id_base_ + std::to_string(i);
-    auto run_spill = std::make_shared<Spill>(sid, Spill::Type::start);
-    run_spill->state.branches.add(Setting::precise("native_time", stats.time_start));
-    run_spill->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+    auto run_spill = spill_queue->pool().acquire(sid, Spill::Type::start);
+    run_spill->stats.set(SpillStats::native_time, stats.time_start);
+    run_spill->stats.set(SpillStats::dropped_buffers, stats.dropped_buffers);
     spill_queue->enqueue(run_spill);
   }
   return 4;
@@ -155,9 +155,9 @@ uint64_t SenvParserWrong::process_payload(SpillMultiqueue * spill_queue, void* m
   }
 
   auto sid = stream_id_base_ + std::to_string(channel);
-  auto run_spill = std::make_shared<Spill>(sid, Spill::Type::running);
-  run_spill->state.branches.add(Setting::precise("native_time", Data->PacketTimestamp()));
-  run_spill->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+  auto run_spill = spill_queue->pool().acquire(sid, Spill::Type::running);
+  run_spill->stats.set(SpillStats::native_time, Data->PacketTimestamp());
+  run_spill->stats.set(SpillStats::dropped_buffers, stats.dropped_buffers);
   run_spill->state.branches.add(Setting::text("senv_name", name));
   run_spill->state.branches.add(Setting::integer("senv_chan", channel));
   run_spill->state.branches.add(Setting::floating("senv_delta", delta));
@@ -170,7 +170,7 @@ uint64_t SenvParserWrong::process_payload(SpillMultiqueue * spill_queue, void* m
   for (size_t i=0; i < event_count; ++i)
   {
     uint64_t time = Data->Timestamps()->Get(i);
-    auto& evt = run_spill->events.last();
+    auto evt = run_spill->events.last();
     evt.set_value(0, channel);
     evt.set_time(time);
     ++ run_spill->events;
@@ -21,6 +21,10 @@ ev42_events::ev42_events()
   SettingMeta hb(r + "/Heartbeat", SettingType::boolean, "Send empty heartbeat buffers");
   add_definition(hb);
 
+  SettingMeta zc(r + "/ZeroCopy", SettingType::boolean,
+                 "Keep events in Kafka message, decode only when needed");
+  add_definition(zc);
+
   SettingMeta fsname(r + "/FilterSourceName", SettingType::boolean, "Filter on source name");
   fsname.set_flag("preset");
   add_definition(fsname);
@@ -41,6 +45,7 @@ ev42_events::ev42_events()
   root.set_enum(i++, r + "/StreamID");
   root.set_enum(i++, r + "/SpoofClock");
   root.set_enum(i++, r + "/Heartbeat");
+  root.set_enum(i++, r + "/ZeroCopy");
   root.set_enum(i++, r + "/FilterSourceName");
   root.set_enum(i++, r + "/SourceName");
   root.set_enum(i++, r + "/MessageOrdering");
@@ -58,6 +63,7 @@ Setting ev42_events::settings() const
   set.set(Setting::text(r + "/StreamID", stream_id_));
   set.set(Setting::integer(r + "/SpoofClock", spoof_clock_));
   set.set(Setting::boolean(r + "/Heartbeat", heartbeat_));
+  set.set(Setting::boolean(r + "/ZeroCopy", zero_copy_));
   set.set(Setting::integer(r + "/MessageOrdering", ordering_));
 
   set.branches.add_a(geometry_.settings());
@@ -77,6 +83,7 @@ void ev42_events::settings(const Setting& settings)
   stream_id_ = set.find({r + "/StreamID"}).get_text();
   spoof_clock_ = static_cast<Spoof>(set.find({r + "/SpoofClock"}).get_int());
   heartbeat_ = set.find({r + "/Heartbeat"}).triggered();
+  zero_copy_ = set.find({r + "/ZeroCopy"}).triggered();
   ordering_ = static_cast<CheckOrdering>(set.find({r + "/MessageOrdering"}).get_int());
 
   event_definition_ = EventModel();
@@ -96,18 +103,20 @@ StreamManifest ev42_events::stream_manifest() const
   ret[stream_id_].stats.branches.add(SettingMeta("native_time", SettingType::precise));
   ret[stream_id_].stats.branches.add(SettingMeta("dropped_buffers", SettingType::precise));
   ret[stream_id_].stats.branches.add(SettingMeta("pulse_time", SettingType::precise));
+  ret[stream_id_].stats.branches.add(SettingMeta("out_of_range_pixels", SettingType::precise));
   return ret;
 }
 
 uint64_t ev42_events::stop(SpillMultiqueue * spill_queue)
 {
-  if (started_)
+  if (claim_stop())
   {
-    auto ret = std::make_shared<Spill>(stream_id_, Spill::Type::stop);
-    ret->state.branches.add(Setting::precise("native_time", stats.time_end));
-    ret->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+    auto ret = spill_queue->pool().acquire(stream_id_, Spill::Type::stop);
+    ret->stats.set(SpillStats::native_time, stream_state->time_end.load());
+    ret->stats.set(SpillStats::dropped_buffers, stream_state->dropped_buffers.load());
+    ret->stats.set(SpillStats::out_of_range_pixels,
+                   stream_state->out_of_range_pixels.load());
     spill_queue->enqueue(ret);
-    started_ = false;
     return 1;
   }
   return 0;
@@ -132,97 +141,228 @@ std::string ev42_events::get_source_name(void* msg) const
 
 /// \brief key function - processing message payload
 uint64_t ev42_events::process_payload(SpillMultiqueue * spill_queue, void* msg)
+{
+  return process(spill_queue, msg, nullptr);
+}
+
+uint64_t ev42_events::process_message(SpillMultiqueue * spill_queue,
+                                      Kafka::MessagePtr message)
+{
+  if (!zero_copy_)
+    return fb_parser::process_message(spill_queue, message);
+  return process(spill_queue, message->low_level->payload(), message);
+}
+
+/// \brief if owner is given, events are left in msg for consumers to decode
+uint64_t ev42_events::process(SpillMultiqueue * spill_queue, void* msg,
+                              std::shared_ptr<const void> owner)
 {
   Timer timer(true);
-  uint64_t pushed_spills = 0;
   hr_time_t start_time {std::chrono::system_clock::now()};
 
   auto em = GetEventMessage(msg);
 
-  std::string source_name = em->source_name()->str();
-  if (filter_source_name_ && (source_name_ != source_name))
+  if (!accept_message(em->source_name(), em->message_id()))
   {
     stats.time_spent += timer.s();
     return 0;
   }
 
-  if ((ordering_ != Ignore) && !in_order(em))
+  size_t event_count = events_in_buffer(em);
+
+  uint64_t time_high = pulse_time(em);
+
+  stats.time_start = stats.time_end = time_high;
+
+  SpillPtr run_spill = spill_queue->pool().acquire(stream_id_, Spill::Type::running);
+  run_spill->event_model = event_definition_;
+
+  if (owner && event_count)
   {
-    WARN("Buffer out of order ({}<={}) {}", em->message_id(), latest_buf_id_, debug(em));
-    if (ordering_ == Reject)
+    const uint32_t* tofs = em->time_of_flight()->data();
+    for (size_t i=0; i < event_count; ++i)
     {
-      stats.time_spent += timer.s();
-      return 0;
+      uint64_t time = time_high + tofs[i];
+      if (i==0) {
+        stats.time_start = time;
+      }
+      stats.time_start = std::min(stats.time_start, time);
+      stats.time_end = std::max(stats.time_end, time);
     }
+    const uint32_t* pixels = em->detector_id()->data();
+    stream_state->out_of_range_pixels += geometry_.invalid_count(pixels, event_count);
+    run_spill->columns = std::make_shared<EventColumns>(
+        std::move(owner), tofs, pixels, event_count,
+        time_high, geometry_.decoder(), geometry_.validator());
+  }
+  else
+  {
+    run_spill->events.reserve(event_count, event_definition_);
+    decode(run_spill->events, em, time_high, true);
+    run_spill->events.finalize();
   }
 
-  size_t event_count = events_in_buffer(em);
+  uint64_t pushed_spills = push(spill_queue, run_spill, em, time_high,
+                                start_time, event_count || heartbeat_);
 
-  uint64_t time_high = em->pulse_time();
+  stats.time_spent += timer.s();
+  return pushed_spills;
+}
 
-  if (spoof_clock_ == Monotonous)
-    time_high = spoofed_time_++ << 32;
+/// \brief consecutive messages of the same pulse go out in one spill
+uint64_t ev42_events::process_batch(SpillMultiqueue * spill_queue,
+                                    const std::vector<Kafka::MessagePtr>& batch)
+{
+  // zero-copy spills cannot span messages
+  if (zero_copy_ || (batch.size() < 2))
+    return fb_parser::process_batch(spill_queue, batch);
+
+  payloads_.clear();
+  for (const auto& message : batch)
+    payloads_.push_back(message->low_level->payload());
+  return process_payloads(spill_queue, payloads_);
+}
 
-  stats.time_start = stats.time_end = time_high;
+uint64_t ev42_events::process_payloads(SpillMultiqueue * spill_queue,
+                                       const std::vector<void*>& payloads)
+{
+  Timer timer(true);
+  uint64_t pushed_spills = 0;
+  hr_time_t start_time {std::chrono::system_clock::now()};
 
-  SpillPtr run_spill = std::make_shared<Spill>(stream_id_, Spill::Type::running);
-  run_spill->event_model = event_definition_;
-  run_spill->events.reserve(event_count, event_definition_);
+  SpillPtr run_spill;
+  const EventMessage* first {nullptr};
+  uint64_t time_high {0};
+  bool restart {true};
+  bool send {false};
+
+  for (auto payload : payloads)
+  {
+    auto em = GetEventMessage(payload);
+    if (!accept_message(em->source_name(), em->message_id()))
+      continue;
+    size_t event_count = events_in_buffer(em);
+
+    uint64_t pulse = pulse_time(em);
+    if (run_spill && (pulse != time_high))
+    {
+      run_spill->events.finalize();
+      pushed_spills += push(spill_queue, run_spill, first, time_high,
+                            start_time, send);
+      run_spill.reset();
+    }
 
+    if (!run_spill)
+    {
+      run_spill = spill_queue->pool().acquire(stream_id_, Spill::Type::running);
+      run_spill->event_model = event_definition_;
+      first = em;
+      time_high = pulse;
+      stats.time_start = stats.time_end = time_high;
+      restart = true;
+      send = heartbeat_;
+    }
+
+    // room for this message only, the buffer grows geometrically
+    auto& events = run_spill->events;
+    events.reserve(events.size() + event_count, event_definition_);
+    decode(events, em, time_high, restart);
+    if (event_count)
+      restart = false;
+    send = send || event_count;
+  }
+
+  if (run_spill)
+  {
+    run_spill->events.finalize();
+    pushed_spills += push(spill_queue, run_spill, first, time_high,
+                          start_time, send);
+  }
+
+  stats.time_spent += timer.s();
+  return pushed_spills;
+}
+
+uint64_t ev42_events::pulse_time(const EventMessage* em)
+{
+  if (spoof_clock_ == Monotonous)
+    return stream_state->spoofed_time++ << 32;
+  return em->pulse_time();
+}
+
+void ev42_events::decode(EventBuffer& events, const EventMessage* em,
+                         uint64_t time_high, bool restart)
+{
+  size_t event_count = events_in_buffer(em);
+  if (!event_count)
+    return;
+
+  const uint32_t* tofs = em->time_of_flight()->data();
+  const uint32_t* pixels = em->detector_id()->data();
+  uint64_t out_of_range {0};
   for (size_t i=0; i < event_count; ++i)
   {
-    uint64_t time = em->time_of_flight()->Get(i);
     /// \todo we don't have TOF in any data currently, so this may (will?) fail
     /// maybe add a flag to just use time_high?
-    time += time_high;
-    if (i==0) {
+    uint64_t time = time_high + tofs[i];
+    if (restart && (i==0)) {
       stats.time_start = time;
     }
     stats.time_start = std::min(stats.time_start, time);
     stats.time_end = std::max(stats.time_end, time);
 
-    auto& evt = run_spill->events.last(); ///< get ptr to free event entry
-    if (geometry_.fill(evt, em->detector_id()->Get(i))) {
-      //INFO("time {}, time_start {}, time_end {}", time, stats.time_start, stats.time_end);
+    auto evt = events.last(); ///< get ptr to free event entry
+    if (geometry_.fill(evt, pixels[i])) {
       evt.set_time(time);
-      ++ run_spill->events; ///< advance idx in event buffer
+      ++ events; ///< advance idx in event buffer
     } else {
-      WARN("Out of range Pixid={}", em->detector_id()->Get(i));
+      out_of_range++;
     }
-//    DBG( "Time " << stats.time_start << " - " << stats.time_end;
   }
-  run_spill->events.finalize();
+  // once per message, not per event
+  if (out_of_range)
+  {
+    stream_state->out_of_range_pixels += out_of_range;
+    WARN_LIMITED("<ev42_events> {} events with out of range pixel ids in message {}",
+                 out_of_range, em->message_id());
+  }
+}
 
-  run_spill->state.branches.add(Setting::precise("native_time", stats.time_end));
-  run_spill->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+uint64_t ev42_events::push(SpillMultiqueue * spill_queue, SpillPtr run_spill,
+                           const EventMessage* em, uint64_t time_high,
+                           hr_time_t start_time, bool send)
+{
+  uint64_t pushed_spills = 0;
 
-  if (spoof_clock_ == Monotonous)
-    run_spill->state.branches.add(Setting::precise("pulse_time", time_high));
-  else if (spoof_clock_ == Earliest)
-    run_spill->state.branches.add(Setting::precise("pulse_time", stats.time_start));
+  update_time_end(stats.time_end);
+  run_spill->stats.set(SpillStats::native_time, stats.time_end);
+  run_spill->stats.set(SpillStats::dropped_buffers, stream_state->dropped_buffers.load());
+  run_spill->stats.set(SpillStats::out_of_range_pixels,
+                       stream_state->out_of_range_pixels.load());
+
+  if (spoof_clock_ == Earliest)
+    run_spill->stats.set(SpillStats::pulse_time, stats.time_start);
   else
-    run_spill->state.branches.add(Setting::precise("pulse_time", em->pulse_time()));
+    run_spill->stats.set(SpillStats::pulse_time, time_high);
 
-  run_spill->state.branches.add(Setting::text("source_name", source_name));
+  run_spill->state.branches.add(Setting::text("source_name", em->source_name()->str()));
 
-  if (!started_)
+  if (claim_start())
   {
-    auto start_spill = std::make_shared<Spill>(stream_id_, Spill::Type::start);
+    auto start_spill = spill_queue->pool().acquire(stream_id_, Spill::Type::start);
     start_spill->time = start_time;
-    start_spill->state.branches.add(Setting::precise("native_time", time_high));
+    start_spill->stats.set(SpillStats::native_time, time_high);
 //    start_spill->state.branches.add(Setting::text("source_name", source_name));
     spill_queue->enqueue(start_spill); /// \brief enqueue 'start' for consumer
-    started_ = true;
     pushed_spills++;
   }
 
-  if (event_count || heartbeat_)
+  if (send)
   {
     spill_queue->enqueue(run_spill); /// \brief enqueue events for consumer
     pushed_spills++;
   }
 
-  stats.time_spent += timer.s();
   return pushed_spills;
 }
 
@@ -235,25 +375,3 @@ size_t ev42_events::events_in_buffer(const EventMessage* em)
 
   return t_len;
 }
-
-bool ev42_events::in_order(const EventMessage* em)
-{
-  const auto& buf_id = em->message_id();
-  if (buf_id <= latest_buf_id_)
-    return false;
-  latest_buf_id_ = std::max(latest_buf_id_, buf_id);
-  return true;
-}
-
-std::string ev42_events::debug(const EventMessage* em)
-{
-  std::stringstream ss;
-
-  ss << em->source_name()->str()
-     << " #" << em->message_id()
-     << " time=" << em->pulse_time()
-     << " tof_size=" << em->time_of_flight()->size()
-     << " det_size=" << em->detector_id()->size();
-
-  return ss.str();
-}
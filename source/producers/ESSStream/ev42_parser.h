@@ -32,6 +32,13 @@ class ev42_events : public fb_parser
   Setting settings() const override;
 
   uint64_t process_payload(SpillMultiqueue * spill_queue, void* msg) override;
+  uint64_t process_message(SpillMultiqueue * spill_queue,
+                           Kafka::MessagePtr message) override;
+  uint64_t process_batch(SpillMultiqueue * spill_queue,
+                         const std::vector<Kafka::MessagePtr>& batch) override;
+  /// \brief as process_batch, for payloads that need not outlive the call
+  uint64_t process_payloads(SpillMultiqueue * spill_queue,
+                            const std::vector<void*>& payloads);
   uint64_t stop(SpillMultiqueue * spill_queue) override;
 
   StreamManifest stream_manifest() const override;
@@ -46,31 +53,30 @@ class ev42_events : public fb_parser
     Earliest = 2
   };
 
-  enum CheckOrdering : int32_t
-  {
-    Ignore = 0,
-    Warn = 1,
-    Reject = 2
-  };
-
   std::string stream_id_;
   ESSGeometryPlugin geometry_;
   EventModel event_definition_;
   Spoof spoof_clock_{None};
   bool heartbeat_{false};
+  bool zero_copy_{false};
+
+  // reused by process_batch
+  std::vector<void*> payloads_;
+
+  uint64_t process(SpillMultiqueue * spill_queue, void* msg,
+                   std::shared_ptr<const void> owner);
+
+  /// \brief time_high of the message, spoofed if so configured
+  uint64_t pulse_time(const EventMessage*);
+  /// \brief adds events of the message to space reserved in events,
+  ///         time_start comes from the first event if restart
+  void decode(EventBuffer& events, const EventMessage*,
+              uint64_t time_high, bool restart);
+  /// \brief finishes run_spill and enqueues it if send, preceded by
+  ///         the start spill if this is the first one
+  uint64_t push(SpillMultiqueue * spill_queue, SpillPtr run_spill,
+                const EventMessage*, uint64_t time_high,
+                hr_time_t start_time, bool send);
 
-  bool filter_source_name_{false};
-  std::string source_name_;
-  CheckOrdering ordering_{Ignore};
-
-  // to ensure expected stream structure
-  bool started_{false};
-  uint64_t spoofed_time_{0};
-
-  // stream error checking
-  uint64_t latest_buf_id_{0};
-
-  bool in_order(const EventMessage*);
   size_t events_in_buffer(const EventMessage*);
-  std::string debug(const EventMessage*);
 };
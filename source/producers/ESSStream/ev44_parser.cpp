@@ -0,0 +1,333 @@
+#include <producers/ESSStream/ev44_parser.h>
+#include "ev44_events_generated.h"
+
+#include <core/util/Timer.h>
+#include <core/util/logger.h>
+
+ev44_events::ev44_events()
+{
+  std::string r{plugin_name()};
+
+  SettingMeta streamid(r + "/StreamID", SettingType::text, "DAQuiri stream ID");
+  streamid.set_flag("preset");
+  add_definition(streamid);
+
+  SettingMeta hb(r + "/Heartbeat", SettingType::boolean, "Send empty heartbeat buffers");
+  add_definition(hb);
+
+  SettingMeta zc(r + "/ZeroCopy", SettingType::boolean,
+                 "Keep events in Kafka message, decode only when needed");
+  add_definition(zc);
+
+  SettingMeta fsname(r + "/FilterSourceName", SettingType::boolean, "Filter on source name");
+  fsname.set_flag("preset");
+  add_definition(fsname);
+
+  SettingMeta sname(r + "/SourceName", SettingType::text, "Source name");
+  sname.set_flag("preset");
+  add_definition(sname);
+
+  SettingMeta oor(r + "/MessageOrdering", SettingType::menu, "If message_id out of order");
+  oor.set_enum(CheckOrdering::Ignore, "ignore");
+  oor.set_enum(CheckOrdering::Warn, "warn");
+  oor.set_enum(CheckOrdering::Reject, "reject");
+  add_definition(oor);
+
+  int32_t i{0};
+  SettingMeta root(r, SettingType::stem);
+  root.set_flag("producer");
+  root.set_enum(i++, r + "/StreamID");
+  root.set_enum(i++, r + "/Heartbeat");
+  root.set_enum(i++, r + "/ZeroCopy");
+  root.set_enum(i++, r + "/FilterSourceName");
+  root.set_enum(i++, r + "/SourceName");
+  root.set_enum(i++, r + "/MessageOrdering");
+
+  add_definition(root);
+}
+
+Setting ev44_events::settings() const
+{
+  std::string r{plugin_name()};
+  auto set = get_rich_setting(r);
+
+  set.set(Setting::boolean(r + "/FilterSourceName", filter_source_name_));
+  set.set(Setting::text(r + "/SourceName", source_name_));
+  set.set(Setting::text(r + "/StreamID", stream_id_));
+  set.set(Setting::boolean(r + "/Heartbeat", heartbeat_));
+  set.set(Setting::boolean(r + "/ZeroCopy", zero_copy_));
+  set.set(Setting::integer(r + "/MessageOrdering", ordering_));
+
+  set.branches.add_a(geometry_.settings());
+  set.branches.add_a(TimeBasePlugin(event_definition_.timebase).settings());
+
+  set.enable_if_flag(!(status_ & booted), "preset");
+  return set;
+}
+
+void ev44_events::settings(const Setting& settings)
+{
+  std::string r{plugin_name()};
+  auto set = enrich_and_toggle_presets(settings);
+
+  filter_source_name_ = set.find({r + "/FilterSourceName"}).triggered();
+  source_name_ = set.find({r + "/SourceName"}).get_text();
+  stream_id_ = set.find({r + "/StreamID"}).get_text();
+  heartbeat_ = set.find({r + "/Heartbeat"}).triggered();
+  zero_copy_ = set.find({r + "/ZeroCopy"}).triggered();
+  ordering_ = static_cast<CheckOrdering>(set.find({r + "/MessageOrdering"}).get_int());
+
+  TimeBasePlugin tbs;
+  tbs.settings(set.find({tbs.plugin_name()}));
+  event_definition_ = EventModel();
+  event_definition_.timebase = tbs.timebase();
+  geometry_.settings(set.find({geometry_.plugin_name()}));
+  geometry_.define(event_definition_);
+}
+
+StreamManifest ev44_events::stream_manifest() const
+{
+  StreamManifest ret;
+  ret[stream_id_].event_model = event_definition_;
+  ret[stream_id_].stats.branches.add(SettingMeta("native_time", SettingType::precise));
+  ret[stream_id_].stats.branches.add(SettingMeta("dropped_buffers", SettingType::precise));
+  ret[stream_id_].stats.branches.add(SettingMeta("pulse_time", SettingType::precise));
+  ret[stream_id_].stats.branches.add(SettingMeta("out_of_range_pixels", SettingType::precise));
+  return ret;
+}
+
+uint64_t ev44_events::stop(SpillMultiqueue * spill_queue)
+{
+  if (claim_stop())
+  {
+    auto ret = spill_queue->pool().acquire(stream_id_, Spill::Type::stop);
+    ret->stats.set(SpillStats::native_time, stream_state->time_end.load());
+    ret->stats.set(SpillStats::dropped_buffers, stream_state->dropped_buffers.load());
+    ret->stats.set(SpillStats::out_of_range_pixels,
+                   stream_state->out_of_range_pixels.load());
+    spill_queue->enqueue(ret);
+    return 1;
+  }
+  return 0;
+}
+
+std::string ev44_events::schema_id() const
+{
+  return std::string(Event44MessageIdentifier());
+}
+
+std::string ev44_events::get_source_name(void* msg) const
+{
+  auto em = GetEvent44Message(msg);
+  auto NamePtr = em->source_name();
+  if (NamePtr == nullptr)
+  {
+    ERR("<ev44_events> message has no source_name");
+    return "";
+  }
+  return NamePtr->str();
+}
+
+/// \brief key function - processing message payload
+uint64_t ev44_events::process_payload(SpillMultiqueue * spill_queue, void* msg)
+{
+  return process(spill_queue, msg, nullptr);
+}
+
+uint64_t ev44_events::process_message(SpillMultiqueue * spill_queue,
+                                      Kafka::MessagePtr message)
+{
+  if (!zero_copy_)
+    return fb_parser::process_message(spill_queue, message);
+  return process(spill_queue, message->low_level->payload(), message);
+}
+
+uint64_t ev44_events::process(SpillMultiqueue * spill_queue, void* msg,
+                              std::shared_ptr<const void> owner)
+{
+  Timer timer(true);
+  uint64_t pushed_spills = 0;
+  hr_time_t start_time {std::chrono::system_clock::now()};
+
+  auto em = GetEvent44Message(msg);
+
+  if (!accept_message(em->source_name(), em->message_id()))
+  {
+    stats.time_spent += timer.s();
+    return 0;
+  }
+
+  size_t event_count = events_in_buffer(em);
+  size_t pulse_count = pulses_in_buffer(em, event_count);
+  if (event_count && !pulse_count)
+  {
+    WARN_LIMITED("<ev44_events> Bad reference times {}", debug(em));
+    stats.time_spent += timer.s();
+    return 0;
+  }
+
+  const int64_t* pulses = pulse_count ? em->reference_time()->data() : nullptr;
+  const int32_t* index = pulse_count ? em->reference_time_index()->data() : nullptr;
+
+  if (pulse_count)
+    stats.time_start = stats.time_end = pulses[0];
+
+  if (claim_start())
+  {
+    auto start_spill = spill_queue->pool().acquire(stream_id_, Spill::Type::start);
+    start_spill->time = start_time;
+    start_spill->stats.set(SpillStats::native_time, stats.time_start);
+    spill_queue->enqueue(start_spill); /// \brief enqueue 'start' for consumer
+    pushed_spills++;
+  }
+
+  // only needed as a string to label the spills
+  std::string source_name;
+  if ((pulse_count || heartbeat_) && em->source_name())
+    source_name = em->source_name()->str();
+
+  // pulse boundaries come from the index, events are never looked at one
+  // by one to find out which pulse they belong to
+  for (size_t p = 0; p < pulse_count; ++p)
+  {
+    size_t begin = index[p];
+    size_t end = ((p + 1) < pulse_count) ? size_t(index[p + 1]) : event_count;
+    if ((begin == end) && !heartbeat_)
+      continue;
+    auto run_spill = pulse_spill(spill_queue, em, begin, end, pulses[p], owner);
+    run_spill->state.branches.add(Setting::text("source_name", source_name));
+    spill_queue->enqueue(run_spill); /// \brief enqueue events for consumer
+    pushed_spills++;
+  }
+
+  if (!pulse_count && heartbeat_)
+  {
+    SpillPtr run_spill = spill_queue->pool().acquire(stream_id_, Spill::Type::running);
+    run_spill->event_model = event_definition_;
+    run_spill->stats.set(SpillStats::native_time, stats.time_end);
+    run_spill->stats.set(SpillStats::dropped_buffers, stream_state->dropped_buffers.load());
+    run_spill->stats.set(SpillStats::out_of_range_pixels,
+                         stream_state->out_of_range_pixels.load());
+    run_spill->state.branches.add(Setting::text("source_name", source_name));
+    spill_queue->enqueue(run_spill);
+    pushed_spills++;
+  }
+
+  stats.time_spent += timer.s();
+  return pushed_spills;
+}
+
+SpillPtr ev44_events::pulse_spill(SpillMultiqueue * spill_queue,
+                                  const Event44Message* em,
+                                  size_t begin, size_t end, int64_t pulse_time,
+                                  const std::shared_ptr<const void>& owner)
+{
+  SpillPtr ret = spill_queue->pool().acquire(stream_id_, Spill::Type::running);
+  ret->event_model = event_definition_;
+
+  const int32_t* tofs = em->time_of_flight()->data() + begin;
+  const int32_t* pixels = em->pixel_id()->data() + begin;
+  size_t count = end - begin;
+
+  // bounds in a loop of its own, which the compiler can vectorize
+  int32_t tof_min {0};
+  int32_t tof_max {0};
+  if (count)
+    tof_min = tof_max = tofs[0];
+  for (size_t i = 1; i < count; ++i)
+  {
+    tof_min = std::min(tof_min, tofs[i]);
+    tof_max = std::max(tof_max, tofs[i]);
+  }
+
+  uint64_t first = pulse_time + tof_min;
+  uint64_t last = pulse_time + tof_max;
+  stats.time_start = std::min(stats.time_start, first);
+  stats.time_end = std::max(stats.time_end, last);
+  update_time_end(last);
+
+  // columns hold unsigned times, so negative TOFs must be decoded here
+  if (owner && count && (tof_min >= 0))
+  {
+    auto ids = reinterpret_cast<const uint32_t*>(pixels);
+    stream_state->out_of_range_pixels += geometry_.invalid_count(ids, count);
+    ret->columns = std::make_shared<EventColumns>(
+        owner, reinterpret_cast<const uint32_t*>(tofs), ids, count,
+        pulse_time, geometry_.decoder(), geometry_.validator());
+  }
+  else if (count)
+  {
+    ret->events.reserve(count, event_definition_);
+    for (size_t i = 0; i < count; ++i)
+    {
+      auto evt = ret->events.last(); ///< get ptr to free event entry
+      if (geometry_.fill(evt, pixels[i]))
+      {
+        evt.set_time(pulse_time + tofs[i]);
+        ++ret->events; ///< advance idx in event buffer
+      }
+    }
+    ret->events.finalize();
+
+    if (ret->events.size() < count)
+    {
+      stream_state->out_of_range_pixels += count - ret->events.size();
+      WARN_LIMITED("<ev44_events> {} events with out of range pixel ids in {}",
+                   count - ret->events.size(), debug(em));
+    }
+  }
+
+  ret->stats.set(SpillStats::native_time, last);
+  ret->stats.set(SpillStats::dropped_buffers, stream_state->dropped_buffers.load());
+  ret->stats.set(SpillStats::out_of_range_pixels,
+                 stream_state->out_of_range_pixels.load());
+  ret->stats.set(SpillStats::pulse_time, pulse_time);
+  return ret;
+}
+
+size_t ev44_events::events_in_buffer(const Event44Message* em)
+{
+  if (!em->time_of_flight() || !em->pixel_id())
+    return 0;
+  auto t_len = em->time_of_flight()->size();
+  auto p_len = em->pixel_id()->size();
+  if ((t_len != p_len) || !t_len)
+    return 0;
+
+  return t_len;
+}
+
+/// \returns 0 if reference times and indices do not split the events
+size_t ev44_events::pulses_in_buffer(const Event44Message* em, size_t event_count)
+{
+  auto times = em->reference_time();
+  auto index = em->reference_time_index();
+  if (!times || !index || (times->size() != index->size()) || !times->size())
+    return 0;
+
+  if (event_count && (index->Get(0) != 0))
+    return 0;
+
+  int32_t previous {0};
+  for (auto i : *index)
+  {
+    if ((i < previous) || (size_t(i) > event_count))
+      return 0;
+    previous = i;
+  }
+
+  return times->size();
+}
+
+std::string ev44_events::debug(const Event44Message* em)
+{
+  std::stringstream ss;
+
+  ss << (em->source_name() ? em->source_name()->str() : "")
+     << " #" << em->message_id()
+     << " pulses=" << (em->reference_time() ? em->reference_time()->size() : 0)
+     << " tof_size=" << (em->time_of_flight() ? em->time_of_flight()->size() : 0)
+     << " det_size=" << (em->pixel_id() ? em->pixel_id()->size() : 0);
+
+  return ss.str();
+}
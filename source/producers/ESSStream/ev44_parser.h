@@ -0,0 +1,66 @@
+/* Copyright (C) 2016-2020 European Spallation Source, ERIC. See LICENSE file */
+//===----------------------------------------------------------------------===//
+///
+/// \file ev44_parser.h
+///
+/// \brief Key primitive - parsing event data with reference pulses
+///
+/// An ev44 message may span several reference pulses. Events of each pulse
+/// go out in a spill of their own, with that pulse as its pulse_time, so
+/// TOF consumers see the same stream structure as with ev42.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <producers/ESSStream/fb_parser.h>
+#include <producers/ESSStream/ESSGeometryPlugin.h>
+
+using namespace DAQuiri;
+
+struct Event44Message;
+
+class ev44_events : public fb_parser
+{
+ public:
+  ev44_events();
+
+  ~ev44_events() = default;
+
+  std::string plugin_name() const override
+  { return "ev44_events"; }
+
+  std::string schema_id() const override;
+  std::string get_source_name(void* msg) const override;
+
+  void settings(const Setting&) override;
+  Setting settings() const override;
+
+  uint64_t process_payload(SpillMultiqueue * spill_queue, void* msg) override;
+  uint64_t process_message(SpillMultiqueue * spill_queue,
+                           Kafka::MessagePtr message) override;
+  /// \brief if owner is given, events are left in msg, which owner keeps
+  ///         alive, for consumers to decode
+  uint64_t process(SpillMultiqueue * spill_queue, void* msg,
+                   std::shared_ptr<const void> owner);
+  uint64_t stop(SpillMultiqueue * spill_queue) override;
+
+  StreamManifest stream_manifest() const override;
+
+ private:
+  // cached params
+
+  std::string stream_id_;
+  ESSGeometryPlugin geometry_;
+  EventModel event_definition_;
+  bool heartbeat_{false};
+  bool zero_copy_{false};
+
+  /// \brief one spill for events [begin, end) of the pulse at pulse_time
+  SpillPtr pulse_spill(SpillMultiqueue * spill_queue, const Event44Message* em,
+                       size_t begin, size_t end, int64_t pulse_time,
+                       const std::shared_ptr<const void>& owner);
+
+  size_t events_in_buffer(const Event44Message*);
+  size_t pulses_in_buffer(const Event44Message*, size_t event_count);
+  std::string debug(const Event44Message*);
+};
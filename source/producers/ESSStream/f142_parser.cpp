@@ -71,15 +71,14 @@ void ChopperTDC::settings(const Setting& settings)
 
 uint64_t ChopperTDC::stop(SpillMultiqueue * spill_queue)
 {
-  if (started_)
+  if (claim_stop())
   {
-    auto ret = std::make_shared<Spill>(stream_id_, Spill::Type::stop);
-    ret->state.branches.add(Setting::precise("native_time", stats.time_end));
-    ret->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+    auto ret = spill_queue->pool().acquire(stream_id_, Spill::Type::stop);
+    ret->stats.set(SpillStats::native_time, stream_state->time_end.load());
+    ret->stats.set(SpillStats::dropped_buffers, stream_state->dropped_buffers.load());
 
     spill_queue->enqueue(ret);
 
-    started_ = false;
     return 1;
   }
 
@@ -111,34 +110,35 @@ uint64_t ChopperTDC::process_payload(SpillMultiqueue * spill_queue, void* msg)
 
   auto ChopperTDCTimeStamp = GetLogData(msg);
 
-  std::string source_name = ChopperTDCTimeStamp->source_name()->str();
-  if (filter_source_name_ && (source_name_ != source_name))
+  // no message ids in this schema, ordering_ is never checked
+  if (!accept_message(ChopperTDCTimeStamp->source_name(), 0))
   {
     stats.time_spent += timer.s();
     return 0;
   }
 
   stats.time_start = stats.time_end = ChopperTDCTimeStamp->timestamp();
+  update_time_end(stats.time_end);
 
-  auto ret = std::make_shared<Spill>(stream_id_, Spill::Type::running);
-  ret->state.branches.add(Setting::precise("native_time", ChopperTDCTimeStamp->timestamp()));
-  ret->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+  auto ret = spill_queue->pool().acquire(stream_id_, Spill::Type::running);
+  ret->stats.set(SpillStats::native_time, ChopperTDCTimeStamp->timestamp());
+  ret->stats.set(SpillStats::dropped_buffers, stream_state->dropped_buffers.load());
   ret->event_model = event_model_;
   ret->events.reserve(1, event_model_);
 
-  auto& e = ret->events.last();
+  auto e = ret->events.last();
   e.set_time(ChopperTDCTimeStamp->timestamp());
   ++ret->events;
   ret->events.finalize();
 
-  if (!started_)
+  if (claim_start())
   {
-    auto start_spill = std::make_shared<Spill>(stream_id_, Spill::Type::start);
+    auto start_spill = spill_queue->pool().acquire(stream_id_, Spill::Type::start);
     start_spill->time = start_time;
-    start_spill->state.branches.add(Setting::precise("native_time", stats.time_start));
-    start_spill->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+    start_spill->stats.set(SpillStats::native_time, stats.time_start);
+    start_spill->stats.set(SpillStats::dropped_buffers,
+                           stream_state->dropped_buffers.load());
     spill_queue->enqueue(start_spill);
-    started_ = true;
     pushed_spills++;
   }
 
@@ -32,12 +32,8 @@ class ChopperTDC : public fb_parser
 
   std::string stream_id_{"ChopperTDC"};
 
-  bool filter_source_name_{false};
-  std::string source_name_;
 
   EventModel event_model_;
 
-  bool started_{false};
-
   static std::string debug(const LogData& TDCTimeStamp);
 };
@@ -1,4 +1,5 @@
 #include <producers/ESSStream/fb_parser.h>
+#include <flatbuffers/flatbuffers.h>
 #include <core/util/logger.h>
 
 fb_parser::fb_parser()
@@ -13,6 +14,58 @@ void fb_parser::boot()
   status_ = ProducerStatus::loaded | ProducerStatus::booted;
 }
 
+uint64_t fb_parser::process_message(SpillMultiqueue * spill_queue,
+                                    Kafka::MessagePtr message)
+{
+  return process_payload(spill_queue, message->low_level->payload());
+}
+
+uint64_t fb_parser::process_batch(SpillMultiqueue * spill_queue,
+                                  const std::vector<Kafka::MessagePtr>& batch)
+{
+  uint64_t ret {0};
+  for (const auto& message : batch)
+    ret += process_message(spill_queue, message);
+  return ret;
+}
+
+bool fb_parser::accept_message(const flatbuffers::String* name,
+                               uint64_t message_id)
+{
+  if (filter_source_name_ &&
+      (!name || source_name_.compare(0, std::string::npos,
+                                     name->c_str(), name->size())))
+    return false;
+
+  if ((ordering_ == Ignore) || (message_id > latest_buf_id_))
+  {
+    if (ordering_ != Ignore)
+      latest_buf_id_ = message_id;
+    return true;
+  }
+
+  WARN("Buffer out of order ({}<={}) {}", message_id, latest_buf_id_,
+       name ? name->str() : "");
+  return (ordering_ != Reject);
+}
+
+bool fb_parser::claim_start()
+{
+  return !stream_state->started.exchange(true);
+}
+
+bool fb_parser::claim_stop()
+{
+  return stream_state->started.exchange(false);
+}
+
+void fb_parser::update_time_end(uint64_t time)
+{
+  auto& end = stream_state->time_end;
+  uint64_t prev = end.load();
+  while ((prev < time) && !end.compare_exchange_weak(prev, time));
+}
+
 void fb_parser::die()
 {
   status_ = ProducerStatus::loaded | ProducerStatus::can_boot;
@@ -10,10 +10,12 @@
 
 #include <core/Producer.h>
 #include <core/util/Timer.h>
+#include <producers/ESSStream/KafkaPlugin.h>
+#include <atomic>
 
 using namespace DAQuiri;
 
-class EventMessage;
+namespace flatbuffers { struct String; }
 
 class fb_parser : public Producer
 {
@@ -23,10 +25,20 @@ class fb_parser : public Producer
     uint64_t time_start{0};
     uint64_t time_end{0};
     double time_spent{0};
-    uint64_t dropped_buffers{0};
+  };
+
+  /// \brief one per stream, shared by the parsers of all its threads
+  struct StreamState
+  {
+    std::atomic<bool> started{false};
+    std::atomic<uint64_t> spoofed_time{0};
+    std::atomic<uint64_t> time_end{0};
+    std::atomic<uint64_t> dropped_buffers{0};
+    std::atomic<uint64_t> out_of_range_pixels{0};
   };
 
   PayloadStats stats;
+  std::shared_ptr<StreamState> stream_state {std::make_shared<StreamState>()};
 
   fb_parser();
 
@@ -41,7 +53,43 @@ class fb_parser : public Producer
   void die() override;
 
   virtual uint64_t process_payload(SpillMultiqueue * spill_queue, void* msg) = 0;
+  /// \brief default forwards the payload to process_payload, override
+  ///         to keep the message alive in spills beyond this call
+  virtual uint64_t process_message(SpillMultiqueue * spill_queue,
+                                   Kafka::MessagePtr message);
+  /// \brief default processes messages one by one, override to
+  ///         aggregate them into fewer spills
+  virtual uint64_t process_batch(SpillMultiqueue * spill_queue,
+                                 const std::vector<Kafka::MessagePtr>& batch);
+  /// \brief enqueues the stop spill if the stream was started, call it
+  ///         once for all parsers sharing the stream, after they are done
   virtual uint64_t stop(SpillMultiqueue * spill_queue) = 0;
+
+ protected:
+  enum CheckOrdering : int32_t
+  {
+    Ignore = 0,
+    Warn = 1,
+    Reject = 2
+  };
+
+  bool filter_source_name_{false};
+  std::string source_name_;
+  CheckOrdering ordering_{Ignore};
+
+  // stream error checking
+  uint64_t latest_buf_id_{0};
+
+  /// \brief source name filter and message ordering check, the name
+  ///         (which may be null) is compared in place
+  bool accept_message(const flatbuffers::String* name, uint64_t message_id);
+
+  /// \brief true for the one parser that is to enqueue the start spill
+  bool claim_start();
+  /// \brief true if the stream was started and is to be stopped
+  bool claim_stop();
+  /// \brief keeps the latest time seen by any parser of the stream
+  void update_time_end(uint64_t time);
 };
 
 using FBParserPtr = std::shared_ptr<fb_parser>;
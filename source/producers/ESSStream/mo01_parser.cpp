@@ -118,29 +118,31 @@ StreamManifest mo01_nmx::stream_manifest() const
 
 uint64_t mo01_nmx::stop(SpillMultiqueue * spill_queue)
 {
-  if (started_)
+  if (claim_stop())
   {
-    auto ret = std::make_shared<Spill>(hists_stream_id_, Spill::Type::stop);
-    ret->state.branches.add(Setting::precise("native_time", spoofed_time_));
-    ret->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+    uint64_t spoofed_time = stream_state->spoofed_time.load();
+    uint64_t dropped_buffers = stream_state->dropped_buffers.load();
+
+    auto ret = spill_queue->pool().acquire(hists_stream_id_, Spill::Type::stop);
+    ret->stats.set(SpillStats::native_time, spoofed_time);
+    ret->stats.set(SpillStats::dropped_buffers, dropped_buffers);
     spill_queue->enqueue(ret);
 
-    auto ret2 = std::make_shared<Spill>(x_stream_id_, Spill::Type::stop);
-    ret2->state.branches.add(Setting::precise("native_time", spoofed_time_));
-    ret2->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+    auto ret2 = spill_queue->pool().acquire(x_stream_id_, Spill::Type::stop);
+    ret2->stats.set(SpillStats::native_time, spoofed_time);
+    ret2->stats.set(SpillStats::dropped_buffers, dropped_buffers);
     spill_queue->enqueue(ret2);
 
-    auto ret3 = std::make_shared<Spill>(y_stream_id_, Spill::Type::stop);
-    ret3->state.branches.add(Setting::precise("native_time", spoofed_time_));
-    ret3->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+    auto ret3 = spill_queue->pool().acquire(y_stream_id_, Spill::Type::stop);
+    ret3->stats.set(SpillStats::native_time, spoofed_time);
+    ret3->stats.set(SpillStats::dropped_buffers, dropped_buffers);
     spill_queue->enqueue(ret3);
 
-    auto ret4 = std::make_shared<Spill>(hit_stream_id_, Spill::Type::stop);
-    ret4->state.branches.add(Setting::precise("native_time", spoofed_time_));
-    ret4->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+    auto ret4 = spill_queue->pool().acquire(hit_stream_id_, Spill::Type::stop);
+    ret4->stats.set(SpillStats::native_time, spoofed_time);
+    ret4->stats.set(SpillStats::dropped_buffers, dropped_buffers);
     spill_queue->enqueue(ret4);
 
-    started_ = false;
     return 3;
   }
 
@@ -171,38 +173,39 @@ uint64_t mo01_nmx::process_payload(SpillMultiqueue * spill_queue, void* msg)
 
   auto em = GetMonitorMessage(msg);
 
-  std::string source_name = em->source_name()->str();
-  if (filter_source_name_ && (source_name_ != source_name))
+  // no message ids in this schema, ordering_ is never checked
+  if (!accept_message(em->source_name(), 0))
   {
     stats.time_spent += timer.s();
     return 0;
   }
 
-  spoofed_time_++;
+  spoofed_time_ = ++stream_state->spoofed_time;
 
-  if (!started_)
+  if (claim_start())
   {
-    auto ret = std::make_shared<Spill>(hists_stream_id_, Spill::Type::start);
-    ret->state.branches.add(Setting::precise("native_time", spoofed_time_));
-    ret->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+    uint64_t dropped_buffers = stream_state->dropped_buffers.load();
+
+    auto ret = spill_queue->pool().acquire(hists_stream_id_, Spill::Type::start);
+    ret->stats.set(SpillStats::native_time, spoofed_time_);
+    ret->stats.set(SpillStats::dropped_buffers, dropped_buffers);
     spill_queue->enqueue(ret);
 
-    auto ret2 = std::make_shared<Spill>(x_stream_id_, Spill::Type::start);
-    ret2->state.branches.add(Setting::precise("native_time", spoofed_time_));
-    ret2->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+    auto ret2 = spill_queue->pool().acquire(x_stream_id_, Spill::Type::start);
+    ret2->stats.set(SpillStats::native_time, spoofed_time_);
+    ret2->stats.set(SpillStats::dropped_buffers, dropped_buffers);
     spill_queue->enqueue(ret2);
 
-    auto ret3 = std::make_shared<Spill>(y_stream_id_, Spill::Type::start);
-    ret3->state.branches.add(Setting::precise("native_time", spoofed_time_));
-    ret3->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+    auto ret3 = spill_queue->pool().acquire(y_stream_id_, Spill::Type::start);
+    ret3->stats.set(SpillStats::native_time, spoofed_time_);
+    ret3->stats.set(SpillStats::dropped_buffers, dropped_buffers);
     spill_queue->enqueue(ret3);
 
-    auto ret4 = std::make_shared<Spill>(hit_stream_id_, Spill::Type::start);
-    ret4->state.branches.add(Setting::precise("native_time", spoofed_time_));
-    ret4->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+    auto ret4 = spill_queue->pool().acquire(hit_stream_id_, Spill::Type::start);
+    ret4->stats.set(SpillStats::native_time, spoofed_time_);
+    ret4->stats.set(SpillStats::dropped_buffers, dropped_buffers);
     spill_queue->enqueue(ret4);
 
-    started_ = true;
     pushed_spills += 3;
   }
 
@@ -227,15 +230,15 @@ uint64_t mo01_nmx::produce_hists(const GEMHist& hist, SpillMultiqueue * queue)
       !hist.cluster_spectrum()->size())
     return 0;
 
-  auto ret = std::make_shared<Spill>(hists_stream_id_, Spill::Type::running);
-  ret->state.branches.add(Setting::precise("native_time", spoofed_time_));
-  ret->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+  auto ret = queue->pool().acquire(hists_stream_id_, Spill::Type::running);
+  ret->stats.set(SpillStats::native_time, spoofed_time_);
+  ret->stats.set(SpillStats::dropped_buffers, stream_state->dropped_buffers.load());
   ret->event_model = hists_model_;
   ret->events.reserve(1, hists_model_);
 
 //  DBG( "Received GEMHist\n" << debug(hist);
 
-  auto& e = ret->events.last();
+  auto e = ret->events.last();
   e.set_time(spoofed_time_);
 
   grab_hist(e, 0, hist.xstrips());
@@ -259,13 +262,13 @@ uint64_t mo01_nmx::produce_tracks(const GEMTrack& track, SpillMultiqueue * queue
 
   if (track.xtrack()->size())
   {
-    queue->enqueue(grab_track(track.xtrack(), x_stream_id_));
+    queue->enqueue(grab_track(track.xtrack(), x_stream_id_, queue->pool()));
     pushed_spills ++;
   }
 
   if (track.ytrack()->size())
   {
-    queue->enqueue(grab_track(track.ytrack(), y_stream_id_));
+    queue->enqueue(grab_track(track.ytrack(), y_stream_id_, queue->pool()));
     pushed_spills ++;
   }
 
@@ -274,15 +277,15 @@ uint64_t mo01_nmx::produce_tracks(const GEMTrack& track, SpillMultiqueue * queue
 
 uint64_t mo01_nmx::produce_hits(const MONHit& hits, SpillMultiqueue * queue)
 {
-  auto spill = std::make_shared<Spill>(hit_stream_id_, Spill::Type::running);
-  spill->state.branches.add(Setting::precise("native_time", spoofed_time_));
-  spill->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+  auto spill = queue->pool().acquire(hit_stream_id_, Spill::Type::running);
+  spill->stats.set(SpillStats::native_time, spoofed_time_);
+  spill->stats.set(SpillStats::dropped_buffers, stream_state->dropped_buffers.load());
   spill->event_model = hits_model_;
   spill->events.reserve(hits.plane()->size(), hits_model_);
 
   for (size_t i=0; i < hits.plane()->size(); ++i)
   {
-    auto& e = spill->events.last();
+    auto e = spill->events.last();
     e.set_time(spoofed_time_ + hits.time()->Get(i));
     e.set_value(0, hits.plane()->Get(i));
     e.set_value(1, hits.channel()->Get(i));
@@ -301,30 +304,30 @@ uint64_t mo01_nmx::produce_hits(const MONHit& hits, SpillMultiqueue * queue)
   return 0;
 }
 
-void mo01_nmx::grab_hist(Event& e, size_t idx, const flatbuffers::Vector<uint32_t>* data)
+void mo01_nmx::grab_hist(EventRef& e, size_t idx, const flatbuffers::Vector<uint32_t>* data)
 {
   if (!data->size())
     return;
 //  std::vector<uint32_t> vals(data->size(), 0);
-  auto& trace = e.trace(idx);
+  auto trace = e.trace(idx);
   for (size_t i=0; i < data->size(); ++i)
     trace[i] = data->Get(i);
 //  DBG( "Added hist " << idx << " length " << data->size();
 }
 
 SpillPtr mo01_nmx::grab_track(const flatbuffers::Vector<flatbuffers::Offset<pos>>* data,
-                              std::string stream)
+                              std::string stream, SpillPool& pool)
 {
-  auto ret = std::make_shared<Spill>(stream, Spill::Type::running);
+  auto ret = pool.acquire(stream, Spill::Type::running);
 
-  ret->state.branches.add(Setting::precise("native_time", spoofed_time_));
-  ret->state.branches.add(Setting::precise("dropped_buffers", stats.dropped_buffers));
+  ret->stats.set(SpillStats::native_time, spoofed_time_);
+  ret->stats.set(SpillStats::dropped_buffers, stream_state->dropped_buffers.load());
   ret->event_model = track_model_;
   ret->events.reserve(data->size(), track_model_);
 
   for (size_t i=0; i < data->size(); ++i)
   {
-    auto& e = ret->events.last();
+    auto e = ret->events.last();
     e.set_time(spoofed_time_);
     const auto& element = data->Get(i);
     e.set_value(0, element->strip());
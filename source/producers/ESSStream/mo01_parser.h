@@ -29,8 +29,6 @@ class mo01_nmx : public fb_parser
  private:
   // cached params
 
-  bool filter_source_name_{false};
-  std::string source_name_;
 
   std::string hists_stream_id_{"nmx_hists"};
   std::string x_stream_id_{"nmx_xtrack"};
@@ -41,16 +39,16 @@ class mo01_nmx : public fb_parser
   EventModel track_model_;
   EventModel hits_model_;
 
+  // this message's tick of the stream's spoofed clock
   uint64_t spoofed_time_{0};
-  bool started_{false};
 
   uint64_t produce_hists(const GEMHist&, SpillMultiqueue * queue);
   uint64_t produce_tracks(const GEMTrack&, SpillMultiqueue * queue);
   uint64_t produce_hits(const MONHit&, SpillMultiqueue * queue);
 
-  static void grab_hist(Event& e, size_t idx, const flatbuffers::Vector<uint32_t>* data);
+  static void grab_hist(EventRef& e, size_t idx, const flatbuffers::Vector<uint32_t>* data);
   SpillPtr grab_track(const flatbuffers::Vector<flatbuffers::Offset<pos>>* data,
-                      std::string stream);
+                      std::string stream, SpillPool& pool);
 
   static std::string debug(const GEMHist&);
   static std::string debug(const GEMTrack&);
@@ -211,10 +211,10 @@ void MockProducer::worker_run(SpillMultiqueue * spill_queue)
 
   Timer timer(true);
 
-  spill_queue->enqueue(get_spill(Spill::Type::start, timer.s()));
+  spill_queue->enqueue(get_spill(spill_queue->pool(), Spill::Type::start, timer.s()));
   while (!terminate_.load())
   {
-    spill_queue->enqueue(get_spill(Spill::Type::running, timer.s()));
+    spill_queue->enqueue(get_spill(spill_queue->pool(), Spill::Type::running, timer.s()));
     Timer::wait_s(spill_interval_);
 
     double seconds = timer.s();
@@ -222,21 +222,21 @@ void MockProducer::worker_run(SpillMultiqueue * spill_queue)
     if (overshoot > 0)
       DBG("<MockProducer> Native clock overshoot {}%", overshoot);
   }
-  spill_queue->enqueue(get_spill(Spill::Type::stop, timer.s()));
+  spill_queue->enqueue(get_spill(spill_queue->pool(), Spill::Type::stop, timer.s()));
 }
 
 void MockProducer::add_hit(Spill& spill, uint64_t time)
 {
-  auto& e = spill.events.last();
+  auto e = spill.events.last();
   e.set_time(time);
   for (size_t i = 0; i < val_defs_.size(); ++i)
     val_defs_[i].generate(i, e);
   ++spill.events;
 }
 
-SpillPtr MockProducer::get_spill(Spill::Type t, double seconds)
+SpillPtr MockProducer::get_spill(SpillPool& pool, Spill::Type t, double seconds)
 {
-  SpillPtr spill = std::make_shared<Spill>(stream_id_, t);
+  SpillPtr spill = pool.acquire(stream_id_, t);
 
   recent_pulse_time_ = clock_ = event_definition_.timebase.to_native(seconds * pow(10, 9));
 
@@ -285,8 +285,8 @@ void MockProducer::fill_stats(Spill& spill) const
   double duration_live = duration * (1.0 - dead_);
   double duration_trigger = duration * (1.0 - 0.5 * dead_);
 
-  spill.state.branches.add(Setting::floating("native_time", duration));
-  spill.state.branches.add(Setting::floating("live_time", duration_live));
-  spill.state.branches.add(Setting::floating("live_trigger", duration_trigger));
-  spill.state.branches.add(Setting::floating("pulse_time", double(recent_pulse_time_)));
+  spill.stats.set(SpillStats::native_time, duration);
+  spill.stats.set(SpillStats::live_time, duration_live);
+  spill.stats.set(SpillStats::live_trigger, duration_trigger);
+  spill.stats.set(SpillStats::pulse_time, double(recent_pulse_time_));
 }
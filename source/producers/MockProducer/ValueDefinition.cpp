@@ -86,7 +86,7 @@ void ValueDefinition::define(EventModel& def)
     def.add_trace(name_, {trace_length_});
 }
 
-void ValueDefinition::generate(size_t index, Event& event)
+void ValueDefinition::generate(size_t index, EventRef& event)
 {
   auto val = generate_val();
   event.set_value(index, val);
@@ -99,9 +99,9 @@ uint32_t ValueDefinition::generate_val()
   return std::round(std::max(std::min(dist(gen_), double(max_)), 0.0));
 }
 
-void ValueDefinition::make_trace(size_t index, Event& e, uint32_t val)
+void ValueDefinition::make_trace(size_t index, EventRef& e, uint32_t val)
 {
-  auto& trc = e.trace(index);
+  auto trc = e.trace(index);
 
   size_t onset = double(trc.size()) * trace_onset_;
   size_t peak = double(trc.size()) * (trace_onset_ + trace_risetime_);
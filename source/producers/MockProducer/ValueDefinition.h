@@ -1,7 +1,7 @@
 #pragma once
 
 #include <core/plugin/Plugin.h>
-#include <core/Event.h>
+#include <core/EventBuffer.h>
 #include <random>
 
 using namespace DAQuiri;
@@ -17,7 +17,7 @@ class ValueDefinition : public DAQuiri::Plugin
     void settings(const Setting&) override;
 
     void define(EventModel& def);
-    void generate(size_t index, Event& event);
+    void generate(size_t index, EventRef& event);
 
   private:
     std::string name_;
@@ -35,5 +35,5 @@ class ValueDefinition : public DAQuiri::Plugin
     std::default_random_engine gen_;
 
     uint32_t generate_val();
-    void make_trace(size_t index, Event& e, uint32_t val);
+    void make_trace(size_t index, EventRef& e, uint32_t val);
 };
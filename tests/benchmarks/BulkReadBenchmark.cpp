@@ -0,0 +1,91 @@
+/// Read benchmark for a GUI-style refresh of a 2D histogram: the whole
+/// Adaptive2D is fetched and visited, once through range() (one Coords
+/// allocation per bin) and once through read_range() into a reused DataBlock.
+///
+/// usage: BulkReadBenchmark [edge] [refreshes]
+
+#include <consumers/dataspaces/Adaptive2D.h>
+#include <core/util/Timer.h>
+
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+using namespace DAQuiri;
+
+void fill(Adaptive2D& space, size_t edge, double occupancy)
+{
+  std::mt19937_64 gen(42);
+  std::uniform_real_distribution<double> hit(0, 1);
+  // extent first, so that the representation is settled by occupancy
+  space.add_one({edge - 1, edge - 1});
+  for (size_t x = 0; x < edge; ++x)
+    for (size_t y = 0; y < edge; ++y)
+      if (hit(gen) < occupancy)
+        space.add_one({x, y});
+}
+
+double run_entries(const Adaptive2D& space, size_t refreshes, double& sum)
+{
+  Timer timer(true);
+  for (size_t i = 0; i < refreshes; ++i)
+  {
+    auto entries = space.range({});
+    for (const auto& e : *entries)
+      sum += e.first[0] + to_double(e.second);
+  }
+  return refreshes / timer.s();
+}
+
+double run_block(const Adaptive2D& space, size_t refreshes, double& sum)
+{
+  DataBlock block;
+  Timer timer(true);
+  for (size_t i = 0; i < refreshes; ++i)
+  {
+    space.read_range(block, {});
+    block.for_each([&sum](const Coords& c, double count)
+                   {
+                     if (count != 0)
+                       sum += c[0] + count;
+                   });
+  }
+  return refreshes / timer.s();
+}
+
+int main(int argc, char** argv)
+{
+  size_t edge = 1024;
+  size_t refreshes = 10;
+  if (argc > 1)
+    edge = std::stoul(argv[1]);
+  if (argc > 2)
+    refreshes = std::stoul(argv[2]);
+
+  std::cout << "grid: " << edge << "x" << edge << "  refreshes: " << refreshes << "\n";
+  std::cout << std::setw(10) << "occupancy"
+            << std::setw(16) << "layout"
+            << std::setw(22) << "EntryList [reads/s]"
+            << std::setw(22) << "DataBlock [reads/s]"
+            << std::setw(10) << "speedup" << "\n";
+
+  for (double occupancy : {0.01, 0.1, 1.0})
+  {
+    Adaptive2D space;
+    fill(space, edge, occupancy);
+    double sum_entries = 0, sum_block = 0;
+    double entries = run_entries(space, refreshes, sum_entries);
+    double block = run_block(space, refreshes, sum_block);
+    if (sum_entries != sum_block)
+      std::cerr << "sum mismatch\n";
+    std::cout << std::setw(9) << std::fixed << std::setprecision(0)
+              << (occupancy * 100) << "%"
+              << std::setw(16) << space.representation()
+              << std::setw(22) << std::setprecision(1) << entries
+              << std::setw(22) << block
+              << std::setw(10) << std::setprecision(2) << (block / entries)
+              << "\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,91 @@
+/// Fill benchmark for 2D dataspaces: streaming add_one into an N x N grid
+/// where only a fraction of the bins is ever hit, comparing the Eigen-based
+/// SparseMatrix2D against the tiled TileMap2D (and SparseMap2D).
+///
+/// usage: Dataspace2DBenchmark [edge=512] [events=2000000]
+
+#include <consumers/dataspaces/SparseMap2D.h>
+#include <consumers/dataspaces/SparseMatrix2D.h>
+#include <consumers/dataspaces/TileMap2D.h>
+#include <core/util/Timer.h>
+
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+using namespace DAQuiri;
+
+std::vector<size_t> make_coords(size_t edge, double occupancy, size_t events)
+{
+  std::mt19937_64 gen(42);
+
+  // pick the occupied bins once, then draw events among them
+  std::vector<size_t> bins(edge * edge);
+  for (size_t i = 0; i < bins.size(); ++i)
+    bins[i] = i;
+  std::shuffle(bins.begin(), bins.end(), gen);
+  bins.resize(std::max(size_t(1), static_cast<size_t>(bins.size() * occupancy)));
+
+  std::uniform_int_distribution<size_t> pick(0, bins.size() - 1);
+  std::vector<size_t> coords;
+  coords.reserve(2 * events);
+  for (size_t i = 0; i < events; ++i)
+  {
+    size_t b = bins[pick(gen)];
+    coords.push_back(b / edge);
+    coords.push_back(b % edge);
+  }
+  return coords;
+}
+
+template<typename Space>
+double run(const std::vector<size_t>& coords)
+{
+  Space space;
+  Coords c {0, 0};
+  Timer timer(true);
+  for (size_t i = 0; i + 1 < coords.size(); i += 2)
+  {
+    c[0] = coords[i];
+    c[1] = coords[i + 1];
+    space.add_one(c);
+  }
+  double secs = timer.s();
+  if (space.total_count() != coords.size() / 2)
+    std::cerr << "count mismatch\n";
+  return (coords.size() / 2) / secs;
+}
+
+int main(int argc, char** argv)
+{
+  size_t edge = 512;
+  size_t events = 2000000;
+  if (argc > 1)
+    edge = std::stoul(argv[1]);
+  if (argc > 2)
+    events = std::stoul(argv[2]);
+
+  std::cout << "grid: " << edge << "x" << edge << "  events: " << events << "\n";
+  std::cout << std::setw(10) << "occupancy"
+            << std::setw(22) << "SparseMatrix2D [ev/s]"
+            << std::setw(20) << "SparseMap2D [ev/s]"
+            << std::setw(20) << "TileMap2D [ev/s]"
+            << std::setw(10) << "speedup" << "\n";
+
+  for (double occupancy : {0.01, 0.1, 1.0})
+  {
+    auto coords = make_coords(edge, occupancy, events);
+    double eigen = run<SparseMatrix2D>(coords);
+    double map = run<SparseMap2D>(coords);
+    double tiles = run<TileMap2D>(coords);
+    std::cout << std::setw(9) << std::fixed << std::setprecision(0)
+              << (occupancy * 100) << "%"
+              << std::setw(22) << eigen
+              << std::setw(20) << map
+              << std::setw(20) << tiles
+              << std::setw(10) << std::setprecision(2) << (tiles / eigen)
+              << "\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,182 @@
+/// Throughput of the ev42 and ev44 parsers on the same synthetic events.
+/// ev42 carries one pulse per message, ev44 several, each of which ends
+/// up in a spill of its own. Spills are drained after every message.
+///
+/// usage: EventParserBenchmark [events_per_pulse] [pulses_per_message] [messages]
+
+#include <producers/ESSStream/ev42_parser.h>
+#include <producers/ESSStream/ev44_parser.h>
+#include "ev42_events_generated.h"
+#include "ev44_events_generated.h"
+#include <core/util/Timer.h>
+
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+using namespace DAQuiri;
+
+using Buffer = std::vector<uint8_t>;
+
+static constexpr uint32_t extent {512};
+static constexpr int64_t pulse_period {71428571};
+
+struct Pulse
+{
+  int64_t time;
+  std::vector<int32_t> tofs;
+  std::vector<int32_t> pixels;
+};
+
+std::vector<Pulse> make_pulses(size_t count, size_t events)
+{
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<int32_t> tof(0, pulse_period - 1);
+  std::uniform_int_distribution<int32_t> pixel(1, extent * extent);
+
+  std::vector<Pulse> ret(count);
+  for (size_t p = 0; p < count; ++p)
+  {
+    ret[p].time = (p + 1) * pulse_period;
+    for (size_t i = 0; i < events; ++i)
+    {
+      ret[p].tofs.push_back(tof(gen));
+      ret[p].pixels.push_back(pixel(gen));
+    }
+  }
+  return ret;
+}
+
+Buffer finish(flatbuffers::FlatBufferBuilder& fbb)
+{
+  return Buffer(fbb.GetBufferPointer(), fbb.GetBufferPointer() + fbb.GetSize());
+}
+
+std::vector<Buffer> make_ev42(const std::vector<Pulse>& pulses)
+{
+  std::vector<Buffer> ret;
+  for (size_t p = 0; p < pulses.size(); ++p)
+  {
+    flatbuffers::FlatBufferBuilder fbb;
+    std::vector<uint32_t> tofs(pulses[p].tofs.begin(), pulses[p].tofs.end());
+    std::vector<uint32_t> pixels(pulses[p].pixels.begin(), pulses[p].pixels.end());
+    auto m = CreateEventMessageDirect(fbb, "bench", p + 1, pulses[p].time,
+                                      &tofs, &pixels);
+    FinishEventMessageBuffer(fbb, m);
+    ret.push_back(finish(fbb));
+  }
+  return ret;
+}
+
+std::vector<Buffer> make_ev44(const std::vector<Pulse>& pulses, size_t per_message)
+{
+  std::vector<Buffer> ret;
+  for (size_t first = 0; first < pulses.size(); first += per_message)
+  {
+    std::vector<int64_t> times;
+    std::vector<int32_t> index;
+    std::vector<int32_t> tofs;
+    std::vector<int32_t> pixels;
+    for (size_t p = first; p < std::min(first + per_message, pulses.size()); ++p)
+    {
+      times.push_back(pulses[p].time);
+      index.push_back(tofs.size());
+      tofs.insert(tofs.end(), pulses[p].tofs.begin(), pulses[p].tofs.end());
+      pixels.insert(pixels.end(), pulses[p].pixels.begin(), pulses[p].pixels.end());
+    }
+
+    flatbuffers::FlatBufferBuilder fbb;
+    auto m = CreateEvent44MessageDirect(fbb, "bench", ret.size() + 1,
+                                        &times, &index, &tofs, &pixels);
+    FinishEvent44MessageBuffer(fbb, m);
+    ret.push_back(finish(fbb));
+  }
+  return ret;
+}
+
+void configure(fb_parser& parser)
+{
+  std::string r {parser.plugin_name()};
+  auto set = parser.settings();
+  set.set(Setting::text(r + "/StreamID", "stream"));
+  set.set(Setting::integer("ESSGeometry/extent_x", extent));
+  set.set(Setting::integer("ESSGeometry/extent_y", extent));
+  set.set(Setting::integer("ESSGeometry/extent_z", 1));
+  set.set(Setting::integer("ESSGeometry/panels", 1));
+  parser.settings(set);
+}
+
+double run(fb_parser& parser, std::vector<Buffer>& messages,
+           size_t& events, size_t& spills)
+{
+  SpillMultiqueue queue(false, 1000);
+  events = spills = 0;
+
+  Timer timer(true);
+  for (auto& m : messages)
+  {
+    parser.process_payload(&queue, m.data());
+    while (queue.size())
+    {
+      auto spill = queue.dequeue();
+      if (spill->type != Spill::Type::running)
+        continue;
+      events += spill->events.size();
+      spills++;
+    }
+  }
+  double secs = timer.s();
+  parser.stop(&queue);
+  return events / secs;
+}
+
+int main(int argc, char** argv)
+{
+  size_t events = 1000;
+  size_t per_message = 14;
+  size_t messages = 200;
+  if (argc > 1)
+    events = std::stoul(argv[1]);
+  if (argc > 2)
+    per_message = std::stoul(argv[2]);
+  if (argc > 3)
+    messages = std::stoul(argv[3]);
+
+  auto pulses = make_pulses(per_message * messages, events);
+  auto ev42 = make_ev42(pulses);
+  auto ev44 = make_ev44(pulses, per_message);
+
+  ev42_events p42;
+  configure(p42);
+  ev44_events p44;
+  configure(p44);
+
+  std::cout << "events/pulse: " << events << "  pulses/ev44 message: " << per_message
+            << "  pulses: " << pulses.size() << "\n";
+  std::cout << std::setw(8) << "schema"
+            << std::setw(12) << "messages"
+            << std::setw(12) << "spills"
+            << std::setw(20) << "[Mevents/s]"
+            << std::setw(10) << "speedup" << "\n";
+
+  size_t count42 {0}, spills42 {0};
+  double rate42 = run(p42, ev42, count42, spills42);
+  size_t count44 {0}, spills44 {0};
+  double rate44 = run(p44, ev44, count44, spills44);
+
+  if ((count42 != count44) || (spills42 != spills44))
+    std::cerr << "output mismatch\n";
+
+  std::cout << std::setw(8) << "ev42"
+            << std::setw(12) << ev42.size()
+            << std::setw(12) << spills42
+            << std::setw(20) << std::fixed << std::setprecision(2) << (rate42 / 1e6)
+            << std::setw(10) << 1.0 << "\n";
+  std::cout << std::setw(8) << "ev44"
+            << std::setw(12) << ev44.size()
+            << std::setw(12) << spills44
+            << std::setw(20) << std::fixed << std::setprecision(2) << (rate44 / 1e6)
+            << std::setw(10) << (rate44 / rate42) << "\n";
+
+  return 0;
+}
@@ -0,0 +1,79 @@
+/// Zoomed-out refresh of a large dense 2D histogram: between refreshes a
+/// batch of events is added, then the whole image is fetched either at full
+/// resolution or as one coarse pyramid level through read_level().
+///
+/// usage: PyramidBenchmark [edge] [refreshes] [events_per_refresh]
+
+#include <consumers/dataspaces/Adaptive2D.h>
+#include <core/util/Timer.h>
+
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+using namespace DAQuiri;
+
+double run(Adaptive2D& space, uint16_t level, size_t refreshes,
+           size_t events, double& sum)
+{
+  std::mt19937_64 gen(7);
+  std::uniform_int_distribution<size_t> bin(0, space.axis(0).bounds().second);
+  std::vector<size_t> coords(2 * events);
+
+  DataBlock block;
+  Timer timer(true);
+  for (size_t i = 0; i < refreshes; ++i)
+  {
+    for (auto& c : coords)
+      c = bin(gen);
+    space.add_ones(coords);
+    space.read_level(block, level, {});
+    block.for_each([&sum](const Coords&, double count)
+                   {
+                     sum += count;
+                   });
+  }
+  return refreshes / timer.s();
+}
+
+int main(int argc, char** argv)
+{
+  size_t edge = 4096;
+  size_t refreshes = 10;
+  size_t events = 10000;
+  if (argc > 1)
+    edge = std::stoul(argv[1]);
+  if (argc > 2)
+    refreshes = std::stoul(argv[2]);
+  if (argc > 3)
+    events = std::stoul(argv[3]);
+
+  Adaptive2D space;
+  for (size_t x = 0; x < edge; ++x)
+    for (size_t y = 0; y < edge; ++y)
+      space.add_one({x, y});
+  space.recalc_axes();
+
+  std::cout << "grid: " << edge << "x" << edge << "  refreshes: " << refreshes
+            << "  events/refresh: " << events << "\n";
+  std::cout << std::setw(8) << "level"
+            << std::setw(14) << "bins"
+            << std::setw(20) << "[refreshes/s]"
+            << std::setw(10) << "speedup" << "\n";
+
+  double full = 0;
+  for (uint16_t level : {0, 1, 2, 3})
+  {
+    double sum = 0;
+    double rate = run(space, level, refreshes, events, sum);
+    if (!level)
+      full = rate;
+    std::cout << std::setw(8) << level
+              << std::setw(14) << ((edge >> level) * (edge >> level))
+              << std::setw(20) << std::fixed << std::setprecision(1) << rate
+              << std::setw(10) << std::setprecision(2) << (rate / full)
+              << "\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,94 @@
+/// Throughput of one Histogram2D filled from large spills, with its
+/// "shards" attribute set to 1, 2, 4 ... threads. Partial data is merged
+/// once at the end, when data() is read.
+///
+/// usage: ShardedFillBenchmark [edge] [events_per_spill] [spills] [max_shards]
+
+#include <consumers/Histogram2D.h>
+#include <core/util/Timer.h>
+
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <thread>
+
+using namespace DAQuiri;
+
+Spill make_spill(size_t edge, size_t events)
+{
+  Spill spill("stream", Spill::Type::running);
+  spill.event_model.add_value("x", 16);
+  spill.event_model.add_value("y", 16);
+  spill.events.reserve(events, spill.event_model);
+
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<uint32_t> bin(0, edge - 1);
+  for (size_t i = 0; i < events; ++i)
+  {
+    spill.events.last().set_value(0, bin(gen));
+    spill.events.last().set_value(1, bin(gen));
+    ++spill.events;
+  }
+  spill.events.finalize();
+  return spill;
+}
+
+double run(const Spill& spill, size_t spills, size_t shards, double& total)
+{
+  Histogram2D h;
+  h.set_attribute(Setting::text("stream_id", "stream"));
+  auto vx = h.metadata().get_attribute("value_latch/value_id", 0);
+  vx.set_text("x");
+  h.set_attribute(vx);
+  auto vy = h.metadata().get_attribute("value_latch/value_id", 1);
+  vy.set_text("y");
+  h.set_attribute(vy);
+  h.set_attribute(Setting::integer("shards", shards));
+
+  Timer timer(true);
+  for (size_t i = 0; i < spills; ++i)
+    h.push_spill(spill);
+  total = to_double(h.data()->total_count());
+  return (spills * spill.events.size()) / timer.s();
+}
+
+int main(int argc, char** argv)
+{
+  size_t edge = 1024;
+  size_t events = 100000;
+  size_t spills = 50;
+  size_t max_shards = std::max(2u, std::thread::hardware_concurrency());
+  if (argc > 1)
+    edge = std::stoul(argv[1]);
+  if (argc > 2)
+    events = std::stoul(argv[2]);
+  if (argc > 3)
+    spills = std::stoul(argv[3]);
+  if (argc > 4)
+    max_shards = std::stoul(argv[4]);
+
+  auto spill = make_spill(edge, events);
+
+  std::cout << "grid: " << edge << "x" << edge << "  events/spill: " << events
+            << "  spills: " << spills << "\n";
+  std::cout << std::setw(8) << "shards"
+            << std::setw(20) << "[Mevents/s]"
+            << std::setw(10) << "speedup" << "\n";
+
+  double single = 0;
+  for (size_t shards = 1; shards <= max_shards; shards *= 2)
+  {
+    double total = 0;
+    double rate = run(spill, spills, shards, total);
+    if (total != double(spills * events))
+      std::cerr << "count mismatch\n";
+    if (shards == 1)
+      single = rate;
+    std::cout << std::setw(8) << shards
+              << std::setw(20) << std::fixed << std::setprecision(2) << (rate / 1e6)
+              << std::setw(10) << (rate / single)
+              << "\n";
+  }
+
+  return 0;
+}
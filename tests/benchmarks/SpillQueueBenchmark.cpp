@@ -0,0 +1,154 @@
+/// Contention benchmark: several producer threads feeding one consumer
+/// through SpillMultiqueue, compared against the previous single-mutex
+/// design (reproduced below as MutexMultiqueue).
+///
+/// usage: SpillQueueBenchmark [spills_per_producer] [max_producers]
+
+#include <core/SpillDequeue.h>
+#include <core/util/Timer.h>
+
+#include <iostream>
+#include <iomanip>
+#include <thread>
+
+using namespace DAQuiri;
+
+class MutexMultiqueue
+{
+ public:
+  MutexMultiqueue(bool drop, size_t max_buffers)
+      : drop_(drop), max_buffers_(max_buffers) {}
+
+  void enqueue(const SpillPtr& data)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto& s = streams_[data->stream_id];
+    if (drop_ && (data->type == Spill::Type::running) &&
+        (s.running >= max_buffers_))
+    {
+      dropped_spills_++;
+      return;
+    }
+    if (data->type == Spill::Type::running)
+      s.running++;
+    s.queue.push_back(data);
+    size_++;
+    cond_.notify_one();
+  }
+
+  SpillPtr dequeue()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!size_ && !stop_)
+      cond_.wait(lock);
+    if (stop_)
+      return nullptr;
+
+    Stream* earliest {nullptr};
+    for (auto& s : streams_)
+      if (!s.second.queue.empty() &&
+          (!earliest || (s.second.queue.front()->time < earliest->queue.front()->time)))
+        earliest = &s.second;
+
+    SpillPtr ret = earliest->queue.front();
+    earliest->queue.pop_front();
+    if (ret->type == Spill::Type::running)
+      earliest->running--;
+    size_--;
+    return ret;
+  }
+
+  void stop()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stop_ = true;
+    cond_.notify_all();
+  }
+
+ private:
+  struct Stream
+  {
+    std::deque<SpillPtr> queue;
+    size_t running {0};
+  };
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool stop_ {false};
+  std::map<std::string, Stream> streams_;
+  size_t size_ {0};
+  size_t dropped_spills_ {0};
+  bool drop_ {false};
+  size_t max_buffers_ {10};
+};
+
+template<typename Queue>
+double run(size_t producers, size_t spills)
+{
+  // prepare spills up front so only queue operations are timed
+  std::vector<std::vector<SpillPtr>> input(producers);
+  auto t0 = std::chrono::system_clock::now();
+  for (size_t p = 0; p < producers; ++p)
+    for (size_t i = 0; i < spills; ++i)
+    {
+      auto s = std::make_shared<Spill>("stream" + std::to_string(p),
+                                       Spill::Type::running);
+      s->time = t0 + std::chrono::microseconds(i);
+      input[p].push_back(s);
+    }
+
+  Queue queue(false, 1000);
+  size_t total = producers * spills;
+
+  Timer timer(true);
+  std::thread consumer([&queue, total]
+                       {
+                         for (size_t i = 0; i < total; ++i)
+                           queue.dequeue();
+                       });
+
+  std::vector<std::thread> threads;
+  for (size_t p = 0; p < producers; ++p)
+    threads.emplace_back([&queue, &input, p]
+                         {
+                           for (const auto& s : input[p])
+                             queue.enqueue(s);
+                         });
+
+  for (auto& t : threads)
+    t.join();
+  consumer.join();
+  double secs = timer.s();
+  queue.stop();
+
+  return total / secs;
+}
+
+int main(int argc, char** argv)
+{
+  size_t spills = 200000;
+  size_t max_producers = std::max(2u, std::thread::hardware_concurrency() - 1);
+  if (argc > 1)
+    spills = std::stoul(argv[1]);
+  if (argc > 2)
+    max_producers = std::stoul(argv[2]);
+
+  std::cout << "spills per producer: " << spills << "\n";
+  std::cout << std::setw(10) << "producers"
+            << std::setw(20) << "mutex [spills/s]"
+            << std::setw(20) << "rings [spills/s]"
+            << std::setw(10) << "speedup" << "\n";
+
+  for (size_t p = 1; p <= max_producers; p *= 2)
+  {
+    double locked = run<MutexMultiqueue>(p, spills);
+    double lockfree = run<SpillMultiqueue>(p, spills);
+    std::cout << std::setw(10) << p
+              << std::setw(20) << std::fixed << std::setprecision(0) << locked
+              << std::setw(20) << lockfree
+              << std::setw(10) << std::setprecision(2) << (lockfree / locked)
+              << "\n";
+  }
+
+  return 0;
+}
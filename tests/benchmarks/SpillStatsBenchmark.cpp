@@ -0,0 +1,79 @@
+/// Per-spill cost of carrying the well-known clocks and counters:
+/// populating them in the state Setting tree and looking them up by name
+/// (as before), against the typed SpillStats slots.
+///
+/// usage: SpillStatsBenchmark [spills]
+
+#include <consumers/add_ons/Status.h>
+#include <core/util/Timer.h>
+
+#include <iostream>
+#include <iomanip>
+
+using namespace DAQuiri;
+
+static const std::vector<SpillStats::Field> fields
+    {SpillStats::native_time, SpillStats::live_time, SpillStats::pulse_time,
+     SpillStats::dropped_buffers, SpillStats::queue_size};
+
+double run_tree(size_t spills)
+{
+  double sink {0};
+  Timer timer(true);
+  for (size_t i = 0; i < spills; ++i)
+  {
+    Spill spill("stream", Spill::Type::running);
+    spill.state = Setting::stem("stats");
+    for (auto f : fields)
+      spill.state.branches.add_a(Setting::precise(SpillStats::name(f), i));
+    auto status = Status::extract(spill);
+    PreciseFloat v {0};
+    if (spill.find_stat(SpillStats::pulse_time, v))
+      sink += to_double(v);
+    sink += to_double(status.stats.get(SpillStats::live_time));
+  }
+  double secs = timer.s();
+  if (sink < 0)
+    std::cout << sink;
+  return spills / secs;
+}
+
+double run_typed(size_t spills)
+{
+  double sink {0};
+  Timer timer(true);
+  for (size_t i = 0; i < spills; ++i)
+  {
+    Spill spill("stream", Spill::Type::running);
+    for (auto f : fields)
+      spill.stats.set(f, i);
+    auto status = Status::extract(spill);
+    PreciseFloat v {0};
+    if (spill.find_stat(SpillStats::pulse_time, v))
+      sink += to_double(v);
+    sink += to_double(status.stats.get(SpillStats::live_time));
+  }
+  double secs = timer.s();
+  if (sink < 0)
+    std::cout << sink;
+  return spills / secs;
+}
+
+int main(int argc, char** argv)
+{
+  size_t spills = 200000;
+  if (argc > 1)
+    spills = std::stoul(argv[1]);
+
+  double tree = run_tree(spills);
+  double typed = run_typed(spills);
+
+  std::cout << "spills: " << spills << "\n";
+  std::cout << std::setw(20) << "tree [spills/s]"
+            << std::setw(20) << "typed [spills/s]"
+            << std::setw(10) << "speedup" << "\n";
+  std::cout << std::setw(20) << std::fixed << std::setprecision(0) << tree
+            << std::setw(20) << typed
+            << std::setw(10) << std::setprecision(2) << (typed / tree) << "\n";
+  return 0;
+}
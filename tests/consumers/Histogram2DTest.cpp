@@ -128,3 +128,49 @@ TEST_F(Histogram2D, Clone)
   EXPECT_EQ(data->rbegin()->first[1], 2UL);
   EXPECT_EQ(data->rbegin()->second, 2);
 }
+
+TEST_F(Histogram2D, Shards)
+{
+  DAQuiri::Spill big{"stream", DAQuiri::Spill::Type::running};
+  big.event_model = s.event_model;
+  big.events.reserve(20000, big.event_model);
+  for (size_t i = 0; i < 20000; ++i)
+  {
+    big.events.last().set_value(0, i % 50);
+    big.events.last().set_value(1, i % 37);
+    ++big.events;
+  }
+  big.events.finalize();
+
+  auto sharded = std::shared_ptr<DAQuiri::Histogram2D>(h.clone());
+  sharded->set_attribute(DAQuiri::Setting::integer("shards", 4));
+
+  h.push_spill(big);
+  sharded->push_spill(big);
+  sharded->push_spill(big);
+  EXPECT_EQ(sharded->metadata().get_attribute("total_count").get_number(), 40000);
+
+  // partials not merged yet survive copying
+  auto copy = std::shared_ptr<DAQuiri::Histogram2D>(sharded->clone());
+
+  h.push_spill(big);
+  auto expected = h.data()->range({});
+  for (auto c : {sharded, copy})
+  {
+    auto data = c->data();
+    EXPECT_EQ(data->total_count(), 40000);
+    auto got = data->range({});
+    ASSERT_EQ(got->size(), expected->size());
+    auto e = expected->begin();
+    for (auto g = got->begin(); g != got->end(); ++g, ++e)
+    {
+      EXPECT_EQ(g->first, e->first);
+      EXPECT_EQ(g->second, e->second);
+    }
+  }
+
+  // back to a single thread, nothing lost
+  sharded->push_spill(big);
+  sharded->set_attribute(DAQuiri::Setting::integer("shards", 1));
+  EXPECT_EQ(sharded->data()->total_count(), 60000);
+}
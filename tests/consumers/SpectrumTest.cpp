@@ -41,7 +41,7 @@ class MockSpectrum : public DAQuiri::Spectrum
     void _recalc_axes() override {}
 
     //event processing
-    void _push_event(const DAQuiri::Event&) override
+    void _push_event(const DAQuiri::EventView&) override
     {
       if (accept_events)
         data_->add_one({});
@@ -112,6 +112,11 @@ TEST_F(TOF1DCorrelate, LatchesChopperStream)
   EXPECT_EQ(h.metadata().get_attribute("total_count").get_number(), 0);
 }
 
+TEST_F(TOF1DCorrelate, SubscribesToBothStreams)
+{
+  EXPECT_EQ(h.streams(), std::set<std::string>({"stream", "chopper_stream"}));
+}
+
 TEST_F(TOF1DCorrelate, ZeroResolutionBinsNothing)
 {
   h.set_attribute(DAQuiri::Setting::floating("time_resolution", 0));
@@ -112,6 +112,96 @@ TEST_F(TOF1D, FilterByValue)
   EXPECT_EQ(h.metadata().get_attribute("total_count").get_number(), 1);
 }
 
+TEST_F(TOF1D, HistogramsColumnsWithoutDecoding)
+{
+  static const std::vector<uint32_t> times {0, 10, 10};
+  static const std::vector<uint32_t> ids {0, 15, 30};
+  s.events.clear();
+  s.columns = std::make_shared<DAQuiri::EventColumns>(
+      nullptr, times.data(), ids.data(), times.size(), 10, nullptr);
+
+  h.push_spill(s);
+
+  EXPECT_EQ(h.metadata().get_attribute("total_count").get_number(), 3);
+  EXPECT_FALSE(s.columns->decoded());
+  EXPECT_EQ(h.data()->get({10}), 2);
+}
+
+TEST_F(TOF1D, FilterDecodesColumns)
+{
+  static const std::vector<uint32_t> times {0, 10, 10};
+  static const std::vector<uint32_t> ids {0, 15, 30};
+  s.events.clear();
+  s.columns = std::make_shared<DAQuiri::EventColumns>(
+      nullptr, times.data(), ids.data(), times.size(), 10,
+      [](DAQuiri::EventRef& e, uint32_t id)
+      {
+        e.set_value(0, id);
+        return true;
+      });
+
+  h.set_attribute(DAQuiri::Setting::integer("filter_count", 1));
+  auto fe = DAQuiri::Setting::boolean("filter/enabled", true);
+  fe.set_indices({0});
+  h.set_attribute(fe);
+  auto fn = DAQuiri::Setting::text("filter/value_id", "val");
+  fn.set_indices({0});
+  h.set_attribute(fn);
+  auto fmin = DAQuiri::Setting::integer("filter/min", 10);
+  fmin.set_indices({0});
+  h.set_attribute(fmin);
+  auto fmax= DAQuiri::Setting::integer("filter/max", 20);
+  fmax.set_indices({0});
+  h.set_attribute(fmax);
+
+  h.push_spill(s);
+
+  EXPECT_TRUE(s.columns->decoded());
+  EXPECT_EQ(h.metadata().get_attribute("total_count").get_number(), 1);
+}
+
+TEST_F(TOF1D, ColumnsSkipInvalidIds)
+{
+  static const std::vector<uint32_t> times {0, 10, 10};
+  static const std::vector<uint32_t> ids {0, 15, 30};
+  s.events.clear();
+  s.columns = std::make_shared<DAQuiri::EventColumns>(
+      nullptr, times.data(), ids.data(), times.size(), 10,
+      [](DAQuiri::EventRef& e, uint32_t id)
+      {
+        e.set_value(0, id);
+        return (id != 0);
+      },
+      [](uint32_t id) { return (id != 0); });
+
+  h.push_spill(s);
+
+  EXPECT_FALSE(s.columns->decoded());
+  EXPECT_EQ(h.metadata().get_attribute("total_count").get_number(), 2);
+  EXPECT_EQ(h.data()->get({0}), 0);
+  EXPECT_EQ(h.data()->get({10}), 2);
+}
+
+TEST_F(TOF1D, RejectingDecoderWithoutValidatorDecodes)
+{
+  static const std::vector<uint32_t> times {0, 10, 10};
+  static const std::vector<uint32_t> ids {0, 15, 30};
+  s.events.clear();
+  s.columns = std::make_shared<DAQuiri::EventColumns>(
+      nullptr, times.data(), ids.data(), times.size(), 10,
+      [](DAQuiri::EventRef& e, uint32_t id)
+      {
+        e.set_value(0, id);
+        return (id != 0);
+      });
+
+  h.push_spill(s);
+
+  EXPECT_TRUE(s.columns->decoded());
+  EXPECT_EQ(h.metadata().get_attribute("total_count").get_number(), 2);
+  EXPECT_EQ(h.data()->get({10}), 2);
+}
+
 //TODO: test other time units
 //TODO: test data axes
 
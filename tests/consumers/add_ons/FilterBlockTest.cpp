@@ -91,6 +91,32 @@ TEST(FilterBlock, AcceptValid)
   EXPECT_FALSE(h.accept(e));
 }
 
+TEST(FilterBlock, SelectValid)
+{
+  FilterBlock h;
+  h.filters_.resize(1);
+  h.filters_[0].enabled_ = true;
+  h.filters_[0].name_ = "val";
+  h.filters_[0].min_ = 7;
+  h.filters_[0].max_ = 42;
+
+  Spill s;
+  s.event_model.add_value("val", 100);
+  h.configure(s);
+
+  s.events.reserve(4, s.event_model);
+  for (auto v : {6, 7, 42, 43})
+  {
+    s.events.last().set_value(0, v);
+    ++s.events;
+  }
+  s.events.finalize();
+
+  std::vector<uint8_t> selected;
+  h.select(s.events, selected);
+  EXPECT_EQ(selected, std::vector<uint8_t>({0, 1, 1, 0}));
+}
+
 TEST(FilterBlock, InvalidAcceptsAll)
 {
   FilterBlock h;
@@ -143,16 +143,16 @@ TEST_F(PeriodicTrigger, UseNative)
 
   DAQuiri::Status s1;
   s1.valid = true;
-  s1.stats["native_time"] = DAQuiri::Setting::precise("native_time", 0);
+  s1.stats.set(DAQuiri::SpillStats::native_time, 0);
   pt.update(s1);
 
   auto s2 = s1;
-  s2.stats["native_time"] = DAQuiri::Setting::precise("native_time", 5000);
+  s2.stats.set(DAQuiri::SpillStats::native_time, 5000);
   pt.update(s2);
   EXPECT_EQ(pt.recent_time_, std::chrono::microseconds(5));
 
   auto s3 = s2;
-  s3.stats["native_time"] = DAQuiri::Setting::precise("native_time", 15000);
+  s3.stats.set(DAQuiri::SpillStats::native_time, 15000);
   pt.update(s3);
   EXPECT_EQ(std::chrono::duration_cast<std::chrono::microseconds>(pt.recent_time_),
       std::chrono::microseconds(15));
@@ -170,7 +170,7 @@ TEST_F(PeriodicTrigger, UseNativePathological)
 
   DAQuiri::Status s1;
   s1.valid = true;
-  s1.stats["native_time"] = DAQuiri::Setting::precise("native_time", 0);
+  s1.stats.set(DAQuiri::SpillStats::native_time, 0);
   pt.update(s1);
   EXPECT_EQ(pt.recent_time_, std::chrono::milliseconds(0));
 
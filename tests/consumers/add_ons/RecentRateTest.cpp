@@ -56,7 +56,7 @@ TEST_F(RecentRate, OneStatusResultsZero)
 {
   rr.divisor_clock = "live_time";
 
-  s.stats["live_time"] = DAQuiri::Setting::floating("live_time", 1 * pow(10, 9));
+  s.stats.set(DAQuiri::SpillStats::live_time, 1 * pow(10, 9));
 
   rr.update(s, 1000);
 
@@ -67,7 +67,7 @@ TEST_F(RecentRate, IdenticalStatusesResultZero)
 {
   rr.divisor_clock = "live_time";
 
-  s.stats["live_time"] = DAQuiri::Setting::floating("live_time", 1 * pow(10, 9));
+  s.stats.set(DAQuiri::SpillStats::live_time, 1 * pow(10, 9));
   rr.update(s, 0);
   rr.update(s, 1000);
 
@@ -78,10 +78,10 @@ TEST_F(RecentRate, OneSecondDifference)
 {
   rr.divisor_clock = "live_time";
 
-  s.stats["live_time"] = DAQuiri::Setting::floating("live_time", 1 * pow(10, 9));
+  s.stats.set(DAQuiri::SpillStats::live_time, 1 * pow(10, 9));
   rr.update(s, 0);
 
-  s.stats["live_time"] = DAQuiri::Setting::floating("live_time", 2 * pow(10, 9));
+  s.stats.set(DAQuiri::SpillStats::live_time, 2 * pow(10, 9));
   rr.update(s, 1000);
 
   EXPECT_EQ(rr.current_rate, 1000);
@@ -91,13 +91,13 @@ TEST_F(RecentRate, SubsequentUpdates)
 {
   rr.divisor_clock = "live_time";
 
-  s.stats["live_time"] = DAQuiri::Setting::floating("live_time", 1 * pow(10, 9));
+  s.stats.set(DAQuiri::SpillStats::live_time, 1 * pow(10, 9));
   rr.update(s, 0);
 
-  s.stats["live_time"] = DAQuiri::Setting::floating("live_time", 2 * pow(10, 9));
+  s.stats.set(DAQuiri::SpillStats::live_time, 2 * pow(10, 9));
   rr.update(s, 1000);
 
-  s.stats["live_time"] = DAQuiri::Setting::floating("live_time", 3 * pow(10, 9));
+  s.stats.set(DAQuiri::SpillStats::live_time, 3 * pow(10, 9));
   rr.update(s, 1500);
 
   EXPECT_EQ(rr.current_rate, 500);
@@ -107,10 +107,10 @@ TEST_F(RecentRate, NoDifferenceInCounts)
 {
   rr.divisor_clock = "live_time";
 
-  s.stats["live_time"] = DAQuiri::Setting::floating("live_time", 1 * pow(10, 9));
+  s.stats.set(DAQuiri::SpillStats::live_time, 1 * pow(10, 9));
   rr.update(s, 1000);
 
-  s.stats["live_time"] = DAQuiri::Setting::floating("live_time", 2 * pow(10, 9));
+  s.stats.set(DAQuiri::SpillStats::live_time, 2 * pow(10, 9));
   rr.update(s, 1000);
 
   EXPECT_EQ(rr.current_rate, 0);
@@ -120,10 +120,10 @@ TEST_F(RecentRate, ReturnsSettingValue)
 {
   rr.divisor_clock = "live_time";
 
-  s.stats["live_time"] = DAQuiri::Setting::floating("live_time", 1 * pow(10, 9));
+  s.stats.set(DAQuiri::SpillStats::live_time, 1 * pow(10, 9));
   rr.update(s, 0);
 
-  s.stats["live_time"] = DAQuiri::Setting::floating("live_time", 2 * pow(10, 9));
+  s.stats.set(DAQuiri::SpillStats::live_time, 2 * pow(10, 9));
   auto ret = rr.update(s, 1000);
 
   EXPECT_EQ(ret.id(), "recent_live_time_rate");
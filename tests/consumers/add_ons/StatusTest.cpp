@@ -32,10 +32,36 @@ TEST(Status, ExtractWithTimes)
   Status s = Status::extract(spill);
 
   EXPECT_TRUE(s.valid);
-  EXPECT_TRUE(s.stats.count("native_time"));
-  EXPECT_EQ(s.stats["native_time"].get_int(), 1000);
-  EXPECT_TRUE(s.stats.count("live_time"));
-  EXPECT_EQ(s.stats["live_time"].get_int(), 500);
+  EXPECT_TRUE(s.stats.has(SpillStats::native_time));
+  EXPECT_EQ(s.stats.get(SpillStats::native_time), 1000);
+  EXPECT_TRUE(s.stats.has(SpillStats::live_time));
+  EXPECT_EQ(s.stats.get(SpillStats::live_time), 500);
+}
+
+TEST(Status, ExtractTyped)
+{
+  Spill spill;
+  spill.stats.set(SpillStats::native_time, 1000);
+  spill.state.branches.add_a(Setting::integer("native_time", 7));
+
+  Status s = Status::extract(spill);
+
+  EXPECT_TRUE(s.stats.has(SpillStats::native_time));
+  EXPECT_EQ(s.stats.get(SpillStats::native_time), 1000);
+  EXPECT_FALSE(s.stats.has(SpillStats::live_time));
+}
+
+TEST(Status, CalcDiffByField)
+{
+  Spill spill;
+  spill.stats.set(SpillStats::native_time, 10000);
+  Status s = Status::extract(spill);
+
+  spill.stats.set(SpillStats::native_time, 30000);
+  Status s2 = Status::extract(spill);
+
+  EXPECT_EQ(Status::calc_diff(s, s2, SpillStats::native_time), std::chrono::microseconds(20));
+  EXPECT_EQ(Status::calc_diff(s, s2, SpillStats::live_time), hr_duration_t());
 }
 
 TEST(Status, CalcDiffBothIllegal)
@@ -58,6 +58,26 @@ TEST_F(ValueLatch, ExtractWithDownsample)
   EXPECT_EQ(result, 4UL);
 }
 
+TEST_F(ValueLatch, ExtractBuffer)
+{
+  s.event_model.add_value("val2", 100);
+  s.event_model.add_value("val", 100);
+  vl.configure(s);
+  vl.downsample = 2;
+
+  s.events.reserve(3, s.event_model);
+  for (uint32_t v : {4, 8, 17})
+  {
+    s.events.last().set_value(1, v);
+    ++s.events;
+  }
+  s.events.finalize();
+
+  std::vector<size_t> result;
+  vl.extract(result, s.events);
+  EXPECT_EQ(result, std::vector<size_t>({1, 2, 4}));
+}
+
 TEST_F(ValueLatch, GetSettings)
 {
   vl.value_id = "val";
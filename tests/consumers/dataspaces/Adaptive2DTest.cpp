@@ -0,0 +1,465 @@
+#include "gtest_color_print.h"
+
+#include <consumers/dataspaces/Adaptive2D.h>
+#include <consumers/dataspaces/SparseMap2D.h>
+#include <consumers/dataspaces/SparseMatrix2D.h>
+
+class Adaptive2D : public TestBase
+{
+  protected:
+    DAQuiri::Adaptive2D d;
+};
+
+TEST_F(Adaptive2D, Init)
+{
+  EXPECT_TRUE(d.empty());
+  EXPECT_EQ(d.dimensions(), 2);
+  EXPECT_EQ(d.total_count(), 0);
+}
+
+TEST_F(Adaptive2D, AddOne)
+{
+  d.add_one({0, 0});
+  EXPECT_FALSE(d.empty());
+  EXPECT_EQ(d.total_count(), 1);
+
+  d.add_one({0, 0});
+  EXPECT_EQ(d.total_count(), 2);
+}
+
+TEST_F(Adaptive2D, Get)
+{
+  EXPECT_EQ(d.get({0, 0}), 0);
+  d.add_one({0, 0});
+  EXPECT_EQ(d.get({0, 0}), 1);
+
+  EXPECT_EQ(d.get({1, 1}), 0);
+  d.add_one({1, 1});
+  EXPECT_EQ(d.get({1, 1}), 1);
+}
+
+TEST_F(Adaptive2D, Add)
+{
+  d.add({{0, 0}, 3});
+  EXPECT_EQ(d.get({0, 0}), 3);
+
+  d.add({{0, 0}, 5});
+  EXPECT_EQ(d.get({0, 0}), 8);
+}
+
+TEST_F(Adaptive2D, AddOnes)
+{
+  d.add_ones({0, 0, 1, 2, 1, 2});
+  EXPECT_EQ(d.total_count(), 3);
+  EXPECT_EQ(d.get({0, 0}), 1);
+  EXPECT_EQ(d.get({1, 2}), 2);
+}
+
+TEST_F(Adaptive2D, AddMany)
+{
+  d.add_many({0, 0, 1, 2, 1, 2}, {3, 0, 5});
+  EXPECT_EQ(d.total_count(), 8);
+  EXPECT_EQ(d.get({0, 0}), 3);
+  EXPECT_EQ(d.get({1, 2}), 5);
+}
+
+TEST_F(Adaptive2D, Clear)
+{
+  d.add({{0, 0}, 3});
+  EXPECT_EQ(d.total_count(), 3);
+
+  d.clear();
+  EXPECT_EQ(d.total_count(), 0);
+  EXPECT_TRUE(d.empty());
+}
+
+TEST_F(Adaptive2D, Range)
+{
+  d.add_one({0, 0});
+  EXPECT_EQ(d.range({})->at(0).second, 1);
+  EXPECT_EQ(d.range({})->at(0).first[0], 0UL);
+  EXPECT_EQ(d.range({})->at(0).first[1], 0UL);
+
+  d.add_one({1, 1});
+  EXPECT_EQ(d.range({})->at(1).second, 1);
+  EXPECT_EQ(d.range({})->at(1).first[0], 1UL);
+  EXPECT_EQ(d.range({})->at(1).first[1], 1UL);
+}
+
+TEST_F(Adaptive2D, Clone)
+{
+  d.add_one({0, 0});
+  d.add_one({1, 1});
+
+  auto d2 = std::shared_ptr<DAQuiri::Dataspace>(d.clone());
+  EXPECT_EQ(d2->range({})->at(0).second, 1);
+  EXPECT_EQ(d2->range({})->at(0).first[0], 0UL);
+  EXPECT_EQ(d2->range({})->at(0).first[1], 0UL);
+  EXPECT_EQ(d2->range({})->at(1).second, 1);
+  EXPECT_EQ(d2->range({})->at(1).first[0], 1UL);
+  EXPECT_EQ(d2->range({})->at(1).first[1], 1UL);
+  EXPECT_EQ(d2->dimensions(), 2);
+  EXPECT_EQ(d2->total_count(), 2);
+}
+
+TEST_F(Adaptive2D, CalcAxes)
+{
+  d.add_one({0, 0});
+  EXPECT_TRUE(d.axis(0).domain.empty());
+  EXPECT_TRUE(d.axis(1).domain.empty());
+  d.recalc_axes();
+  EXPECT_EQ(d.axis(0).domain.size(), 1UL);
+  EXPECT_EQ(d.axis(1).domain.size(), 1UL);
+
+  d.add_one({1, 1});
+  EXPECT_EQ(d.axis(0).domain.size(), 1UL);
+  EXPECT_EQ(d.axis(1).domain.size(), 1UL);
+  d.recalc_axes();
+  EXPECT_EQ(d.axis(0).domain.size(), 2UL);
+  EXPECT_EQ(d.axis(1).domain.size(), 2UL);
+}
+
+TEST_F(Adaptive2D, SaveLoadEmpty)
+{
+  auto f = hdf5::file::create("dummy.h5", hdf5::file::AccessFlags::TRUNCATE);
+  auto g = f.root().create_group("empty");
+  d.save(g);
+  d.load(g);
+  EXPECT_TRUE(d.empty());
+}
+
+TEST_F(Adaptive2D, SaveLoadNonempty)
+{
+  d.add({{0, 0}, 3});
+
+  auto f = hdf5::file::create("dummy.h5", hdf5::file::AccessFlags::TRUNCATE);
+  auto g = f.root().create_group("nonempty");
+  d.save(g);
+  d.load(g);
+  EXPECT_FALSE(d.empty());
+  EXPECT_EQ(d.get({0, 0}), 3);
+  EXPECT_EQ(d.total_count(), 3);
+}
+
+TEST_F(Adaptive2D, SaveLoadThrow)
+{
+  hdf5::node::Group g;
+
+  EXPECT_THROW(d.save(g), std::runtime_error);
+  EXPECT_THROW(d.load(g), std::runtime_error);
+}
+
+TEST_F(Adaptive2D, ExportCSV)
+{
+  d.add_one({0, 0});
+  d.add_one({1, 1});
+  d.add_one({2, 2});
+
+  std::stringstream ss;
+  d.export_csv(ss);
+
+  EXPECT_EQ(ss.str(), "1, 0, 0;\n0, 1, 0;\n0, 0, 1;\n");
+}
+
+TEST_F(Adaptive2D, LoadsSparseMatrix2D)
+{
+  DAQuiri::SparseMatrix2D old;
+  for (size_t i = 0; i < 200; ++i)
+    old.add({{i % 37, (i * 7) % 90}, PreciseFloat(i + 1)});
+
+  auto f = hdf5::file::create("dummy.h5", hdf5::file::AccessFlags::TRUNCATE);
+  auto g = f.root().create_group("old");
+  old.save(g);
+  d.load(g);
+
+  EXPECT_EQ(d.total_count(), old.total_count());
+  for (size_t i = 0; i < 200; ++i)
+    EXPECT_EQ(d.get({i % 37, (i * 7) % 90}), old.get({i % 37, (i * 7) % 90}));
+  EXPECT_EQ(d.range({})->size(), old.range({})->size());
+}
+
+TEST_F(Adaptive2D, StartsSparse)
+{
+  EXPECT_EQ(d.representation(), "sparse");
+  d.add_one({1000, 1000});
+  d.add_one({0, 0});
+  EXPECT_FALSE(d.dense());
+  EXPECT_EQ(d.representation(), "sparse");
+}
+
+TEST_F(Adaptive2D, Promotes)
+{
+  // settle the extent, otherwise the first few bins are already dense
+  d.add_one({99, 99});
+  for (size_t i = 0; i < 100; ++i)
+    for (size_t j = 0; j < 100; ++j)
+      if ((i + j) % 10 == 0)
+        d.add({{i, j}, PreciseFloat(i + j + 1)});
+  EXPECT_FALSE(d.dense());
+
+  for (size_t i = 0; i < 100; ++i)
+    for (size_t j = 0; j < 100; ++j)
+      if ((i + j) % 10 == 1)
+        d.add({{i, j}, PreciseFloat(i + j + 1)});
+  EXPECT_TRUE(d.dense());
+  EXPECT_EQ(d.representation(), "dense");
+
+  for (size_t i = 0; i < 100; ++i)
+    for (size_t j = 0; j < 100; ++j)
+      if ((i + j) % 10 < 2)
+      {
+        EXPECT_EQ(d.get({i, j}), i + j + 1);
+      }
+  EXPECT_EQ(d.get({50, 52}), 0);
+  EXPECT_EQ(d.get({99, 99}), 1);
+  EXPECT_EQ(d.range({})->size(), 2001UL);
+}
+
+TEST_F(Adaptive2D, Demotes)
+{
+  for (size_t i = 0; i < 10; ++i)
+    for (size_t j = 0; j < 10; ++j)
+      d.add_one({i, j});
+  EXPECT_TRUE(d.dense());
+  auto dense_range = d.range({});
+
+  d.add_one({5000, 5000});
+  EXPECT_FALSE(d.dense());
+  EXPECT_EQ(d.get({5000, 5000}), 1);
+  EXPECT_EQ(d.get({9, 9}), 1);
+  EXPECT_EQ(d.total_count(), 101);
+
+  auto sparse_range = d.range({{0, 20}, {0, 20}});
+  ASSERT_EQ(sparse_range->size(), dense_range->size());
+  for (size_t i = 0; i < sparse_range->size(); ++i)
+    EXPECT_EQ(sparse_range->at(i), dense_range->at(i));
+}
+
+TEST_F(Adaptive2D, GrowsDense)
+{
+  for (size_t i = 0; i < 100; ++i)
+    for (size_t j = 0; j < 100; ++j)
+      d.add_one({i, j});
+  EXPECT_TRUE(d.dense());
+  EXPECT_EQ(d.range({})->size(), 10000UL);
+  EXPECT_EQ(d.get({99, 99}), 1);
+  EXPECT_EQ(d.get({99, 100}), 0);
+  EXPECT_EQ(d.total_count(), 10000);
+}
+
+TEST_F(Adaptive2D, MemoryFootprint)
+{
+  auto empty = d.memory_footprint();
+  d.add_one({1000, 1000});
+  EXPECT_GT(d.memory_footprint(), empty);
+
+  for (size_t i = 0; i < 1000; ++i)
+    for (size_t j = 0; j < 1000; ++j)
+      d.add_one({i, j});
+  EXPECT_TRUE(d.dense());
+  // 1024 x 1024 uint32 bins, no hash table left over
+  EXPECT_LT(d.memory_footprint(), 1024UL * 1024 * 4 + 4096);
+
+  d.clear();
+  EXPECT_FALSE(d.dense());
+  EXPECT_EQ(d.memory_footprint(), empty);
+}
+
+TEST_F(Adaptive2D, SaveLoadDense)
+{
+  for (size_t i = 0; i < 20; ++i)
+    for (size_t j = 0; j < 30; ++j)
+      d.add({{i, j}, PreciseFloat(i * j + 1)});
+  EXPECT_TRUE(d.dense());
+
+  auto f = hdf5::file::create("dummy.h5", hdf5::file::AccessFlags::TRUNCATE);
+  auto g = f.root().create_group("dense");
+  d.save(g);
+
+  DAQuiri::SparseMatrix2D other;
+  other.load(g);
+  EXPECT_EQ(other.total_count(), d.total_count());
+  EXPECT_EQ(other.get({19, 29}), 19 * 29 + 1);
+
+  DAQuiri::Adaptive2D d2;
+  d2.load(g);
+  EXPECT_TRUE(d2.dense());
+  EXPECT_EQ(d2.total_count(), d.total_count());
+  EXPECT_EQ(d2.get({19, 29}), 19 * 29 + 1);
+}
+
+TEST_F(Adaptive2D, ReadRange)
+{
+  d.add_one({1000, 0});
+  d.add({{1, 1}, 3});
+  EXPECT_FALSE(d.dense());
+
+  DAQuiri::DataBlock block;
+  d.read_range(block, {{0, 10}, {0, 10}});
+  EXPECT_EQ(block.layout, DAQuiri::DataBlock::Layout::sparse);
+  ASSERT_EQ(block.size(), 1UL);
+  EXPECT_EQ(block.coords[0][0], 1UL);
+  EXPECT_EQ(block.coords[1][0], 1UL);
+  EXPECT_EQ(block.counts[0], 3);
+
+  d.clear();
+  d.add_one({0, 0});
+  d.add({{1, 2}, 3});
+  EXPECT_TRUE(d.dense());
+  d.read_range(block, {});
+  EXPECT_EQ(block.layout, DAQuiri::DataBlock::Layout::dense);
+  EXPECT_EQ(block.origin, DAQuiri::Coords({0, 0}));
+  EXPECT_EQ(block.shape, DAQuiri::Coords({2, 3}));
+  EXPECT_EQ(block.counts, std::vector<double>({1, 0, 0, 0, 0, 3}));
+
+  d.read_range(block, {{1, 5}, {1, 5}});
+  EXPECT_EQ(block.origin, DAQuiri::Coords({1, 1}));
+  EXPECT_EQ(block.counts, std::vector<double>({0, 3}));
+}
+
+TEST_F(Adaptive2D, RangeSince)
+{
+  d.add_one({1000, 0});
+  d.add_one({3, 3});
+  EXPECT_FALSE(d.dense());
+  auto v = d.version();
+
+  DAQuiri::DataBlock block;
+  EXPECT_TRUE(d.range_since(block, v));
+  EXPECT_TRUE(block.empty());
+
+  d.add_one({5, 5});
+  EXPECT_TRUE(d.range_since(block, v));
+  ASSERT_EQ(block.size(), 1UL);
+  EXPECT_EQ(block.coords[0][0], 5UL);
+
+  // changes survive promotion
+  v = d.version();
+  for (size_t i = 0; i < 400; ++i)
+    for (size_t j = 0; j < 400; ++j)
+      d.add_one({i, j});
+  EXPECT_TRUE(d.dense());
+  d.add_one({999, 7});
+  EXPECT_TRUE(d.range_since(block, v));
+  EXPECT_EQ(block.size(), 400UL * 400 + 1);
+
+  v = d.version();
+  d.add_one({7, 7});
+  EXPECT_TRUE(d.range_since(block, v));
+  EXPECT_EQ(block.size(), 400UL);
+
+  d.clear();
+  d.add_one({1, 1});
+  EXPECT_FALSE(d.range_since(block, v));
+}
+
+TEST_F(Adaptive2D, RangeSinceMerge)
+{
+  d.add_one({1000, 0});
+  d.add_one({3, 3});
+  auto v = d.version();
+
+  auto other = std::shared_ptr<DAQuiri::Dataspace>(d.clone());
+  other->clear();
+  other->add({{5, 5}, 2});
+
+  // only the rows merged into are returned
+  DAQuiri::DataBlock block;
+  d.merge(*other);
+  EXPECT_TRUE(d.range_since(block, v));
+  ASSERT_EQ(block.size(), 1UL);
+  EXPECT_EQ(block.coords[0][0], 5UL);
+  EXPECT_EQ(block.counts[0], 2);
+}
+
+double coarse_sum(const DAQuiri::Dataspace& d, size_t level, size_t x, size_t y)
+{
+  double ret = 0;
+  for (size_t i = x << level; i < ((x + 1) << level); ++i)
+    for (size_t j = y << level; j < ((y + 1) << level); ++j)
+      ret += to_double(d.get({i, j}));
+  return ret;
+}
+
+TEST_F(Adaptive2D, ReadLevel)
+{
+  for (size_t i = 0; i < 60; ++i)
+    for (size_t j = 0; j < 50; ++j)
+      d.add({{i, j}, PreciseFloat((i * 7 + j) % 5)});
+  ASSERT_TRUE(d.dense());
+  EXPECT_TRUE(d.has_levels());
+
+  DAQuiri::DataBlock block;
+  for (uint16_t level = 1; level < 4; ++level)
+  {
+    d.read_level(block, level, {});
+    EXPECT_EQ(block.layout, DAQuiri::DataBlock::Layout::dense);
+    EXPECT_EQ(block.shape, DAQuiri::Coords({(59UL >> level) + 1,
+                                            (49UL >> level) + 1}));
+    block.for_each([&](const DAQuiri::Coords& c, double count)
+                   {
+                     EXPECT_EQ(count, coarse_sum(d, level, c[0], c[1]));
+                   });
+  }
+
+  // cached levels follow changes and growth
+  d.add({{10, 20}, 100});
+  d.add_one({70, 3});
+  for (uint16_t level = 1; level < 4; ++level)
+  {
+    d.read_level(block, level, {});
+    EXPECT_EQ(block.shape[0], (70UL >> level) + 1);
+    block.for_each([&](const DAQuiri::Coords& c, double count)
+                   {
+                     EXPECT_EQ(count, coarse_sum(d, level, c[0], c[1]));
+                   });
+  }
+
+  d.read_level(block, 2, {{8, 15}, {17, 23}});
+  EXPECT_EQ(block.origin, DAQuiri::Coords({2, 4}));
+  EXPECT_EQ(block.shape, DAQuiri::Coords({2, 2}));
+  EXPECT_EQ(block.counts[1], coarse_sum(d, 2, 2, 5));
+
+  auto copy = std::shared_ptr<DAQuiri::Dataspace>(d.clone());
+  copy->read_level(block, 1, {});
+  EXPECT_EQ(block.counts[0], coarse_sum(d, 1, 0, 0));
+}
+
+TEST_F(Adaptive2D, Merge)
+{
+  d.add_one({1000, 0});
+  d.add({{3, 3}, 2});
+  EXPECT_FALSE(d.dense());
+
+  DAQuiri::Adaptive2D o;
+  for (size_t i = 0; i < 20; ++i)
+    for (size_t j = 0; j < 20; ++j)
+      o.add_one({i, j});
+  EXPECT_TRUE(o.dense());
+
+  d.merge(o);
+  EXPECT_EQ(d.get({3, 3}), 3);
+  EXPECT_EQ(d.get({19, 19}), 1);
+  EXPECT_EQ(d.get({1000, 0}), 1);
+  EXPECT_EQ(d.total_count(), 403);
+
+  o.merge(d);
+  EXPECT_EQ(o.get({3, 3}), 4);
+  EXPECT_EQ(o.total_count(), 803);
+
+  // from another type, entry by entry
+  DAQuiri::SparseMap2D s;
+  s.add({{3, 3}, 10});
+  d.merge(s);
+  EXPECT_EQ(d.get({3, 3}), 13);
+  EXPECT_EQ(d.total_count(), 413);
+}
+
+TEST_F(Adaptive2D, Debug)
+{
+  d.add_one({0, 0});
+  d.add_one({1, 1});
+  d.add_one({2, 2});
+
+  MESSAGE() << d.debug() << "\n";
+}
@@ -0,0 +1,304 @@
+#include "gtest_color_print.h"
+#include <consumers/dataspaces/BrickMap3D.h>
+#include <consumers/dataspaces/SparseMap3D.h>
+
+class BrickMap3D : public TestBase
+{
+  protected:
+    DAQuiri::BrickMap3D d;
+};
+
+TEST_F(BrickMap3D, Init)
+{
+  EXPECT_TRUE(d.empty());
+  EXPECT_EQ(d.dimensions(), 3);
+  EXPECT_EQ(d.total_count(), 0);
+}
+
+TEST_F(BrickMap3D, AddOne)
+{
+  d.add_one({0, 0, 0});
+  EXPECT_FALSE(d.empty());
+  EXPECT_EQ(d.total_count(), 1);
+
+  d.add_one({0, 0, 0});
+  EXPECT_EQ(d.total_count(), 2);
+}
+
+TEST_F(BrickMap3D, Get)
+{
+  EXPECT_EQ(d.get({0, 0, 0}), 0);
+  d.add_one({0, 0, 0});
+  EXPECT_EQ(d.get({0, 0, 0}), 1);
+
+  EXPECT_EQ(d.get({1, 1, 1}), 0);
+  d.add_one({1, 1, 1});
+  EXPECT_EQ(d.get({1, 1, 1}), 1);
+}
+
+TEST_F(BrickMap3D, Add)
+{
+  d.add({{0, 0, 0}, 3});
+  EXPECT_EQ(d.get({0, 0, 0}), 3);
+
+  d.add({{0, 0, 0}, 5});
+  EXPECT_EQ(d.get({0, 0, 0}), 8);
+}
+
+TEST_F(BrickMap3D, Clear)
+{
+  d.add({{0, 0, 0}, 3});
+  EXPECT_EQ(d.total_count(), 3);
+
+  d.clear();
+  EXPECT_EQ(d.total_count(), 0);
+  EXPECT_TRUE(d.empty());
+}
+
+TEST_F(BrickMap3D, Range)
+{
+  d.add_one({0, 0, 0});
+  EXPECT_EQ(d.range({})->at(0).second, 1);
+  EXPECT_EQ(d.range({})->at(0).first[0], 0UL);
+  EXPECT_EQ(d.range({})->at(0).first[1], 0UL);
+  EXPECT_EQ(d.range({})->at(0).first[2], 0UL);
+
+  d.add_one({1, 1, 1});
+  EXPECT_EQ(d.range({})->at(1).second, 1);
+  EXPECT_EQ(d.range({})->at(1).first[0], 1UL);
+  EXPECT_EQ(d.range({})->at(1).first[1], 1UL);
+  EXPECT_EQ(d.range({})->at(1).first[2], 1UL);
+}
+
+TEST_F(BrickMap3D, Clone)
+{
+  d.add_one({0, 0, 0});
+  d.add_one({1, 1, 1});
+
+  auto d2 = std::shared_ptr<DAQuiri::Dataspace>(d.clone());
+  EXPECT_EQ(d2->range({})->at(0).second, 1);
+  EXPECT_EQ(d2->range({})->at(0).first[0], 0UL);
+  EXPECT_EQ(d2->range({})->at(0).first[1], 0UL);
+  EXPECT_EQ(d2->range({})->at(0).first[2], 0UL);
+  EXPECT_EQ(d2->range({})->at(1).second, 1);
+  EXPECT_EQ(d2->range({})->at(1).first[0], 1UL);
+  EXPECT_EQ(d2->range({})->at(1).first[1], 1UL);
+  EXPECT_EQ(d2->range({})->at(1).first[2], 1UL);
+  EXPECT_EQ(d2->dimensions(), 3);
+  EXPECT_EQ(d2->total_count(), 2);
+}
+
+TEST_F(BrickMap3D, CalcAxes)
+{
+  d.add_one({0, 0, 0});
+  EXPECT_TRUE(d.axis(0).domain.empty());
+  EXPECT_TRUE(d.axis(1).domain.empty());
+  EXPECT_TRUE(d.axis(2).domain.empty());
+  d.recalc_axes();
+  EXPECT_EQ(d.axis(0).domain.size(), 1UL);
+  EXPECT_EQ(d.axis(1).domain.size(), 1UL);
+  EXPECT_EQ(d.axis(2).domain.size(), 1UL);
+
+  d.add_one({1, 1, 1});
+  EXPECT_EQ(d.axis(0).domain.size(), 1UL);
+  EXPECT_EQ(d.axis(1).domain.size(), 1UL);
+  EXPECT_EQ(d.axis(2).domain.size(), 1UL);
+  d.recalc_axes();
+  EXPECT_EQ(d.axis(0).domain.size(), 2UL);
+  EXPECT_EQ(d.axis(1).domain.size(), 2UL);
+  EXPECT_EQ(d.axis(2).domain.size(), 2UL);
+}
+
+TEST_F(BrickMap3D, SaveLoadEmpty)
+{
+  auto f = hdf5::file::create("dummy.h5", hdf5::file::AccessFlags::TRUNCATE);
+  auto g = f.root().create_group("empty");
+  d.save(g);
+  d.load(g);
+  EXPECT_TRUE(d.empty());
+}
+
+TEST_F(BrickMap3D, SaveLoadNonempty)
+{
+  d.add({{0, 0, 0}, 3});
+
+  auto f = hdf5::file::create("dummy.h5", hdf5::file::AccessFlags::TRUNCATE);
+  auto g = f.root().create_group("nonempty");
+  d.save(g);
+  d.load(g);
+  EXPECT_FALSE(d.empty());
+  EXPECT_EQ(d.get({0, 0, 0}), 3);
+  EXPECT_EQ(d.total_count(), 3);
+}
+
+TEST_F(BrickMap3D, SaveLoadThrow)
+{
+  hdf5::node::Group g;
+
+  EXPECT_THROW(d.save(g), std::runtime_error);
+  EXPECT_THROW(d.load(g), std::runtime_error);
+}
+
+TEST_F(BrickMap3D, ExportCSV)
+{
+  d.add_one({0, 0, 0});
+  d.add_one({1, 1, 1});
+  d.add_one({2, 2, 2});
+
+  std::stringstream ss;
+  d.export_csv(ss);
+
+  EXPECT_EQ(ss.str(), "x=0\n1, 0, 0;\n0, 0, 0;\n0, 0, 0;\n"
+                      "x=1\n0, 0, 0;\n0, 1, 0;\n0, 0, 0;\n"
+                      "x=2\n0, 0, 0;\n0, 0, 0;\n0, 0, 1;\n");
+}
+
+TEST_F(BrickMap3D, AllocatesBricks)
+{
+  EXPECT_EQ(d.brick_edge(), 8UL);
+  EXPECT_EQ(d.brick_count(), 0UL);
+  d.add_one({0, 0, 0});
+  d.add_one({7, 7, 7});
+  EXPECT_EQ(d.brick_count(), 1UL);
+  d.add_one({8, 0, 0});
+  d.add_one({65535, 65535, 65535});
+  EXPECT_EQ(d.brick_count(), 3UL);
+  EXPECT_EQ(d.get({7, 7, 7}), 1);
+  EXPECT_EQ(d.get({65535, 65535, 65535}), 1);
+  EXPECT_EQ(d.get({65535, 65535, 65534}), 0);
+  EXPECT_EQ(d.get({100, 100, 100}), 0);
+}
+
+TEST_F(BrickMap3D, BrickShift)
+{
+  DAQuiri::BrickMap3D d2(2);
+  EXPECT_EQ(d2.brick_edge(), 4UL);
+  d2.add_one({3, 3, 3});
+  d2.add_one({4, 3, 3});
+  EXPECT_EQ(d2.brick_count(), 2UL);
+}
+
+TEST_F(BrickMap3D, RangeAcrossBricksIsSorted)
+{
+  d.add_one({9, 0, 0});
+  d.add_one({0, 9, 0});
+  d.add_one({0, 0, 9});
+  d.add_one({1, 1, 1});
+  d.add_one({9, 9, 9});
+
+  auto r = d.range({});
+  ASSERT_EQ(r->size(), 5UL);
+  for (size_t i = 1; i < r->size(); ++i)
+    EXPECT_LT(r->at(i - 1).first, r->at(i).first);
+
+  auto sub = d.range({{0, 5}, {0, 10}, {0, 10}});
+  ASSERT_EQ(sub->size(), 3UL);
+  EXPECT_EQ(sub->at(0).first, DAQuiri::Coords({0, 0, 9}));
+  EXPECT_EQ(sub->at(2).first, DAQuiri::Coords({1, 1, 1}));
+}
+
+TEST_F(BrickMap3D, Slab)
+{
+  d.add_one({0, 0, 9});
+  d.add_one({12, 3, 9});
+  d.add_one({12, 3, 8});
+  d.add_one({1, 1, 1});
+
+  auto s = d.slab(9);
+  ASSERT_EQ(s->size(), 2UL);
+  EXPECT_EQ(s->at(0).first, DAQuiri::Coords({0, 0, 9}));
+  EXPECT_EQ(s->at(1).first, DAQuiri::Coords({12, 3, 9}));
+  EXPECT_TRUE(d.slab(20)->empty());
+}
+
+TEST_F(BrickMap3D, CloneKeepsFilling)
+{
+  d.add_one({0, 0, 0});
+  auto d2 = std::shared_ptr<DAQuiri::BrickMap3D>(d.clone());
+  d2->add_one({0, 0, 1});
+  d2->add_one({20, 0, 0});
+  EXPECT_EQ(d.get({0, 0, 1}), 0);
+  EXPECT_EQ(d2->get({0, 0, 1}), 1);
+  EXPECT_EQ(d2->get({20, 0, 0}), 1);
+  EXPECT_EQ(d.brick_count(), 1UL);
+}
+
+TEST_F(BrickMap3D, RangeSince)
+{
+  d.add_one({0, 0, 0});
+  d.add_one({100, 100, 100});
+  auto v = d.version();
+
+  DAQuiri::DataBlock block;
+  EXPECT_TRUE(d.range_since(block, v));
+  EXPECT_TRUE(block.empty());
+
+  // only the touched brick is returned
+  d.add({{101, 99, 100}, 2});
+  EXPECT_TRUE(d.range_since(block, v));
+  ASSERT_EQ(block.size(), 2UL);
+  block.for_each([this](const DAQuiri::Coords& c, double count)
+                 {
+                   EXPECT_GE(c[0], 96UL);
+                   EXPECT_EQ(d.get(c), count);
+                 });
+
+  d.clear();
+  d.add_one({1, 1, 1});
+  EXPECT_FALSE(d.range_since(block, v));
+  EXPECT_EQ(block.size(), 1UL);
+}
+
+TEST_F(BrickMap3D, Merge)
+{
+  d.add_one({0, 0, 0});
+  d.add({{9, 1, 2}, 2});
+
+  DAQuiri::BrickMap3D o;
+  o.add({{9, 1, 2}, 5});
+  o.add_one({30, 0, 7});
+
+  d.merge(o);
+  EXPECT_EQ(d.get({0, 0, 0}), 1);
+  EXPECT_EQ(d.get({9, 1, 2}), 7);
+  EXPECT_EQ(d.get({30, 0, 7}), 1);
+  EXPECT_EQ(d.total_count(), 9);
+  EXPECT_EQ(d.brick_count(), 3UL);
+
+  // different brick sizes go entry by entry
+  DAQuiri::BrickMap3D big(4);
+  big.add_one({0, 0, 0});
+  d.merge(big);
+  EXPECT_EQ(d.get({0, 0, 0}), 2);
+}
+
+TEST_F(BrickMap3D, LoadsSparseMap3D)
+{
+  DAQuiri::SparseMap3D old;
+  for (size_t i = 0; i < 200; ++i)
+    old.add({{i % 13, (i * 5) % 40, (i * 11) % 70}, PreciseFloat(i + 1)});
+
+  auto f = hdf5::file::create("dummy.h5", hdf5::file::AccessFlags::TRUNCATE);
+  auto g = f.root().create_group("old");
+  old.save(g);
+  d.load(g);
+
+  EXPECT_EQ(d.total_count(), old.total_count());
+  auto a = old.range({});
+  auto b = d.range({});
+  ASSERT_EQ(a->size(), b->size());
+  for (size_t i = 0; i < a->size(); ++i)
+  {
+    EXPECT_EQ(a->at(i).first, b->at(i).first);
+    EXPECT_EQ(a->at(i).second, b->at(i).second);
+  }
+}
+
+TEST_F(BrickMap3D, Debug)
+{
+  d.add_one({0, 0, 0});
+  d.add_one({1, 1, 1});
+  d.add_one({2, 2, 2});
+
+  MESSAGE() << d.debug() << "\n";
+}
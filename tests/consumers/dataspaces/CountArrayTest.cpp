@@ -0,0 +1,190 @@
+#include "gtest_color_print.h"
+
+#include <consumers/dataspaces/CountArray.h>
+#include <limits>
+
+using Width = DAQuiri::CountArray::Width;
+
+class CountArray : public TestBase
+{
+  protected:
+    DAQuiri::CountArray c;
+};
+
+TEST_F(CountArray, Init)
+{
+  EXPECT_TRUE(c.empty());
+  EXPECT_EQ(c.size(), 0UL);
+  EXPECT_EQ(c.width(), Width::u32);
+  EXPECT_EQ(c.max(), 0);
+}
+
+TEST_F(CountArray, Resize)
+{
+  c.resize(5);
+  EXPECT_FALSE(c.empty());
+  EXPECT_EQ(c.size(), 5UL);
+  EXPECT_EQ(c.get(4), 0);
+}
+
+TEST_F(CountArray, AddOne)
+{
+  c.resize(3);
+  c.add_one(1);
+  c.add_one(1);
+  c.add_one(2);
+  EXPECT_EQ(c.get(0), 0);
+  EXPECT_EQ(c.get(1), 2);
+  EXPECT_EQ(c.get(2), 1);
+  EXPECT_EQ(c.max(), 2);
+  EXPECT_EQ(c.width(), Width::u32);
+}
+
+TEST_F(CountArray, AddOnes)
+{
+  c.resize(4);
+  c.add_ones({0, 3, 3, 3});
+  EXPECT_EQ(c.get(0), 1);
+  EXPECT_EQ(c.get(3), 3);
+  EXPECT_EQ(c.width(), Width::u32);
+}
+
+TEST_F(CountArray, AddIntegral)
+{
+  c.resize(2);
+  c.add(1, 7);
+  EXPECT_EQ(c.get(1), 7);
+  EXPECT_EQ(c.width(), Width::u32);
+}
+
+TEST_F(CountArray, PromotesOnOverflow)
+{
+  uint64_t big = std::numeric_limits<uint32_t>::max();
+  c.resize(2);
+  c.add(0, big);
+  c.add(1, 3);
+  EXPECT_EQ(c.width(), Width::u32);
+
+  c.add_one(0);
+  EXPECT_EQ(c.width(), Width::u64);
+  EXPECT_EQ(c.get(0), big + 1);
+  EXPECT_EQ(c.get(1), 3);
+
+  c.add_one(1);
+  EXPECT_EQ(c.get(1), 4);
+}
+
+TEST_F(CountArray, PromotesOnOverflowInBulk)
+{
+  uint64_t big = std::numeric_limits<uint32_t>::max();
+  c.resize(2);
+  c.add(1, big - 1);
+  c.add_ones({0, 1, 1, 1, 0});
+  EXPECT_EQ(c.width(), Width::u64);
+  EXPECT_EQ(c.get(0), 2);
+  EXPECT_EQ(c.get(1), big + 2);
+}
+
+TEST_F(CountArray, PromotesOnSum)
+{
+  uint64_t big = std::numeric_limits<uint32_t>::max();
+  c.resize(1);
+  c.add(0, big);
+  c.add(0, big);
+  EXPECT_EQ(c.width(), Width::u64);
+  EXPECT_EQ(c.get(0), 2 * big);
+}
+
+TEST_F(CountArray, LargeIntegralStaysInteger)
+{
+  uint64_t big = uint64_t(1) << 40;
+  c.resize(2);
+  c.add(0, PreciseFloat(big));
+  EXPECT_EQ(c.width(), Width::u64);
+  EXPECT_EQ(c.get(0), PreciseFloat(big));
+
+  c.add(1, PreciseFloat(big));
+  c.add(1, PreciseFloat(big));
+  EXPECT_EQ(c.width(), Width::u64);
+  EXPECT_EQ(c.get(1), PreciseFloat(2 * big));
+}
+
+TEST_F(CountArray, PromotesOnFraction)
+{
+  c.resize(2);
+  c.add_one(0);
+  c.add(1, 0.5);
+  EXPECT_EQ(c.width(), Width::precise);
+  EXPECT_EQ(c.get(0), 1);
+  EXPECT_EQ(c.get(1), 0.5);
+
+  c.add_one(1);
+  EXPECT_EQ(c.get(1), 1.5);
+}
+
+TEST_F(CountArray, PromotesOnNegative)
+{
+  c.resize(1);
+  c.add(0, 2);
+  c.add(0, -3);
+  EXPECT_EQ(c.width(), Width::precise);
+  EXPECT_EQ(c.get(0), -1);
+}
+
+TEST_F(CountArray, AddArray)
+{
+  DAQuiri::CountArray o;
+  c.resize(2);
+  c.add(0, 3);
+  o.resize(4);
+  o.add(1, 2);
+  o.add(3, 5);
+
+  c.add(o);
+  EXPECT_EQ(c.width(), Width::u32);
+  EXPECT_EQ(c.size(), 4UL);
+  EXPECT_EQ(c.get(0), 3);
+  EXPECT_EQ(c.get(1), 2);
+  EXPECT_EQ(c.get(2), 0);
+  EXPECT_EQ(c.get(3), 5);
+}
+
+TEST_F(CountArray, AddArrayPromotes)
+{
+  uint64_t big = std::numeric_limits<uint32_t>::max();
+  DAQuiri::CountArray o;
+  c.resize(2);
+  c.add(0, big);
+  o.resize(1);
+  o.add(0, big);
+
+  c.add(o);
+  EXPECT_EQ(c.width(), Width::u64);
+  EXPECT_EQ(c.get(0), 2 * big);
+
+  o.resize(2);
+  o.add(1, 0.5);
+  c.add(o);
+  EXPECT_EQ(c.width(), Width::precise);
+  EXPECT_EQ(c.get(0), 3 * big);
+  EXPECT_EQ(c.get(1), 0.5);
+}
+
+TEST_F(CountArray, ResizeKeepsWidth)
+{
+  c.resize(1);
+  c.add(0, 0.5);
+  c.resize(3);
+  EXPECT_EQ(c.width(), Width::precise);
+  EXPECT_EQ(c.get(0), 0.5);
+  EXPECT_EQ(c.get(2), 0);
+}
+
+TEST_F(CountArray, Clear)
+{
+  c.resize(1);
+  c.add(0, 0.5);
+  c.clear();
+  EXPECT_TRUE(c.empty());
+  EXPECT_EQ(c.width(), Width::u32);
+}
@@ -0,0 +1,110 @@
+#include "gtest_color_print.h"
+
+#include <consumers/dataspaces/CountHash.h>
+#include <map>
+
+class CountHash : public TestBase
+{
+  protected:
+    DAQuiri::CountHash<uint32_t> h;
+};
+
+TEST_F(CountHash, Init)
+{
+  EXPECT_TRUE(h.empty());
+  EXPECT_EQ(h.size(), 0UL);
+  EXPECT_EQ(h.find(0), nullptr);
+  EXPECT_TRUE(h.sorted().empty());
+}
+
+TEST_F(CountHash, InsertAndFind)
+{
+  h[7] += 2;
+  h[7]++;
+  h[3] += 1;
+  EXPECT_EQ(h.size(), 2UL);
+  ASSERT_NE(h.find(7), nullptr);
+  EXPECT_EQ(*h.find(7), 3);
+  EXPECT_EQ(*h.find(3), 1);
+  EXPECT_EQ(h.find(4), nullptr);
+}
+
+TEST_F(CountHash, LargestKey)
+{
+  uint32_t last = std::numeric_limits<uint32_t>::max();
+  EXPECT_EQ(h.find(last), nullptr);
+  h[last] += 5;
+  EXPECT_EQ(h.size(), 1UL);
+  EXPECT_EQ(*h.find(last), 5);
+
+  auto s = h.sorted();
+  ASSERT_EQ(s.size(), 1UL);
+  EXPECT_EQ(s[0].first, last);
+}
+
+TEST_F(CountHash, GrowsAndMatchesMap)
+{
+  std::map<uint32_t, int> reference;
+  for (uint32_t i = 0; i < 20000; ++i)
+  {
+    uint32_t k = (i * 2654435761u) % 5000;
+    h[k]++;
+    reference[k]++;
+  }
+  EXPECT_EQ(h.size(), reference.size());
+
+  auto s = h.sorted();
+  ASSERT_EQ(s.size(), reference.size());
+  size_t i = 0;
+  for (const auto& r : reference)
+  {
+    EXPECT_EQ(s[i].first, r.first);
+    EXPECT_EQ(s[i].second, r.second);
+    i++;
+  }
+}
+
+TEST_F(CountHash, SortedFiltered)
+{
+  for (uint32_t k = 1000; k > 0; --k)
+    h[k] += k;
+  h[std::numeric_limits<uint32_t>::max()] += 1;
+
+  auto s = h.sorted([](uint32_t k) { return (k >= 10) && (k < 20); });
+  ASSERT_EQ(s.size(), 10UL);
+  for (size_t i = 0; i < s.size(); ++i)
+  {
+    EXPECT_EQ(s[i].first, 10 + i);
+    EXPECT_EQ(s[i].second, 10 + i);
+  }
+}
+
+TEST_F(CountHash, ForEach)
+{
+  h[1] += 1;
+  h[2] += 2;
+  h[std::numeric_limits<uint32_t>::max()] += 3;
+  PreciseFloat total {0};
+  h.for_each([&total](uint32_t, const PreciseFloat& c) { total += c; });
+  EXPECT_EQ(total, 6);
+}
+
+TEST_F(CountHash, Clear)
+{
+  h[1]++;
+  h[std::numeric_limits<uint32_t>::max()]++;
+  h.clear();
+  EXPECT_TRUE(h.empty());
+  EXPECT_EQ(h.find(1), nullptr);
+  h[1]++;
+  EXPECT_EQ(*h.find(1), 1);
+}
+
+TEST_F(CountHash, Copy)
+{
+  h[1] += 4;
+  auto h2 = h;
+  h[1] += 1;
+  EXPECT_EQ(*h2.find(1), 4);
+  EXPECT_EQ(*h.find(1), 5);
+}
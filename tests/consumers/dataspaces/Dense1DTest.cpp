@@ -1,6 +1,7 @@
 #include "gtest_color_print.h"
 
 #include <consumers/dataspaces/Dense1D.h>
+#include <consumers/dataspaces/SparseMap2D.h>
 
 class Dense1D : public TestBase
 {
@@ -25,6 +26,14 @@ TEST_F(Dense1D, AddOne)
   EXPECT_EQ(d.total_count(), 2);
 }
 
+TEST_F(Dense1D, AddOnes)
+{
+  d.add_ones({0, 3, 3});
+  EXPECT_EQ(d.total_count(), 3);
+  EXPECT_EQ(d.get({0}), 1);
+  EXPECT_EQ(d.get({3}), 2);
+}
+
 TEST_F(Dense1D, Get)
 {
   d.add_one({0});
@@ -43,6 +52,15 @@ TEST_F(Dense1D, Add)
   EXPECT_EQ(d.get({0}), 8);
 }
 
+TEST_F(Dense1D, AddFractional)
+{
+  d.add_one({0});
+  d.add({{1}, 0.25});
+  EXPECT_EQ(d.get({0}), 1);
+  EXPECT_EQ(d.get({1}), 0.25);
+  EXPECT_EQ(d.total_count(), 1.25);
+}
+
 TEST_F(Dense1D, Clear)
 {
   d.add({{0}, 3});
@@ -76,6 +94,44 @@ TEST_F(Dense1D, Clone)
   EXPECT_EQ(d2->total_count(), 2);
 }
 
+TEST_F(Dense1D, Merge)
+{
+  d.add_one({0});
+  d.add({{2}, 3});
+
+  DAQuiri::Dense1D o;
+  o.add_one({2});
+  o.add({{5}, 4});
+
+  auto v = d.version();
+  d.merge(o);
+  EXPECT_GT(d.version(), v);
+  EXPECT_EQ(d.get({0}), 1);
+  EXPECT_EQ(d.get({2}), 4);
+  EXPECT_EQ(d.get({5}), 4);
+  EXPECT_EQ(d.total_count(), 9);
+  EXPECT_EQ(d.axis(0).domain.size(), 6UL);
+  EXPECT_EQ(o.total_count(), 5);
+
+  d.merge(d);
+  EXPECT_EQ(d.get({2}), 8);
+  EXPECT_EQ(d.total_count(), 18);
+}
+
+TEST_F(Dense1D, MergeChecksAxes)
+{
+  DAQuiri::Dense1D o;
+  o.add_one({1});
+  o.set_axis(0, DAQuiri::DataAxis(DAQuiri::Calibration(DAQuiri::CalibID("a"),
+                                                       DAQuiri::CalibID("b"))));
+  EXPECT_THROW(d.merge(o), std::runtime_error);
+
+  DAQuiri::SparseMap2D o2;
+  o2.add_one({1, 1});
+  EXPECT_THROW(d.merge(o2), std::runtime_error);
+  EXPECT_TRUE(d.empty());
+}
+
 TEST_F(Dense1D, CalcAxes)
 {
 
@@ -130,6 +186,76 @@ TEST_F(Dense1D, ExportCSV)
   EXPECT_EQ(ss.str(), "1, 0, 1");
 }
 
+TEST_F(Dense1D, ReadRange)
+{
+  d.add_one({1});
+  d.add({{3}, 4});
+
+  DAQuiri::DataBlock block;
+  d.read_range(block, {});
+  EXPECT_EQ(block.layout, DAQuiri::DataBlock::Layout::dense);
+  EXPECT_EQ(block.origin, DAQuiri::Coords({0}));
+  EXPECT_EQ(block.counts, std::vector<double>({0, 1, 0, 4}));
+
+  d.read_range(block, {{1, 2}});
+  EXPECT_EQ(block.origin, DAQuiri::Coords({1}));
+  EXPECT_EQ(block.counts, std::vector<double>({1, 0}));
+
+  d.read_range(block, {{2, 100}});
+  EXPECT_EQ(block.counts, std::vector<double>({0, 4}));
+}
+
+TEST_F(Dense1D, RangeSince)
+{
+  d.add_one({1});
+  auto v = d.version();
+
+  DAQuiri::DataBlock block;
+  EXPECT_TRUE(d.range_since(block, v));
+  EXPECT_TRUE(block.empty());
+
+  d.add({{100}, 3});
+  EXPECT_GT(d.version(), v);
+  EXPECT_TRUE(d.range_since(block, v));
+  ASSERT_EQ(block.size(), 1UL);
+  EXPECT_EQ(block.coords[0][0], 100UL);
+  EXPECT_EQ(block.counts[0], 3);
+
+  EXPECT_TRUE(d.range_since(block, 0));
+  EXPECT_EQ(block.size(), 2UL);
+
+  auto d2 = std::shared_ptr<DAQuiri::Dataspace>(d.clone());
+  v = d2->version();
+  d2->add_ones({300, 300});
+  EXPECT_TRUE(d2->range_since(block, v));
+  ASSERT_EQ(block.size(), 1UL);
+  EXPECT_EQ(block.counts[0], 2);
+
+  d.clear();
+  d.add_one({5});
+  EXPECT_FALSE(d.range_since(block, v));
+  EXPECT_EQ(block.counts, std::vector<double>({0, 0, 0, 0, 0, 1}));
+}
+
+TEST_F(Dense1D, RangeSinceMerge)
+{
+  d.add_one({1});
+  d.add_one({500});
+  auto v = d.version();
+
+  auto other = std::shared_ptr<DAQuiri::Dataspace>(d.clone());
+  other->clear();
+  other->add({{300}, 2});
+
+  // only the blocks merged into are returned
+  DAQuiri::DataBlock block;
+  d.merge(*other);
+  EXPECT_TRUE(d.range_since(block, v));
+  ASSERT_EQ(block.size(), 1UL);
+  EXPECT_EQ(block.coords[0][0], 300UL);
+  EXPECT_EQ(block.counts[0], 2);
+}
+
 TEST_F(Dense1D, Debug)
 {
   d.add_one({0});
@@ -80,6 +80,27 @@ TEST_F(Scalar, Clone)
   EXPECT_EQ(d2->total_count(), 3);
 }
 
+TEST_F(Scalar, Merge)
+{
+  d.add({{}, 3});
+  d.add({{}, 5});
+
+  DAQuiri::Scalar o;
+  o.add({{}, 1});
+  o.add({{}, 2});
+
+  d.merge(o);
+  EXPECT_EQ(d.get({}), 2);
+  EXPECT_EQ(d.range({})->begin()->second, 1);
+  EXPECT_EQ(d.range({})->rbegin()->second, 5);
+  EXPECT_EQ(d.total_count(), 4);
+
+  DAQuiri::Scalar e;
+  e.merge(o);
+  EXPECT_EQ(e.get({}), 2);
+  EXPECT_FALSE(e.empty());
+}
+
 TEST_F(Scalar, CalcAxes)
 {
   //TODO: this feels wrong
@@ -118,6 +139,40 @@ TEST_F(Scalar, SaveLoadNonempty)
   EXPECT_EQ(d.total_count(), 2);
 }
 
+TEST_F(Scalar, RangeSince)
+{
+  d.add({{}, 3});
+  auto v = d.version();
+
+  DAQuiri::DataBlock block;
+  EXPECT_TRUE(d.range_since(block, v));
+  EXPECT_TRUE(block.empty());
+
+  d.add({{}, 5});
+  EXPECT_TRUE(d.range_since(block, v));
+  EXPECT_EQ(block.counts, std::vector<double>({5}));
+
+  d.clear();
+  EXPECT_FALSE(d.range_since(block, v));
+}
+
+TEST_F(Scalar, UpdateFrom)
+{
+  d.add({{}, 3});
+  std::shared_ptr<DAQuiri::Dataspace> copy(d.clone());
+  auto v = d.version();
+  d.add({{}, 7});
+  d.add({{}, 5});
+
+  DAQuiri::DataBlock changes;
+  ASSERT_TRUE(d.range_since(changes, v));
+  copy->update_from(d, changes);
+  EXPECT_EQ(copy->version(), d.version());
+  EXPECT_EQ(copy->get({}), 5);
+  EXPECT_EQ(copy->range({})->rbegin()->second, 7);
+  EXPECT_EQ(copy->total_count(), 3);
+}
+
 TEST_F(Scalar, SaveLoadThrow)
 {
   hdf5::node::Group g;
@@ -84,6 +84,24 @@ TEST_F(SparseMap2D, Clone)
   EXPECT_EQ(d2->total_count(), 2);
 }
 
+TEST_F(SparseMap2D, Merge)
+{
+  d.add_one({1, 1});
+  d.add({{2, 3}, 2});
+
+  DAQuiri::SparseMap2D o;
+  o.add({{2, 3}, 5});
+  o.add_one({7, 0});
+
+  d.merge(o);
+  EXPECT_EQ(d.get({1, 1}), 1);
+  EXPECT_EQ(d.get({2, 3}), 7);
+  EXPECT_EQ(d.get({7, 0}), 1);
+  EXPECT_EQ(d.total_count(), 9);
+  EXPECT_EQ(d.axis(0).domain.size(), 8UL);
+  EXPECT_EQ(d.axis(1).domain.size(), 4UL);
+}
+
 TEST_F(SparseMap2D, CalcAxes)
 {
   d.add_one({0, 0});
@@ -123,6 +141,38 @@ TEST_F(SparseMap2D, SaveLoadNonempty)
   EXPECT_EQ(d.total_count(), 3);
 }
 
+TEST_F(SparseMap2D, SaveLoadMany)
+{
+  for (size_t i = 0; i < 300; ++i)
+    d.add({{i % 17, (i * 7) % 300}, PreciseFloat(i + 1)});
+  d.add_one({65535, 65535});
+
+  auto f = hdf5::file::create("dummy.h5", hdf5::file::AccessFlags::TRUNCATE);
+  auto g = f.root().create_group("many");
+  d.save(g);
+
+  DAQuiri::SparseMap2D d2;
+  d2.load(g);
+  EXPECT_EQ(d2.total_count(), d.total_count());
+  EXPECT_EQ(d2.range({})->size(), d.range({})->size());
+  for (size_t i = 0; i < 300; ++i)
+    EXPECT_EQ(d2.get({i % 17, (i * 7) % 300}), d.get({i % 17, (i * 7) % 300}));
+  EXPECT_EQ(d2.get({65535, 65535}), 1);
+}
+
+TEST_F(SparseMap2D, RangeIsSorted)
+{
+  d.add_one({3, 1});
+  d.add_one({0, 5});
+  d.add_one({3, 0});
+  d.add_one({1, 2});
+
+  auto r = d.range({});
+  ASSERT_EQ(r->size(), 4UL);
+  for (size_t i = 1; i < r->size(); ++i)
+    EXPECT_LT(r->at(i - 1).first, r->at(i).first);
+}
+
 TEST_F(SparseMap2D, SaveLoadThrow)
 {
   hdf5::node::Group g;
@@ -143,6 +193,114 @@ TEST_F(SparseMap2D, ExportCSV)
   EXPECT_EQ(ss.str(), "1, 0, 0;\n0, 1, 0;\n0, 0, 1;\n");
 }
 
+TEST_F(SparseMap2D, ReadRange)
+{
+  d.add_one({4, 0});
+  d.add({{1, 1}, 3});
+  d.add_one({4, 4});
+
+  DAQuiri::DataBlock block;
+  d.read_range(block, {{0, 4}, {0, 3}});
+  EXPECT_EQ(block.layout, DAQuiri::DataBlock::Layout::sparse);
+  ASSERT_EQ(block.size(), 2UL);
+  double total = 0;
+  block.for_each([this, &total](const DAQuiri::Coords& c, double count)
+                 {
+                   EXPECT_EQ(d.get(c), count);
+                   total += count;
+                 });
+  EXPECT_EQ(total, 4);
+}
+
+TEST_F(SparseMap2D, ReadLevel)
+{
+  d.add_one({4, 0});
+  d.add({{1, 1}, 3});
+  d.add_one({4, 4});
+  d.add_one({5, 5});
+
+  DAQuiri::DataBlock block;
+  d.read_level(block, 2);
+  ASSERT_EQ(block.size(), 3UL);
+  EXPECT_EQ(block.coords[0], std::vector<size_t>({0, 1, 1}));
+  EXPECT_EQ(block.coords[1], std::vector<size_t>({0, 0, 1}));
+  EXPECT_EQ(block.counts, std::vector<double>({3, 1, 2}));
+
+  // ranges widened to whole coarse bins
+  d.read_level(block, 2, {{0, 4}, {0, 2}});
+  EXPECT_EQ(block.counts, std::vector<double>({3, 1}));
+
+  d.read_level(block, 0);
+  EXPECT_EQ(block.size(), 4UL);
+  EXPECT_FALSE(d.has_levels());
+}
+
+TEST_F(SparseMap2D, ReadLevelFarApart)
+{
+  // box too large for a dense coarse buffer
+  d.add_one({60000, 3});
+  d.add_one({0, 60001});
+  d.add_one({1, 60000});
+  d.add_one({60001, 2});
+
+  DAQuiri::DataBlock block;
+  d.read_level(block, 1);
+  EXPECT_EQ(block.layout, DAQuiri::DataBlock::Layout::sparse);
+  EXPECT_EQ(block.coords[0], std::vector<size_t>({0, 30000}));
+  EXPECT_EQ(block.coords[1], std::vector<size_t>({30000, 1}));
+  EXPECT_EQ(block.counts, std::vector<double>({2, 2}));
+}
+
+TEST_F(SparseMap2D, RangeSince)
+{
+  d.add_one({0, 0});
+  d.add_one({100, 100});
+  auto v = d.version();
+
+  DAQuiri::DataBlock block;
+  EXPECT_TRUE(d.range_since(block, v));
+  EXPECT_TRUE(block.empty());
+
+  // only the changed row is returned
+  d.add({{100, 7}, 2});
+  EXPECT_TRUE(d.range_since(block, v));
+  ASSERT_EQ(block.size(), 2UL);
+  block.for_each([this](const DAQuiri::Coords& c, double count)
+                 {
+                   EXPECT_EQ(c[0], 100UL);
+                   EXPECT_EQ(d.get(c), count);
+                 });
+
+  d.clear();
+  d.add_one({1, 1});
+  EXPECT_FALSE(d.range_since(block, v));
+  EXPECT_EQ(block.size(), 1UL);
+}
+
+TEST_F(SparseMap2D, UpdateFrom)
+{
+  d.add_one({0, 0});
+  std::shared_ptr<DAQuiri::Dataspace> copy(d.clone());
+  auto v = d.version();
+  d.add_one({0, 0});
+  d.add_ones({3, 4, 5, 6, 3, 4});
+
+  DAQuiri::DataBlock changes;
+  ASSERT_TRUE(d.range_since(changes, v));
+  copy->update_from(d, changes);
+  EXPECT_EQ(copy->version(), d.version());
+  EXPECT_EQ(copy->get({0, 0}), 2);
+  EXPECT_EQ(copy->get({3, 4}), 2);
+  EXPECT_EQ(copy->get({5, 6}), 1);
+  EXPECT_EQ(copy->total_count(), d.total_count());
+
+  // bins brought over count as changed after v, and no later
+  ASSERT_TRUE(copy->range_since(changes, v));
+  EXPECT_EQ(changes.size(), 3UL);
+  ASSERT_TRUE(copy->range_since(changes, d.version()));
+  EXPECT_TRUE(changes.empty());
+}
+
 TEST_F(SparseMap2D, Debug)
 {
   d.add_one({0, 0});
@@ -87,6 +87,25 @@ TEST_F(SparseMap3D, Clone)
   EXPECT_EQ(d2->total_count(), 2);
 }
 
+TEST_F(SparseMap3D, Merge)
+{
+  d.add_one({1, 1, 1});
+  d.add({{2, 3, 4}, 2});
+
+  DAQuiri::SparseMap3D o;
+  o.add_one({0, 0, 0});
+  o.add({{2, 3, 4}, 5});
+  o.add_one({9, 0, 1});
+
+  d.merge(o);
+  EXPECT_EQ(d.get({0, 0, 0}), 1);
+  EXPECT_EQ(d.get({1, 1, 1}), 1);
+  EXPECT_EQ(d.get({2, 3, 4}), 7);
+  EXPECT_EQ(d.get({9, 0, 1}), 1);
+  EXPECT_EQ(d.total_count(), 10);
+  EXPECT_EQ(d.range({})->size(), 4UL);
+}
+
 TEST_F(SparseMap3D, CalcAxes)
 {
   d.add_one({0, 0, 0});
@@ -130,6 +149,32 @@ TEST_F(SparseMap3D, SaveLoadNonempty)
   EXPECT_EQ(d.total_count(), 3);
 }
 
+TEST_F(SparseMap3D, RangeSince)
+{
+  d.add_one({0, 0, 0});
+  d.add_one({100, 100, 100});
+  auto v = d.version();
+
+  DAQuiri::DataBlock block;
+  EXPECT_TRUE(d.range_since(block, v));
+  EXPECT_TRUE(block.empty());
+
+  // only the changed x is returned
+  d.add({{100, 7, 3}, 2});
+  EXPECT_TRUE(d.range_since(block, v));
+  ASSERT_EQ(block.size(), 2UL);
+  block.for_each([this](const DAQuiri::Coords& c, double count)
+                 {
+                   EXPECT_EQ(c[0], 100UL);
+                   EXPECT_EQ(d.get(c), count);
+                 });
+
+  d.clear();
+  d.add_one({1, 1, 1});
+  EXPECT_FALSE(d.range_since(block, v));
+  EXPECT_EQ(block.size(), 1UL);
+}
+
 TEST_F(SparseMap3D, SaveLoadThrow)
 {
   hdf5::node::Group g;
@@ -45,6 +45,22 @@ TEST_F(SparseMatrix2D, Add)
   EXPECT_EQ(d.get({0, 0}), 8);
 }
 
+TEST_F(SparseMatrix2D, AddOnes)
+{
+  d.add_ones({0, 0, 1, 2, 1, 2});
+  EXPECT_EQ(d.total_count(), 3);
+  EXPECT_EQ(d.get({0, 0}), 1);
+  EXPECT_EQ(d.get({1, 2}), 2);
+}
+
+TEST_F(SparseMatrix2D, AddMany)
+{
+  d.add_many({0, 0, 1, 2, 1, 2}, {3, 0, 5});
+  EXPECT_EQ(d.total_count(), 8);
+  EXPECT_EQ(d.get({0, 0}), 3);
+  EXPECT_EQ(d.get({1, 2}), 5);
+}
+
 TEST_F(SparseMatrix2D, Clear)
 {
   d.add({{0, 0}, 3});
@@ -84,6 +100,29 @@ TEST_F(SparseMatrix2D, Clone)
   EXPECT_EQ(d2->total_count(), 2);
 }
 
+TEST_F(SparseMatrix2D, Merge)
+{
+  d.add_one({1, 1});
+  d.add({{2, 3}, 2});
+
+  DAQuiri::SparseMatrix2D o;
+  o.add({{2, 3}, 5});
+  o.add_one({7, 0});
+
+  d.merge(o);
+  EXPECT_EQ(d.get({1, 1}), 1);
+  EXPECT_EQ(d.get({2, 3}), 7);
+  EXPECT_EQ(d.get({7, 0}), 1);
+  EXPECT_EQ(d.total_count(), 9);
+
+  // other is the smaller one
+  DAQuiri::SparseMatrix2D s;
+  s.add_one({0, 0});
+  d.merge(s);
+  EXPECT_EQ(d.get({0, 0}), 1);
+  EXPECT_EQ(d.total_count(), 10);
+}
+
 TEST_F(SparseMatrix2D, CalcAxes)
 {
   d.add_one({0, 0});
@@ -123,6 +162,32 @@ TEST_F(SparseMatrix2D, SaveLoadNonempty)
   EXPECT_EQ(d.total_count(), 3);
 }
 
+TEST_F(SparseMatrix2D, RangeSince)
+{
+  d.add_one({0, 0});
+  d.add_one({100, 100});
+  auto v = d.version();
+
+  DAQuiri::DataBlock block;
+  EXPECT_TRUE(d.range_since(block, v));
+  EXPECT_TRUE(block.empty());
+
+  // only the changed column is returned
+  d.add({{7, 100}, 2});
+  EXPECT_TRUE(d.range_since(block, v));
+  ASSERT_EQ(block.size(), 2UL);
+  block.for_each([this](const DAQuiri::Coords& c, double count)
+                 {
+                   EXPECT_EQ(c[1], 100UL);
+                   EXPECT_EQ(d.get(c), count);
+                 });
+
+  d.clear();
+  d.add_one({1, 1});
+  EXPECT_FALSE(d.range_since(block, v));
+  EXPECT_EQ(block.size(), 1UL);
+}
+
 TEST_F(SparseMatrix2D, SaveLoadThrow)
 {
   hdf5::node::Group g;
@@ -0,0 +1,302 @@
+#include "gtest_color_print.h"
+
+#include <consumers/dataspaces/TileMap2D.h>
+#include <consumers/dataspaces/SparseMatrix2D.h>
+
+class TileMap2D : public TestBase
+{
+  protected:
+    DAQuiri::TileMap2D d;
+};
+
+TEST_F(TileMap2D, Init)
+{
+  EXPECT_TRUE(d.empty());
+  EXPECT_EQ(d.dimensions(), 2);
+  EXPECT_EQ(d.total_count(), 0);
+}
+
+TEST_F(TileMap2D, AddOne)
+{
+  d.add_one({0, 0});
+  EXPECT_FALSE(d.empty());
+  EXPECT_EQ(d.total_count(), 1);
+
+  d.add_one({0, 0});
+  EXPECT_EQ(d.total_count(), 2);
+}
+
+TEST_F(TileMap2D, Get)
+{
+  EXPECT_EQ(d.get({0, 0}), 0);
+  d.add_one({0, 0});
+  EXPECT_EQ(d.get({0, 0}), 1);
+
+  EXPECT_EQ(d.get({1, 1}), 0);
+  d.add_one({1, 1});
+  EXPECT_EQ(d.get({1, 1}), 1);
+}
+
+TEST_F(TileMap2D, Add)
+{
+  d.add({{0, 0}, 3});
+  EXPECT_EQ(d.get({0, 0}), 3);
+
+  d.add({{0, 0}, 5});
+  EXPECT_EQ(d.get({0, 0}), 8);
+}
+
+TEST_F(TileMap2D, AddOnes)
+{
+  d.add_ones({0, 0, 1, 2, 1, 2});
+  EXPECT_EQ(d.total_count(), 3);
+  EXPECT_EQ(d.get({0, 0}), 1);
+  EXPECT_EQ(d.get({1, 2}), 2);
+}
+
+TEST_F(TileMap2D, AddMany)
+{
+  d.add_many({0, 0, 1, 2, 1, 2}, {3, 0, 5});
+  EXPECT_EQ(d.total_count(), 8);
+  EXPECT_EQ(d.get({0, 0}), 3);
+  EXPECT_EQ(d.get({1, 2}), 5);
+}
+
+TEST_F(TileMap2D, Clear)
+{
+  d.add({{0, 0}, 3});
+  EXPECT_EQ(d.total_count(), 3);
+
+  d.clear();
+  EXPECT_EQ(d.total_count(), 0);
+  EXPECT_TRUE(d.empty());
+}
+
+TEST_F(TileMap2D, Range)
+{
+  d.add_one({0, 0});
+  EXPECT_EQ(d.range({})->at(0).second, 1);
+  EXPECT_EQ(d.range({})->at(0).first[0], 0UL);
+  EXPECT_EQ(d.range({})->at(0).first[1], 0UL);
+
+  d.add_one({1, 1});
+  EXPECT_EQ(d.range({})->at(1).second, 1);
+  EXPECT_EQ(d.range({})->at(1).first[0], 1UL);
+  EXPECT_EQ(d.range({})->at(1).first[1], 1UL);
+}
+
+TEST_F(TileMap2D, Clone)
+{
+  d.add_one({0, 0});
+  d.add_one({1, 1});
+
+  auto d2 = std::shared_ptr<DAQuiri::Dataspace>(d.clone());
+  EXPECT_EQ(d2->range({})->at(0).second, 1);
+  EXPECT_EQ(d2->range({})->at(0).first[0], 0UL);
+  EXPECT_EQ(d2->range({})->at(0).first[1], 0UL);
+  EXPECT_EQ(d2->range({})->at(1).second, 1);
+  EXPECT_EQ(d2->range({})->at(1).first[0], 1UL);
+  EXPECT_EQ(d2->range({})->at(1).first[1], 1UL);
+  EXPECT_EQ(d2->dimensions(), 2);
+  EXPECT_EQ(d2->total_count(), 2);
+}
+
+TEST_F(TileMap2D, CalcAxes)
+{
+  d.add_one({0, 0});
+  EXPECT_TRUE(d.axis(0).domain.empty());
+  EXPECT_TRUE(d.axis(1).domain.empty());
+  d.recalc_axes();
+  EXPECT_EQ(d.axis(0).domain.size(), 1UL);
+  EXPECT_EQ(d.axis(1).domain.size(), 1UL);
+
+  d.add_one({1, 1});
+  EXPECT_EQ(d.axis(0).domain.size(), 1UL);
+  EXPECT_EQ(d.axis(1).domain.size(), 1UL);
+  d.recalc_axes();
+  EXPECT_EQ(d.axis(0).domain.size(), 2UL);
+  EXPECT_EQ(d.axis(1).domain.size(), 2UL);
+}
+
+TEST_F(TileMap2D, SaveLoadEmpty)
+{
+  auto f = hdf5::file::create("dummy.h5", hdf5::file::AccessFlags::TRUNCATE);
+  auto g = f.root().create_group("empty");
+  d.save(g);
+  d.load(g);
+  EXPECT_TRUE(d.empty());
+}
+
+TEST_F(TileMap2D, SaveLoadNonempty)
+{
+  d.add({{0, 0}, 3});
+
+  auto f = hdf5::file::create("dummy.h5", hdf5::file::AccessFlags::TRUNCATE);
+  auto g = f.root().create_group("nonempty");
+  d.save(g);
+  d.load(g);
+  EXPECT_FALSE(d.empty());
+  EXPECT_EQ(d.get({0, 0}), 3);
+  EXPECT_EQ(d.total_count(), 3);
+}
+
+TEST_F(TileMap2D, SaveLoadThrow)
+{
+  hdf5::node::Group g;
+
+  EXPECT_THROW(d.save(g), std::runtime_error);
+  EXPECT_THROW(d.load(g), std::runtime_error);
+}
+
+TEST_F(TileMap2D, ExportCSV)
+{
+  d.add_one({0, 0});
+  d.add_one({1, 1});
+  d.add_one({2, 2});
+
+  std::stringstream ss;
+  d.export_csv(ss);
+
+  EXPECT_EQ(ss.str(), "1, 0, 0;\n0, 1, 0;\n0, 0, 1;\n");
+}
+
+TEST_F(TileMap2D, AllocatesTiles)
+{
+  EXPECT_EQ(d.tile_edge(), 32UL);
+  d.add_one({0, 0});
+  d.add_one({31, 31});
+  EXPECT_EQ(d.tile_count(), 1UL);
+  d.add_one({32, 0});
+  d.add_one({65535, 65535});
+  EXPECT_EQ(d.tile_count(), 3UL);
+  EXPECT_EQ(d.get({31, 31}), 1);
+  EXPECT_EQ(d.get({65535, 65535}), 1);
+  EXPECT_EQ(d.get({65535, 65534}), 0);
+  EXPECT_EQ(d.get({1000, 1000}), 0);
+}
+
+TEST_F(TileMap2D, RangeAcrossTilesIsSorted)
+{
+  d.add_one({40, 0});
+  d.add_one({0, 40});
+  d.add_one({1, 1});
+  d.add_one({40, 40});
+
+  auto r = d.range({});
+  ASSERT_EQ(r->size(), 4UL);
+  for (size_t i = 1; i < r->size(); ++i)
+    EXPECT_LT(r->at(i - 1).first, r->at(i).first);
+
+  auto sub = d.range({{0, 39}, {0, 100}});
+  ASSERT_EQ(sub->size(), 2UL);
+  EXPECT_EQ(sub->at(0).first, DAQuiri::Coords({0, 40}));
+  EXPECT_EQ(sub->at(1).first, DAQuiri::Coords({1, 1}));
+}
+
+TEST_F(TileMap2D, CloneKeepsFilling)
+{
+  d.add_one({0, 0});
+  auto d2 = std::shared_ptr<DAQuiri::TileMap2D>(d.clone());
+  d2->add_one({0, 1});
+  d2->add_one({100, 0});
+  EXPECT_EQ(d.get({0, 1}), 0);
+  EXPECT_EQ(d2->get({0, 1}), 1);
+  EXPECT_EQ(d2->get({100, 0}), 1);
+  EXPECT_EQ(d.tile_count(), 1UL);
+}
+
+TEST_F(TileMap2D, LoadsSparseMatrix2D)
+{
+  DAQuiri::SparseMatrix2D old;
+  for (size_t i = 0; i < 200; ++i)
+    old.add({{i % 37, (i * 7) % 90}, PreciseFloat(i + 1)});
+
+  auto f = hdf5::file::create("dummy.h5", hdf5::file::AccessFlags::TRUNCATE);
+  auto g = f.root().create_group("old");
+  old.save(g);
+  d.load(g);
+
+  EXPECT_EQ(d.total_count(), old.total_count());
+  for (size_t i = 0; i < 200; ++i)
+    EXPECT_EQ(d.get({i % 37, (i * 7) % 90}), old.get({i % 37, (i * 7) % 90}));
+  EXPECT_EQ(d.range({})->size(), old.range({})->size());
+}
+
+TEST_F(TileMap2D, ReadRange)
+{
+  d.add_one({40, 0});
+  d.add({{1, 1}, 3});
+  d.add_one({40, 40});
+
+  DAQuiri::DataBlock block;
+  d.read_range(block, {{0, 40}, {0, 39}});
+  EXPECT_EQ(block.layout, DAQuiri::DataBlock::Layout::sparse);
+  ASSERT_EQ(block.size(), 2UL);
+  double total = 0;
+  block.for_each([this, &total](const DAQuiri::Coords& c, double count)
+                 {
+                   EXPECT_EQ(d.get(c), count);
+                   total += count;
+                 });
+  EXPECT_EQ(total, 4);
+}
+
+TEST_F(TileMap2D, RangeSince)
+{
+  d.add_one({0, 0});
+  d.add_one({100, 100});
+  auto v = d.version();
+
+  DAQuiri::DataBlock block;
+  EXPECT_TRUE(d.range_since(block, v));
+  EXPECT_TRUE(block.empty());
+
+  // only the touched tile is returned
+  d.add({{101, 99}, 2});
+  EXPECT_TRUE(d.range_since(block, v));
+  ASSERT_EQ(block.size(), 2UL);
+  double total = 0;
+  block.for_each([&total](const DAQuiri::Coords& c, double count)
+                 {
+                   EXPECT_GE(c[0], 96UL);
+                   total += count;
+                 });
+  EXPECT_EQ(total, 3);
+
+  d.clear();
+  d.add_one({1, 1});
+  EXPECT_FALSE(d.range_since(block, v));
+  EXPECT_EQ(block.size(), 1UL);
+}
+
+TEST_F(TileMap2D, RangeSinceMerge)
+{
+  d.add_one({0, 0});
+  d.add_one({100, 100});
+  auto v = d.version();
+
+  auto other = std::shared_ptr<DAQuiri::Dataspace>(d.clone());
+  other->clear();
+  other->add({{101, 99}, 2});
+
+  // only the tile merged into is returned
+  DAQuiri::DataBlock block;
+  d.merge(*other);
+  EXPECT_TRUE(d.range_since(block, v));
+  double total = 0;
+  block.for_each([&total](const DAQuiri::Coords& c, double count)
+                 {
+                   EXPECT_GE(c[0], 96UL);
+                   total += count;
+                 });
+  EXPECT_EQ(total, 3);
+}
+
+TEST_F(TileMap2D, Debug)
+{
+  d.add_one({0, 0});
+  d.add_one({1, 1});
+  d.add_one({2, 2});
+
+  MESSAGE() << d.debug() << "\n";
+}
@@ -17,7 +17,7 @@ class FakeConsumer : public DAQuiri::Consumer
   void _recalc_axes() override {}
   bool _accept_spill(const DAQuiri::Spill&) override { return true; }
   bool _accept_events(const DAQuiri::Spill&) override { return false; }
-  void _push_event(const DAQuiri::Event&) override {}
+  void _push_event(const DAQuiri::EventView&) override {}
 };
 
 class Consumer1 : public FakeConsumer
@@ -25,9 +25,83 @@ class MockConsumer : public Consumer
       return true;
     }
     bool _accept_events(const Spill&) override { return accept_events; }
-    void _push_event(const Event&) override { accepted_events++; }
+    void _push_event(const EventView&) override { accepted_events++; }
 };
 
+class CountDataspace : public Dataspace
+{
+  public:
+    explicit CountDataspace(uint16_t dimensions = 0) : Dataspace(dimensions) {}
+    CountDataspace* clone() const override
+    {
+      clones++;
+      return new CountDataspace(*this);
+    }
+
+    static size_t clones;
+
+    bool empty() const override { return (total_count_ == 0); }
+    void clear() override { touch_all(); total_count_ = 0; }
+    void add(const Entry& e) override { touch(); total_count_ += e.second; }
+    void add_one(const Coords&) override { touch(); total_count_++; }
+    PreciseFloat get(const Coords&) const override { return total_count_; }
+    EntryList range(std::vector<Pair>) const override { return EntryList(); }
+    void recalc_axes() override {}
+
+    bool tracks_changes() const override { return true; }
+    bool range_since(DataBlock& block, uint64_t since) const override
+    {
+      block.reset_sparse(0);
+      if (since < version_)
+        block.push(Coords(), to_double(total_count_));
+      return (since >= cleared_version_);
+    }
+
+  protected:
+    void data_merge(const Dataspace& other) override
+    {
+      total_count_ += other.total_count();
+    }
+    void data_save(const hdf5::node::Group&) const override {}
+    void data_load(const hdf5::node::Group&) override {}
+};
+
+size_t CountDataspace::clones {0};
+
+class DataConsumer : public MockConsumer
+{
+  public:
+    DataConsumer()
+    {
+      data_ = std::make_shared<CountDataspace>();
+      accept_events = true;
+    }
+
+    uint64_t data_version() const { return data_->version(); }
+
+  protected:
+    void _push_event(const EventView&) override { data_->add_one({}); }
+    // stands in for anything resetting all bins
+    void _flush() override { data_->clear(); }
+};
+
+// same type as DataConsumer, but data that cannot be merged with it
+class LineConsumer : public DataConsumer
+{
+  public:
+    LineConsumer() { data_ = std::make_shared<CountDataspace>(1); }
+};
+
+Spill spill_with_events(size_t count)
+{
+  Spill s("", Spill::Type::running);
+  s.events.reserve(count, Event(EventModel()));
+  for (size_t i = 0; i < count; ++i)
+    ++s.events;
+  s.events.finalize();
+  return s;
+}
+
 TEST(Consumer, DefaultConstructor)
 {
   MockConsumer c;
@@ -43,6 +117,30 @@ TEST(Consumer, GetMetadata)
 
   auto md = c.metadata();
   EXPECT_TRUE(md.get_attribute("stream_id"));
+  EXPECT_TRUE(md.get_attribute("dropped_spills"));
+}
+
+TEST(Consumer, Streams)
+{
+  MockConsumer c;
+  EXPECT_EQ(c.streams(), std::set<std::string>({""}));
+
+  MockConsumer other;
+  auto version = c.subscription_version();
+  auto other_version = other.subscription_version();
+  c.set_attribute(Setting::text("stream_id", "someid"));
+  EXPECT_EQ(c.streams(), std::set<std::string>({"someid"}));
+  EXPECT_NE(c.subscription_version(), version);
+  EXPECT_EQ(other.subscription_version(), other_version);
+}
+
+TEST(Consumer, AddDroppedSpills)
+{
+  MockConsumer c;
+  c.add_dropped_spills(3);
+  c.add_dropped_spills(2);
+  EXPECT_EQ(c.metadata().get_attribute("dropped_spills").get_number(), 5);
+  EXPECT_TRUE(c.changed());
 }
 
 TEST(Consumer, AcceptingSpillsByID)
@@ -83,7 +181,118 @@ TEST(Consumer, EventsArePushedWhenAccepted)
   EXPECT_EQ(c.accepted_events, 3UL);
 }
 
+TEST(Consumer, DataIsSharedUntilChanged)
+{
+  DataConsumer c;
+  auto d1 = c.data();
+  auto clones = CountDataspace::clones;
+
+  auto d2 = c.data();
+  EXPECT_EQ(d1, d2);
+  EXPECT_EQ(CountDataspace::clones, clones);
+}
+
+TEST(Consumer, SnapshotSurvivesChanges)
+{
+  DataConsumer c;
+  c.push_spill(spill_with_events(3));
+  auto before = c.data();
+  EXPECT_EQ(before->total_count(), 3);
+
+  auto clones = CountDataspace::clones;
+  c.push_spill(spill_with_events(2));
+  c.push_spill(spill_with_events(2));
+  // the builder never copies
+  EXPECT_EQ(CountDataspace::clones, clones);
+
+  auto after = c.data();
+  EXPECT_NE(before, after);
+  EXPECT_EQ(before->total_count(), 3);
+  EXPECT_EQ(after->total_count(), 7);
+}
+
+TEST(Consumer, NoCopyWithoutReaders)
+{
+  DataConsumer c;
+  c.data()->total_count();
+  auto clones = CountDataspace::clones;
+  c.push_spill(spill_with_events(2));
+  c.push_spill(spill_with_events(2));
+  EXPECT_EQ(c.data()->total_count(), 4);
+  EXPECT_EQ(CountDataspace::clones, clones);
+}
+
+TEST(Consumer, KeepsNoSpareCopy)
+{
+  DataConsumer c;
+  c.push_spill(spill_with_events(1));
+  auto first = c.data();
+  std::weak_ptr<const Dataspace> watch = first;
+  c.push_spill(spill_with_events(2));
+  auto second = c.data();
+  EXPECT_NE(second, first);
+  first.reset();
+  // only the reader held on to it
+  EXPECT_TRUE(watch.expired());
+
+  // once released, the copy is brought up to date in place
+  const Dataspace* copy = second.get();
+  second.reset();
+  auto clones = CountDataspace::clones;
+  c.push_spill(spill_with_events(4));
+  auto third = c.data();
+  EXPECT_EQ(third.get(), copy);
+  EXPECT_EQ(CountDataspace::clones, clones);
+  EXPECT_EQ(third->total_count(), 7);
+  EXPECT_EQ(third->version(), c.data_version());
+}
+
+TEST(Consumer, CopiedAnewAfterClear)
+{
+  DataConsumer c;
+  c.push_spill(spill_with_events(2));
+  c.data()->total_count();
+
+  auto clones = CountDataspace::clones;
+  c.flush();
+  EXPECT_EQ(c.data()->total_count(), 0);
+  EXPECT_EQ(CountDataspace::clones, clones + 1);
+}
+
 //TODO: this is failing
+TEST(Consumer, Merge)
+{
+  DataConsumer a, b;
+  a.push_spill(spill_with_events(3));
+  b.push_spill(spill_with_events(4));
+  a.reset_changed();
+
+  auto snapshot = a.data();
+  a.merge(b);
+  EXPECT_EQ(a.data()->total_count(), 7);
+  EXPECT_EQ(b.data()->total_count(), 4);
+  EXPECT_EQ(snapshot->total_count(), 3);
+  EXPECT_TRUE(a.changed());
+
+  EXPECT_THROW(a.merge(a), std::runtime_error);
+}
+
+TEST(Consumer, CheckMerge)
+{
+  DataConsumer a, b;
+  a.push_spill(spill_with_events(3));
+  b.push_spill(spill_with_events(4));
+  EXPECT_NO_THROW(a.check_merge(b));
+  EXPECT_EQ(a.data()->total_count(), 3);
+
+  LineConsumer line;
+  line.push_spill(spill_with_events(5));
+  EXPECT_THROW(a.check_merge(line), std::runtime_error);
+  EXPECT_THROW(a.merge(line), std::runtime_error);
+  EXPECT_EQ(a.data()->total_count(), 3);
+  EXPECT_THROW(a.check_merge(a), std::runtime_error);
+}
+
 //TEST(Consumer, ChangeAndReset)
 //{
 //  Spill s("", Spill::Type::daq_status);
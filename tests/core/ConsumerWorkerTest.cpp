@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <core/ConsumerWorker.h>
+#include <consumers/dataspaces/Dense1D.h>
+
+using namespace DAQuiri;
+
+class GatedConsumer : public Consumer
+{
+  public:
+    GatedConsumer() { data_ = std::make_shared<Dense1D>(); }
+    GatedConsumer* clone() const override { return new GatedConsumer(); }
+
+    std::atomic<bool> open{true};
+    std::atomic<size_t> spills{0};
+
+  protected:
+    std::string my_type() const override { return "GatedConsumer"; }
+    void _recalc_axes() override {}
+    bool _accept_spill(const Spill&) override
+    {
+      while (!open)
+        std::this_thread::yield();
+      spills++;
+      return false;
+    }
+    bool _accept_events(const Spill&) override { return false; }
+    void _push_event(const EventView&) override {}
+};
+
+static size_t dropped_attribute(const Consumer& c)
+{
+  return c.metadata().get_attribute("dropped_spills").get_number();
+}
+
+TEST(ConsumerWorker, Init)
+{
+  auto c = std::make_shared<GatedConsumer>();
+  ConsumerWorker w(c, 5);
+  EXPECT_EQ(w.consumer(), c);
+  EXPECT_EQ(w.backlog(), 5UL);
+  EXPECT_EQ(w.size(), 0UL);
+  EXPECT_EQ(w.dropped_spills(), 0UL);
+}
+
+TEST(ConsumerWorker, DeliversAll)
+{
+  auto c = std::make_shared<GatedConsumer>();
+  ConsumerWorker w(c, 2);
+  for (size_t i = 0; i < 20; ++i)
+    w.enqueue(std::make_shared<Spill>("", Spill::Type::start));
+  w.drain();
+  EXPECT_EQ(c->spills.load(), 20UL);
+  EXPECT_EQ(w.dropped_spills(), 0UL);
+}
+
+TEST(ConsumerWorker, DropsRunningWhenFull)
+{
+  auto c = std::make_shared<GatedConsumer>();
+  c->open = false;
+  ConsumerWorker w(c, 3);
+
+  // first one is picked up by the worker and blocks there
+  w.enqueue(std::make_shared<Spill>("", Spill::Type::running));
+  while (w.size())
+    std::this_thread::yield();
+
+  for (size_t i = 0; i < 10; ++i)
+    w.enqueue(std::make_shared<Spill>("", Spill::Type::running));
+  EXPECT_EQ(w.size(), 3UL);
+  EXPECT_EQ(w.dropped_spills(), 7UL);
+
+  c->open = true;
+  w.drain();
+  EXPECT_EQ(c->spills.load(), 4UL);
+  EXPECT_EQ(dropped_attribute(*c), 7UL);
+}
+
+TEST(ConsumerWorker, StopSpillsWaitForRoom)
+{
+  auto c = std::make_shared<GatedConsumer>();
+  c->open = false;
+  ConsumerWorker w(c, 1);
+
+  w.enqueue(std::make_shared<Spill>("", Spill::Type::running));
+  while (w.size())
+    std::this_thread::yield();
+  w.enqueue(std::make_shared<Spill>("", Spill::Type::running));
+
+  std::thread opener([c]
+                     {
+                       std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                       c->open = true;
+                     });
+  w.enqueue(std::make_shared<Spill>("", Spill::Type::stop));
+  opener.join();
+  w.drain();
+
+  EXPECT_EQ(c->spills.load(), 3UL);
+  EXPECT_EQ(w.dropped_spills(), 0UL);
+}
@@ -37,3 +37,107 @@ TEST(Dataspace, Init)
   MockDataspace d;
   EXPECT_TRUE(d.empty());
 }
+
+TEST(Dataspace, ReadRangeEmpty)
+{
+  MockDataspace d;
+  DataBlock block;
+  block.reset_dense({0}, {5});
+  d.read_range(block);
+  EXPECT_EQ(block.layout, DataBlock::Layout::sparse);
+  EXPECT_TRUE(block.empty());
+}
+
+TEST(Dataspace, RangeSinceDefault)
+{
+  MockDataspace d;
+  DataBlock block;
+  EXPECT_EQ(d.version(), 0UL);
+  EXPECT_TRUE(d.range_since(block, 0));
+  EXPECT_TRUE(block.empty());
+}
+
+TEST(DataBlock, Sparse)
+{
+  DataBlock block;
+  block.reset_sparse(2);
+  block.push(3, 1, 5.0);
+  block.push({0, 2}, 7.0);
+  EXPECT_EQ(block.dimensions(), 2UL);
+  EXPECT_EQ(block.size(), 2UL);
+
+  std::vector<Entry> visited;
+  block.for_each([&visited](const Coords& c, double count)
+                 {
+                   visited.push_back({c, count});
+                 });
+  ASSERT_EQ(visited.size(), 2UL);
+  EXPECT_EQ(visited[0].first, Coords({3, 1}));
+  EXPECT_EQ(visited[0].second, 5);
+  EXPECT_EQ(visited[1].first, Coords({0, 2}));
+  EXPECT_EQ(visited[1].second, 7);
+}
+
+TEST(DataBlock, Dense)
+{
+  DataBlock block;
+  block.reset_dense({2, 5}, {2, 3});
+  EXPECT_EQ(block.dimensions(), 2UL);
+  ASSERT_EQ(block.size(), 6UL);
+  for (size_t i = 0; i < block.size(); ++i)
+    block.counts[i] = i;
+
+  std::vector<Entry> visited;
+  block.for_each([&visited](const Coords& c, double count)
+                 {
+                   visited.push_back({c, count});
+                 });
+  ASSERT_EQ(visited.size(), 6UL);
+  EXPECT_EQ(visited[0].first, Coords({2, 5}));
+  EXPECT_EQ(visited[2].first, Coords({2, 7}));
+  EXPECT_EQ(visited[3].first, Coords({3, 5}));
+  EXPECT_EQ(visited[5].first, Coords({3, 7}));
+  EXPECT_EQ(visited[5].second, 5);
+}
+
+TEST(DataBlock, ResetKeepsStorage)
+{
+  DataBlock block;
+  block.reset_sparse(2);
+  for (size_t i = 0; i < 100; ++i)
+    block.push(i, i, 1.0);
+  auto capacity = block.counts.capacity();
+  block.reset_sparse(2);
+  EXPECT_TRUE(block.empty());
+  EXPECT_EQ(block.counts.capacity(), capacity);
+  EXPECT_EQ(block.coords[0].capacity(), capacity);
+}
+
+TEST(DataBlock, Densify)
+{
+  DataBlock block;
+  block.reset_sparse(2);
+  block.push(1, 2, 5.0);
+  block.push(0, 0, 1.0);
+  block.densify();
+  EXPECT_EQ(block.layout, DataBlock::Layout::dense);
+  EXPECT_EQ(block.origin, Coords({0, 0}));
+  EXPECT_EQ(block.shape, Coords({2, 3}));
+  EXPECT_EQ(block.counts, std::vector<double>({1, 0, 0, 0, 0, 5}));
+}
+
+TEST(DataBlock, WriteCSV)
+{
+  DataBlock block;
+  block.reset_sparse(2);
+  block.push(1, 1, 2.0);
+  std::stringstream ss;
+  block.write_csv(ss);
+  EXPECT_EQ(ss.str(), "0, 0;\n0, 2;\n");
+
+  block.reset_dense({0}, {3});
+  block.counts[0] = 1;
+  std::stringstream ss1;
+  block.write_csv(ss1);
+  EXPECT_EQ(ss1.str(), "1, 0, 0");
+}
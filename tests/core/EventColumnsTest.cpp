@@ -0,0 +1,123 @@
+#include "gtest_color_print.h"
+#include <core/EventColumns.h>
+#include <thread>
+
+class EventColumns : public TestBase
+{
+ protected:
+  void SetUp() override
+  {
+    model.add_value("x", 100);
+    model.add_value("y", 100);
+  }
+
+  DAQuiri::EventModel model;
+  std::vector<uint32_t> times {5, 1, 3, 2};
+  std::vector<uint32_t> ids {11, 0, 23, 37};
+
+  static bool decode(DAQuiri::EventRef& e, uint32_t id)
+  {
+    if (!id)
+      return false;
+    e.set_value(0, id / 10);
+    e.set_value(1, id % 10);
+    return true;
+  }
+};
+
+TEST_F(EventColumns, Columns)
+{
+  DAQuiri::EventColumns c(nullptr, times.data(), ids.data(), times.size(),
+                          100, decode);
+  EXPECT_EQ(c.size(), 4UL);
+  EXPECT_FALSE(c.empty());
+  EXPECT_EQ(c.time_offset(), 100UL);
+  EXPECT_EQ(c.timestamp(0), 105UL);
+  EXPECT_EQ(c.timestamp(3), 102UL);
+  EXPECT_EQ(c.ids()[2], 23UL);
+  EXPECT_FALSE(c.decoded());
+}
+
+TEST_F(EventColumns, DecodeSkipsRejected)
+{
+  DAQuiri::EventColumns c(nullptr, times.data(), ids.data(), times.size(),
+                          100, decode);
+  const auto& events = c.events(model);
+  EXPECT_TRUE(c.decoded());
+  ASSERT_EQ(events.size(), 3UL);
+  EXPECT_EQ(events[0].timestamp(), 105UL);
+  EXPECT_EQ(events[0].value(0), 1UL);
+  EXPECT_EQ(events[0].value(1), 1UL);
+  EXPECT_EQ(events[1].timestamp(), 103UL);
+  EXPECT_EQ(events[2].value(0), 3UL);
+  EXPECT_EQ(events[2].value(1), 7UL);
+
+  // second call returns the same buffer
+  EXPECT_EQ(&c.events(model), &events);
+}
+
+TEST_F(EventColumns, DecodeWithoutDecoder)
+{
+  DAQuiri::EventColumns c(nullptr, times.data(), ids.data(), times.size(),
+                          0, nullptr);
+  const auto& events = c.events(model);
+  ASSERT_EQ(events.size(), 4UL);
+  EXPECT_EQ(events[1].timestamp(), 1UL);
+  EXPECT_EQ(events[1].value(0), 0UL);
+}
+
+TEST_F(EventColumns, Validates)
+{
+  DAQuiri::EventColumns plain(nullptr, times.data(), ids.data(), times.size(),
+                              0, nullptr);
+  EXPECT_TRUE(plain.validates());
+  EXPECT_TRUE(plain.valid(1));
+
+  DAQuiri::EventColumns opaque(nullptr, times.data(), ids.data(), times.size(),
+                               0, decode);
+  EXPECT_FALSE(opaque.validates());
+
+  DAQuiri::EventColumns c(nullptr, times.data(), ids.data(), times.size(),
+                          0, decode, [](uint32_t id) { return (id != 0); });
+  EXPECT_TRUE(c.validates());
+  EXPECT_TRUE(c.valid(0));
+  EXPECT_FALSE(c.valid(1));
+  EXPECT_FALSE(c.decoded());
+}
+
+TEST_F(EventColumns, KeepsOwnerAlive)
+{
+  auto owner = std::make_shared<std::vector<uint32_t>>(times);
+  std::weak_ptr<std::vector<uint32_t>> weak = owner;
+  {
+    DAQuiri::EventColumns c(owner, owner->data(), owner->data(),
+                            owner->size(), 0, nullptr);
+    owner.reset();
+    EXPECT_FALSE(weak.expired());
+    EXPECT_EQ(c.timestamp(0), 5UL);
+  }
+  EXPECT_TRUE(weak.expired());
+}
+
+TEST_F(EventColumns, ConcurrentDecodeOnce)
+{
+  std::atomic<size_t> calls {0};
+  DAQuiri::EventColumns c(nullptr, times.data(), ids.data(), times.size(), 0,
+                          [&calls](DAQuiri::EventRef& e, uint32_t id)
+                          {
+                            calls++;
+                            return decode(e, id);
+                          });
+
+  std::vector<const DAQuiri::EventBuffer*> seen(4, nullptr);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < seen.size(); ++i)
+    threads.emplace_back([&, i] { seen[i] = &c.events(model); });
+  for (auto& t : threads)
+    t.join();
+
+  EXPECT_EQ(calls.load(), times.size());
+  for (auto p : seen)
+    EXPECT_EQ(p, seen[0]);
+  EXPECT_EQ(seen[0]->size(), 3UL);
+}
@@ -1,2 +1,200 @@
 #include <gtest/gtest.h>
 #include <core/Project.h>
+#include <core/ConsumerFactory.h>
+#include <consumers/dataspaces/Dense1D.h>
+
+using namespace DAQuiri;
+
+class CountingConsumer : public Consumer
+{
+  public:
+    CountingConsumer()
+    {
+      data_ = std::make_shared<Dense1D>();
+      Setting base_options = metadata_.attributes();
+      metadata_ = ConsumerMetadata(my_type(), "Counts spills and events");
+      metadata_.overwrite_all_attributes(base_options);
+    }
+    CountingConsumer* clone() const override { return new CountingConsumer(*this); }
+
+    size_t spills{0};
+    size_t events{0};
+
+  protected:
+    std::string my_type() const override { return "CountingConsumer"; }
+    void _recalc_axes() override {}
+    bool _accept_spill(const Spill& spill) override
+    {
+      if (!Consumer::_accept_spill(spill))
+        return false;
+      spills++;
+      return true;
+    }
+    bool _accept_events(const Spill&) override { return true; }
+    void _push_event(const EventView&) override { events++; }
+};
+
+static SpillPtr make_spill(size_t events, std::string stream = "")
+{
+  auto s = std::make_shared<Spill>(stream, Spill::Type::running);
+  s->events.reserve(events, Event(EventModel()));
+  for (size_t i = 0; i < events; ++i)
+    ++s->events;
+  s->events.finalize();
+  return s;
+}
+
+TEST(Project, Init)
+{
+  Project p;
+  EXPECT_TRUE(p.empty());
+  EXPECT_EQ(p.dispatch_threads(), 1UL);
+}
+
+TEST(Project, DispatchThreads)
+{
+  Project p;
+  p.dispatch_threads(4);
+  EXPECT_EQ(p.dispatch_threads(), 4UL);
+  p.dispatch_threads(0);
+  EXPECT_EQ(p.dispatch_threads(), 1UL);
+}
+
+TEST(Project, AddSpillSerial)
+{
+  Project p;
+  std::vector<std::shared_ptr<CountingConsumer>> consumers;
+  for (size_t i = 0; i < 5; ++i)
+  {
+    consumers.push_back(std::make_shared<CountingConsumer>());
+    p.add_consumer(consumers.back());
+  }
+
+  for (size_t i = 0; i < 3; ++i)
+    p.add_spill(make_spill(10));
+
+  for (const auto& c : consumers)
+  {
+    EXPECT_EQ(c->spills, 3UL);
+    EXPECT_EQ(c->events, 30UL);
+  }
+  EXPECT_TRUE(p.has_data());
+}
+
+TEST(Project, AddSpillParallel)
+{
+  Project p;
+  p.dispatch_threads(3);
+  std::vector<std::shared_ptr<CountingConsumer>> consumers;
+  for (size_t i = 0; i < 8; ++i)
+  {
+    consumers.push_back(std::make_shared<CountingConsumer>());
+    p.add_consumer(consumers.back());
+  }
+
+  for (size_t i = 0; i < 50; ++i)
+    p.add_spill(make_spill(10));
+
+  for (const auto& c : consumers)
+  {
+    EXPECT_EQ(c->spills, 50UL);
+    EXPECT_EQ(c->events, 500UL);
+  }
+}
+
+TEST(Project, ConsumerBacklog)
+{
+  Project p;
+  p.consumer_backlog(100);
+  EXPECT_EQ(p.consumer_backlog(), 100UL);
+
+  std::vector<std::shared_ptr<CountingConsumer>> consumers;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    consumers.push_back(std::make_shared<CountingConsumer>());
+    p.add_consumer(consumers.back());
+  }
+
+  for (size_t i = 0; i < 50; ++i)
+    p.add_spill(make_spill(10));
+  p.flush();
+
+  for (const auto& c : consumers)
+  {
+    EXPECT_EQ(c->spills, 50UL);
+    EXPECT_EQ(c->events, 500UL);
+    EXPECT_EQ(c->metadata().get_attribute("dropped_spills").get_number(), 0);
+  }
+
+  p.delete_consumer(0);
+  p.add_spill(make_spill(10));
+  p.flush();
+  EXPECT_EQ(consumers[0]->spills, 50UL);
+  EXPECT_EQ(consumers[1]->spills, 51UL);
+}
+
+TEST(Project, RoutesByStream)
+{
+  Project p;
+  auto a = std::make_shared<CountingConsumer>();
+  a->set_attribute(Setting::text("stream_id", "a"));
+  auto b = std::make_shared<CountingConsumer>();
+  b->set_attribute(Setting::text("stream_id", "b"));
+  p.add_consumer(a);
+  p.add_consumer(b);
+
+  p.add_spill(make_spill(1, "a"));
+  p.add_spill(make_spill(1, "a"));
+  p.add_spill(make_spill(1, "b"));
+  p.add_spill(make_spill(1, "c"));
+  EXPECT_EQ(a->spills, 2UL);
+  EXPECT_EQ(b->spills, 1UL);
+
+  // resubscription is picked up without touching the project
+  b->set_attribute(Setting::text("stream_id", "c"));
+  p.add_spill(make_spill(1, "b"));
+  p.add_spill(make_spill(1, "c"));
+  EXPECT_EQ(b->spills, 2UL);
+
+  p.delete_consumer(0);
+  p.add_spill(make_spill(1, "a"));
+  EXPECT_EQ(a->spills, 2UL);
+}
+
+TEST(Project, ResetReroutes)
+{
+  ConsumerFactory::singleton().register_type(
+      CountingConsumer().metadata(),
+      [](void) -> Consumer* { return new CountingConsumer(); });
+
+  Project p;
+  auto a = std::make_shared<CountingConsumer>();
+  a->set_attribute(Setting::text("stream_id", "a"));
+  p.add_consumer(a);
+  p.add_spill(make_spill(1, "a"));
+  EXPECT_EQ(a->spills, 1UL);
+
+  p.reset();
+  p.add_spill(make_spill(1, "a"));
+  EXPECT_EQ(a->spills, 1UL);
+  auto fresh = std::dynamic_pointer_cast<CountingConsumer>(p.get_consumer(0));
+  ASSERT_TRUE(fresh);
+  EXPECT_NE(fresh, a);
+  EXPECT_EQ(fresh->spills, 1UL);
+}
+
+TEST(Project, SavedSpillsLeaveOriginalIntact)
+{
+  Project p;
+  p.save_spills(true);
+  p.add_consumer(std::make_shared<CountingConsumer>());
+
+  auto s = make_spill(10);
+  p.add_spill(s);
+  EXPECT_EQ(s->events.size(), 10UL);
+
+  auto saved = p.spills();
+  ASSERT_EQ(saved.size(), 1UL);
+  EXPECT_TRUE(saved.front().events.empty());
+  EXPECT_EQ(saved.front().time, s->time);
+}
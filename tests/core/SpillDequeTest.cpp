@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <core/SpillDequeue.h>
+#include <core/util/Timer.h>
 
 using namespace DAQuiri;
 
@@ -8,3 +9,237 @@ TEST(SpillDeque, Init)
   SpillDeque sd;
   EXPECT_EQ(sd.size(), 0UL);
 }
+
+static SpillPtr make_spill(std::string stream, Spill::Type type,
+                           hr_time_t time, size_t events = 0)
+{
+  auto s = std::make_shared<Spill>(stream, type);
+  s->time = time;
+  if (events)
+  {
+    EventModel model;
+    model.add_value("v", 10);
+    s->events.reserve(events, model);
+  }
+  return s;
+}
+
+TEST(SpillMultiqueue, Init)
+{
+  SpillMultiqueue q(false, 10);
+  EXPECT_EQ(q.size(), 0UL);
+  EXPECT_EQ(q.dropped_spills(), 0UL);
+  EXPECT_EQ(q.dropped_events(), 0UL);
+  EXPECT_EQ(q.accepted_events(), 0UL);
+}
+
+TEST(SpillMultiqueue, Chronological)
+{
+  SpillMultiqueue q(false, 10);
+  auto t0 = std::chrono::system_clock::now();
+  q.enqueue(make_spill("b", Spill::Type::running, t0 + std::chrono::seconds(1)));
+  q.enqueue(make_spill("b", Spill::Type::running, t0 + std::chrono::seconds(3)));
+  q.enqueue(make_spill("a", Spill::Type::running, t0 + std::chrono::seconds(2)));
+  q.enqueue(make_spill("c", Spill::Type::running, t0));
+  EXPECT_EQ(q.size(), 4UL);
+
+  EXPECT_EQ(q.dequeue()->stream_id, "c");
+  EXPECT_EQ(q.dequeue()->stream_id, "b");
+  EXPECT_EQ(q.dequeue()->stream_id, "a");
+  EXPECT_EQ(q.dequeue()->stream_id, "b");
+  EXPECT_EQ(q.size(), 0UL);
+}
+
+TEST(SpillMultiqueue, DropsRunningSpills)
+{
+  SpillMultiqueue q(true, 2);
+  auto t0 = std::chrono::system_clock::now();
+  q.enqueue(make_spill("a", Spill::Type::start, t0));
+  for (size_t i = 0; i < 4; ++i)
+    q.enqueue(make_spill("a", Spill::Type::running, t0, 5));
+  q.enqueue(make_spill("a", Spill::Type::stop, t0));
+  q.enqueue(make_spill("b", Spill::Type::running, t0, 5));
+
+  EXPECT_EQ(q.size(), 5UL);
+  EXPECT_EQ(q.dropped_spills(), 2UL);
+  EXPECT_EQ(q.dropped_events(), 10UL);
+  EXPECT_EQ(q.accepted_events(), 15UL);
+
+  // dequeuing frees space for running spills again
+  q.dequeue();
+  q.dequeue();
+  q.enqueue(make_spill("a", Spill::Type::running, t0, 5));
+  EXPECT_EQ(q.dropped_spills(), 2UL);
+  EXPECT_EQ(q.size(), 4UL);
+}
+
+TEST(SpillMultiqueue, CountsColumnEvents)
+{
+  static const std::vector<uint32_t> times {1, 2, 3};
+  SpillMultiqueue q(true, 2);
+  auto t0 = std::chrono::system_clock::now();
+  for (size_t i = 0; i < 3; ++i)
+  {
+    auto s = make_spill("a", Spill::Type::running, t0);
+    s->columns = std::make_shared<EventColumns>(
+        nullptr, times.data(), times.data(), times.size(), 0, nullptr);
+    q.enqueue(s);
+  }
+
+  EXPECT_EQ(q.dropped_spills(), 1UL);
+  EXPECT_EQ(q.dropped_events(), 3UL);
+  EXPECT_EQ(q.accepted_events(), 6UL);
+}
+
+TEST(SpillMultiqueue, KeepsAllIfNotDropping)
+{
+  SpillMultiqueue q(false, 2, 2);
+  auto t0 = std::chrono::system_clock::now();
+  for (size_t i = 0; i < 20; ++i)
+  {
+    q.enqueue(make_spill("a", Spill::Type::running, t0));
+    q.dequeue();
+  }
+  EXPECT_EQ(q.dropped_spills(), 0UL);
+}
+
+TEST(SpillMultiqueue, ReusesLanes)
+{
+  SpillMultiqueue q1(false, 10), q2(false, 10);
+  auto t0 = std::chrono::system_clock::now();
+  for (size_t i = 0; i < 5; ++i)
+  {
+    q1.enqueue(make_spill("a", Spill::Type::running, t0));
+    q2.enqueue(make_spill("a", Spill::Type::running, t0));
+  }
+  EXPECT_EQ(q1.lanes(), 1UL);
+  EXPECT_EQ(q2.lanes(), 1UL);
+
+  // more streams than the thread caches, the first ones come back anyway
+  for (size_t i = 0; i < 40; ++i)
+    q1.enqueue(make_spill(std::to_string(i), Spill::Type::running, t0));
+  q1.enqueue(make_spill("a", Spill::Type::running, t0));
+  q1.enqueue(make_spill("0", Spill::Type::running, t0));
+  EXPECT_EQ(q1.lanes(), 41UL);
+  EXPECT_EQ(q1.size(), 47UL);
+}
+
+static SpillPtr make_pulse(std::string stream, double pulse_time)
+{
+  auto s = make_spill(stream, Spill::Type::running,
+                      std::chrono::system_clock::now());
+  s->stats.set(SpillStats::pulse_time, pulse_time);
+  return s;
+}
+
+static double pulse_of(const SpillPtr& s)
+{
+  return to_double(s->stats.get(SpillStats::pulse_time));
+}
+
+TEST(SpillMultiqueue, MergesPulsesAcrossThreads)
+{
+  SpillMultiqueue q(false, 10, 1024, std::chrono::seconds(10));
+
+  // this thread gets ahead, the other one sends the start late
+  q.enqueue(make_pulse("a", 10));
+  q.enqueue(make_pulse("a", 30));
+  q.enqueue(make_pulse("a", 50));
+  std::thread worker([&q]
+                     {
+                       q.enqueue(make_spill("a", Spill::Type::start,
+                                            std::chrono::system_clock::now()));
+                       q.enqueue(make_pulse("a", 20));
+                       q.enqueue(make_pulse("a", 40));
+                     });
+  worker.join();
+  EXPECT_EQ(q.lanes(), 2UL);
+
+  EXPECT_EQ(q.dequeue()->type, Spill::Type::start);
+  EXPECT_EQ(pulse_of(q.dequeue()), 10);
+  EXPECT_EQ(pulse_of(q.dequeue()), 20);
+  EXPECT_EQ(pulse_of(q.dequeue()), 30);
+  EXPECT_EQ(pulse_of(q.dequeue()), 40);
+
+  // the worker has not reported past 50 yet
+  std::atomic<bool> done {false};
+  double last {0};
+  std::thread consumer([&q, &done, &last]
+                       {
+                         last = pulse_of(q.dequeue());
+                         done = true;
+                       });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(done.load());
+
+  // once the stream is stopping nothing more can come
+  q.enqueue(make_spill("a", Spill::Type::stop, std::chrono::system_clock::now()));
+  consumer.join();
+  EXPECT_EQ(last, 50);
+  EXPECT_EQ(q.dequeue()->type, Spill::Type::stop);
+  EXPECT_EQ(q.size(), 0UL);
+}
+
+TEST(SpillMultiqueue, HoldsAtMostHoldPeriod)
+{
+  SpillMultiqueue q(false, 10, 1024, std::chrono::milliseconds(20));
+  Timer timer(true);
+  std::thread worker([&q]
+                     {
+                       q.enqueue(make_spill("a", Spill::Type::start,
+                                            std::chrono::system_clock::now()));
+                       q.enqueue(make_pulse("a", 10));
+                     });
+  worker.join();
+  q.enqueue(make_pulse("a", 30));
+
+  EXPECT_EQ(q.dequeue()->type, Spill::Type::start);
+  EXPECT_EQ(pulse_of(q.dequeue()), 10);
+
+  // the worker falls silent, 30 goes out once the hold runs out
+  EXPECT_EQ(pulse_of(q.dequeue()), 30);
+  EXPECT_GE(timer.ms(), 19);
+}
+
+TEST(SpillMultiqueue, StopReturnsNull)
+{
+  SpillMultiqueue q(false, 10);
+  std::thread t([&q] { EXPECT_EQ(q.dequeue(), nullptr); });
+  q.stop();
+  t.join();
+}
+
+TEST(SpillMultiqueue, ManyProducers)
+{
+  SpillMultiqueue q(false, 10, 8);
+  size_t producers = 4;
+  size_t spills = 1000;
+
+  std::vector<std::thread> threads;
+  for (size_t p = 0; p < producers; ++p)
+    threads.emplace_back([&q, p, spills]
+                         {
+                           auto t0 = hr_time_t();
+                           for (size_t i = 0; i < spills; ++i)
+                             q.enqueue(make_spill(std::to_string(p),
+                                                  Spill::Type::running,
+                                                  t0 + std::chrono::microseconds(i), 1));
+                         });
+
+  std::map<std::string, hr_time_t> last;
+  for (size_t i = 0; i < producers * spills; ++i)
+  {
+    auto s = q.dequeue();
+    ASSERT_TRUE(s);
+    if (last.count(s->stream_id))
+    {
+      EXPECT_GT(s->time, last[s->stream_id]);
+    }
+    last[s->stream_id] = s->time;
+  }
+
+  for (auto& t : threads)
+    t.join();
+  EXPECT_EQ(q.size(), 0UL);
+  EXPECT_EQ(q.accepted_events(), producers * spills);
+}
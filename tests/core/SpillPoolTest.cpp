@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <core/SpillPool.h>
+
+using namespace DAQuiri;
+
+TEST(SpillPool, Init)
+{
+  auto pool = SpillPool::create();
+  EXPECT_EQ(pool->idle(), 0UL);
+  EXPECT_EQ(pool->stats().acquired, 0UL);
+  EXPECT_EQ(pool->stats().hit_rate(), 0.0);
+}
+
+TEST(SpillPool, Acquire)
+{
+  auto pool = SpillPool::create();
+  auto s = pool->acquire("a", Spill::Type::running);
+  EXPECT_EQ(s->stream_id, "a");
+  EXPECT_EQ(s->type, Spill::Type::running);
+  EXPECT_EQ(s->state.id(), "stats");
+  EXPECT_EQ(pool->stats().outstanding, 1UL);
+}
+
+TEST(SpillPool, ReturnsToPool)
+{
+  auto pool = SpillPool::create();
+  Spill* raw {nullptr};
+  {
+    auto s = pool->acquire("a", Spill::Type::running);
+    raw = s.get();
+    auto copy = s;
+  }
+  EXPECT_EQ(pool->idle(), 1UL);
+  EXPECT_EQ(pool->stats().outstanding, 0UL);
+
+  auto s = pool->acquire("b", Spill::Type::stop);
+  EXPECT_EQ(s.get(), raw);
+  EXPECT_EQ(pool->idle(), 0UL);
+  EXPECT_EQ(pool->stats().acquired, 2UL);
+  EXPECT_EQ(pool->stats().reused, 1UL);
+  EXPECT_EQ(pool->stats().hit_rate(), 0.5);
+}
+
+TEST(SpillPool, RecycledSpillIsClean)
+{
+  auto pool = SpillPool::create();
+  {
+    auto s = pool->acquire("a", Spill::Type::running);
+    EventModel model;
+    model.add_value("v", 10);
+    s->event_model = model;
+    s->events.reserve(100, model);
+    s->events.finalize();
+    s->raw.resize(10);
+    s->state.branches.add(Setting::integer("x", 1));
+  }
+
+  auto s = pool->acquire("b", Spill::Type::daq_status);
+  EXPECT_EQ(s->stream_id, "b");
+  EXPECT_EQ(s->type, Spill::Type::daq_status);
+  EXPECT_TRUE(s->events.empty());
+  EXPECT_TRUE(s->raw.empty());
+  EXPECT_TRUE(s->event_model.values.empty());
+  EXPECT_TRUE(s->state.branches.empty());
+  EXPECT_EQ(s->state.id(), Setting().id());
+}
+
+TEST(SpillPool, PeakOutstanding)
+{
+  auto pool = SpillPool::create();
+  std::vector<SpillPtr> held;
+  for (size_t i = 0; i < 5; ++i)
+    held.push_back(pool->acquire("a", Spill::Type::running));
+  held.clear();
+  held.push_back(pool->acquire("a", Spill::Type::running));
+
+  auto stats = pool->stats();
+  EXPECT_EQ(stats.outstanding, 1UL);
+  EXPECT_EQ(stats.peak_outstanding, 5UL);
+  EXPECT_EQ(pool->idle(), 4UL);
+}
+
+TEST(SpillPool, MaxIdle)
+{
+  auto pool = SpillPool::create(2);
+  std::vector<SpillPtr> held;
+  for (size_t i = 0; i < 5; ++i)
+    held.push_back(pool->acquire("a", Spill::Type::running));
+  held.clear();
+  EXPECT_EQ(pool->idle(), 2UL);
+}
+
+TEST(SpillPool, OutlivesPool)
+{
+  auto pool = SpillPool::create();
+  auto s = pool->acquire("a", Spill::Type::running);
+  pool.reset();
+  EXPECT_EQ(s->stream_id, "a");
+  s.reset();
+}
+
+TEST(SpillPool, ReleasesColumns)
+{
+  auto pool = SpillPool::create();
+  auto owner = std::make_shared<int>(0);
+  std::weak_ptr<int> weak = owner;
+  {
+    auto s = pool->acquire("a", Spill::Type::running);
+    s->columns = std::make_shared<EventColumns>(owner, nullptr, nullptr, 0, 0, nullptr);
+  }
+  owner.reset();
+  EXPECT_EQ(pool->idle(), 1UL);
+  EXPECT_TRUE(weak.expired());
+}
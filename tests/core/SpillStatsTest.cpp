@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <core/SpillStats.h>
+
+using namespace DAQuiri;
+
+TEST(SpillStats, Init)
+{
+  SpillStats s;
+  EXPECT_TRUE(s.empty());
+  EXPECT_FALSE(s.has(SpillStats::native_time));
+  EXPECT_EQ(s.get(SpillStats::native_time), 0);
+}
+
+TEST(SpillStats, SetGet)
+{
+  SpillStats s;
+  s.set(SpillStats::pulse_time, 12345678901234);
+  EXPECT_FALSE(s.empty());
+  EXPECT_TRUE(s.has(SpillStats::pulse_time));
+  EXPECT_FALSE(s.has(SpillStats::native_time));
+  EXPECT_EQ(s.get(SpillStats::pulse_time), 12345678901234);
+
+  s.clear();
+  EXPECT_TRUE(s.empty());
+  EXPECT_EQ(s.get(SpillStats::pulse_time), 0);
+}
+
+TEST(SpillStats, Names)
+{
+  for (size_t i = 0; i < SpillStats::field_count; ++i)
+  {
+    auto f = SpillStats::Field(i);
+    EXPECT_FALSE(SpillStats::name(f).empty());
+    EXPECT_EQ(SpillStats::field(SpillStats::name(f)), f);
+  }
+  EXPECT_EQ(SpillStats::field("native_time"), SpillStats::native_time);
+  EXPECT_EQ(SpillStats::field("bogus"), SpillStats::field_count);
+}
+
+TEST(SpillStats, Compare)
+{
+  SpillStats a, b;
+  EXPECT_EQ(a, b);
+  a.set(SpillStats::live_time, 5);
+  EXPECT_FALSE(a == b);
+  b.set(SpillStats::live_time, 5);
+  EXPECT_EQ(a, b);
+  b.set(SpillStats::live_time, 6);
+  EXPECT_FALSE(a == b);
+}
+
+TEST(SpillStats, ToAndFromSetting)
+{
+  SpillStats s;
+  s.set(SpillStats::native_time, 100);
+  s.set(SpillStats::dropped_buffers, 3);
+
+  Setting tree = Setting::stem("stats");
+  tree.branches.add_a(Setting::text("source_name", "detector"));
+  s.to_setting(tree);
+  EXPECT_EQ(tree.branches.size(), 3UL);
+  EXPECT_EQ(tree.find(Setting("native_time")).get_number(), 100);
+
+  SpillStats s2;
+  s2.from_setting(tree);
+  EXPECT_EQ(s2, s);
+  EXPECT_EQ(tree.branches.size(), 1UL);
+  EXPECT_TRUE(tree.find(Setting("source_name")));
+}
+
+TEST(SpillStats, FromSettingAnyNumeric)
+{
+  Setting tree = Setting::stem("stats");
+  tree.branches.add_a(Setting::integer("queue_size", 7));
+  tree.branches.add_a(Setting::floating("live_time", 2.5));
+  tree.branches.add_a(Setting::text("pulse_time", "not a number"));
+
+  SpillStats s;
+  s.from_setting(tree);
+  EXPECT_EQ(s.get(SpillStats::queue_size), 7);
+  EXPECT_EQ(s.get(SpillStats::live_time), 2.5);
+  EXPECT_FALSE(s.has(SpillStats::pulse_time));
+  EXPECT_EQ(tree.branches.size(), 1UL);
+}
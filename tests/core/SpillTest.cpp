@@ -71,6 +71,144 @@ TEST_F(EventBuffer, iterate)
   }
 }
 
+TEST_F(EventBuffer, reserve_from_model)
+{
+  DAQuiri::EventModel hm;
+  hm.add_value("x", 16);
+  hm.add_value("y", 16);
+  hm.add_trace("wave", {2, 3});
+
+  DAQuiri::EventBuffer eb;
+  eb.reserve(5, hm);
+  EXPECT_EQ(eb.size(), 5UL);
+  EXPECT_EQ(eb.value_count(), 2UL);
+  EXPECT_EQ(eb.trace_count(), 1UL);
+  EXPECT_EQ(eb.last().value_count(), 2UL);
+  EXPECT_EQ(eb.last().trace(0).size(), 6UL);
+  EXPECT_ANY_THROW(eb.last().trace(1));
+}
+
+TEST_F(EventBuffer, grow_keeps_events)
+{
+  DAQuiri::EventModel hm;
+  hm.add_value("x", 16);
+  hm.add_value("y", 16);
+
+  DAQuiri::EventBuffer eb;
+  eb.reserve(2, hm);
+  for (size_t i=0; i < 2; ++i)
+  {
+    eb.last().set_time(i);
+    eb.last().set_value(0, i);
+    eb.last().set_value(1, 10 + i);
+    ++eb;
+  }
+
+  eb.reserve(4, hm);
+  for (size_t i=2; i < 4; ++i)
+  {
+    eb.last().set_time(i);
+    eb.last().set_value(0, i);
+    eb.last().set_value(1, 10 + i);
+    ++eb;
+  }
+  eb.finalize();
+
+  ASSERT_EQ(eb.size(), 4UL);
+  for (size_t i=0; i < 4; ++i)
+  {
+    EXPECT_EQ(eb[i].timestamp(), i);
+    EXPECT_EQ(eb[i].value(0), i);
+    EXPECT_EQ(eb[i].value(1), 10 + i);
+    EXPECT_EQ(eb.timestamps()[i], i);
+    EXPECT_EQ(eb.values(0)[i], i);
+    EXPECT_EQ(eb.values(1)[i], 10 + i);
+  }
+}
+
+TEST_F(EventBuffer, traces)
+{
+  DAQuiri::EventModel hm;
+  hm.add_value("energy", 16);
+  hm.add_trace("a", {3});
+  hm.add_trace("b", {2});
+
+  DAQuiri::EventBuffer eb;
+  eb.reserve(3, hm);
+  for (size_t i=0; i < 3; ++i)
+  {
+    auto evt = eb.last();
+    for (size_t j=0; j < 3; ++j)
+      evt.trace(0)[j] = i * 10 + j;
+    for (size_t j=0; j < 2; ++j)
+      evt.trace(1)[j] = i * 100 + j;
+    ++eb;
+  }
+  eb.finalize();
+
+  size_t i {0};
+  for (const auto& e : eb)
+  {
+    auto a = e.trace(0);
+    ASSERT_EQ(a.size(), 3UL);
+    EXPECT_EQ(a[2], i * 10 + 2);
+    auto b = e.trace(1);
+    ASSERT_EQ(b.size(), 2UL);
+    EXPECT_EQ(b[1], i * 100 + 1);
+    i++;
+  }
+}
+
+TEST_F(EventBuffer, clear_and_reuse)
+{
+  DAQuiri::EventModel hm;
+  hm.add_value("x", 16);
+
+  DAQuiri::EventBuffer eb;
+  eb.reserve(3, hm);
+  eb.last().set_value(0, 5);
+  ++eb;
+  eb.finalize();
+  ASSERT_EQ(eb.size(), 1UL);
+
+  eb.clear();
+  EXPECT_TRUE(eb.empty());
+
+  eb.reserve(2, hm);
+  EXPECT_EQ(eb.last().value(0), 0U);
+  eb.last().set_value(0, 7);
+  ++eb;
+  eb.finalize();
+  ASSERT_EQ(eb.size(), 1UL);
+  EXPECT_EQ(eb[0].value(0), 7U);
+}
+
+TEST_F(EventBuffer, copy_out_and_in)
+{
+  DAQuiri::EventModel hm;
+  hm.add_value("energy", 16);
+  hm.add_trace("wave", {3});
+
+  DAQuiri::Event h(hm);
+  h.set_time(7);
+  h.set_value(0, 42);
+  h.trace(0) = std::vector<uint32_t>({3,6,9});
+
+  DAQuiri::EventBuffer eb;
+  eb.reserve(1, hm);
+  eb.last().assign(h);
+  ++eb;
+  eb.finalize();
+
+  DAQuiri::Event copy(eb[0]);
+  EXPECT_EQ(copy, h);
+  EXPECT_EQ(eb[0].debug(), h.debug());
+
+  std::vector<DAQuiri::Event> events(eb.begin(), eb.end());
+  ASSERT_EQ(events.size(), 1UL);
+  EXPECT_EQ(events[0], h);
+}
+
 class Spill : public TestBase
 {
  protected:
@@ -167,4 +305,76 @@ TEST_F(Spill, DebugString)
   s.raw.resize(25);
 
   EXPECT_FALSE(s.debug("").empty());
-}
\ No newline at end of file
+}
+TEST_F(Spill, NonemptyIfStatsDefined)
+{
+  DAQuiri::Spill s;
+  s.stats.set(DAQuiri::SpillStats::native_time, 1);
+  EXPECT_FALSE(s.empty());
+}
+
+TEST_F(Spill, FindStat)
+{
+  DAQuiri::Spill s;
+  PreciseFloat v {0};
+  EXPECT_FALSE(s.find_stat(DAQuiri::SpillStats::native_time, v));
+
+  s.state = DAQuiri::Setting::stem("stats");
+  s.state.branches.add_a(DAQuiri::Setting::integer("native_time", 10));
+  s.state.branches.add_a(DAQuiri::Setting::text("live_time", "bogus"));
+  EXPECT_TRUE(s.find_stat(DAQuiri::SpillStats::native_time, v));
+  EXPECT_EQ(v, 10);
+  EXPECT_FALSE(s.find_stat(DAQuiri::SpillStats::live_time, v));
+
+  s.stats.set(DAQuiri::SpillStats::native_time, 20);
+  EXPECT_TRUE(s.find_stat(DAQuiri::SpillStats::native_time, v));
+  EXPECT_EQ(v, 20);
+}
+
+TEST_F(Spill, FullState)
+{
+  DAQuiri::Spill s;
+  EXPECT_FALSE(s.full_state());
+
+  s.stats.set(DAQuiri::SpillStats::live_time, 5);
+  auto st = s.full_state();
+  EXPECT_TRUE(st);
+  EXPECT_EQ(st.find(DAQuiri::Setting("live_time")).get_number(), 5);
+  EXPECT_FALSE(s.state);
+}
+
+TEST_F(Spill, StatsJsonRoundTrip)
+{
+  DAQuiri::Spill s("stream_id_x", DAQuiri::Spill::Type::running);
+  s.state = DAQuiri::Setting::stem("stats");
+  s.state.branches.add_a(DAQuiri::Setting::text("source_name", "det"));
+  s.stats.set(DAQuiri::SpillStats::pulse_time, 123456789);
+
+  json j = s;
+  DAQuiri::Spill s2 = j;
+  EXPECT_EQ(s2.stats, s.stats);
+  EXPECT_EQ(s2.state.find(DAQuiri::Setting("source_name")).get_text(), "det");
+  EXPECT_FALSE(s2.state.find(DAQuiri::Setting("pulse_time")));
+}
+
+TEST_F(Spill, EventsFromColumns)
+{
+  static const std::vector<uint32_t> times {1, 2, 3};
+  static const std::vector<uint32_t> ids {4, 5, 6};
+
+  DAQuiri::Spill s;
+  s.event_model = model;
+  EXPECT_EQ(&s.event_buffer(), &s.events);
+
+  s.columns = std::make_shared<DAQuiri::EventColumns>(
+      nullptr, times.data(), ids.data(), times.size(), 10, nullptr);
+  EXPECT_FALSE(s.empty());
+  EXPECT_EQ(s.event_count(), 3UL);
+  EXPECT_FALSE(s.columns->decoded());
+
+  const auto& events = s.event_buffer();
+  EXPECT_TRUE(s.columns->decoded());
+  ASSERT_EQ(events.size(), 3UL);
+  EXPECT_EQ(events[2].timestamp(), 13UL);
+  EXPECT_TRUE(s.events.empty());
+}
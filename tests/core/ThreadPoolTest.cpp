@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include <core/ThreadPool.h>
+
+using namespace DAQuiri;
+
+TEST(ThreadPool, Init)
+{
+  ThreadPool p1(1);
+  EXPECT_EQ(p1.size(), 1UL);
+
+  ThreadPool p4(4);
+  EXPECT_EQ(p4.size(), 4UL);
+}
+
+TEST(ThreadPool, SerialWithoutWorkers)
+{
+  ThreadPool pool(1);
+  std::vector<size_t> order;
+  pool.parallel_for(5, [&order](size_t i) { order.push_back(i); });
+  EXPECT_EQ(order, std::vector<size_t>({0, 1, 2, 3, 4}));
+}
+
+TEST(ThreadPool, EachJobRunsOnce)
+{
+  ThreadPool pool(4);
+  std::vector<std::atomic<size_t>> hits(1000);
+  for (size_t round = 0; round < 20; ++round)
+    pool.parallel_for(hits.size(), [&hits](size_t i) { hits[i]++; });
+  for (const auto& h : hits)
+    EXPECT_EQ(h.load(), 20UL);
+}
+
+TEST(ThreadPool, NoJobs)
+{
+  ThreadPool pool(3);
+  size_t calls {0};
+  pool.parallel_for(0, [&calls](size_t) { calls++; });
+  EXPECT_EQ(calls, 0UL);
+}
+
+TEST(ThreadPool, RethrowsException)
+{
+  ThreadPool pool(3);
+  EXPECT_THROW(pool.parallel_for(10, [](size_t i)
+                                 {
+                                   if (i == 7)
+                                     throw std::runtime_error("bad job");
+                                 }),
+               std::runtime_error);
+
+  // still usable afterwards
+  std::atomic<size_t> calls {0};
+  pool.parallel_for(10, [&calls](size_t) { calls++; });
+  EXPECT_EQ(calls.load(), 10UL);
+}
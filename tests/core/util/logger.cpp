@@ -0,0 +1,124 @@
+#include "gtest_color_print.h"
+#include <core/util/logger.h>
+
+#include <sstream>
+#include <thread>
+
+class RateLimit : public TestBase
+{
+};
+
+static void expect_quiet(CustomLogger::RateLimit::Verdict v)
+{
+  EXPECT_FALSE(v.log);
+}
+
+static void expect_logged(CustomLogger::RateLimit::Verdict v)
+{
+  EXPECT_TRUE(v.log);
+  EXPECT_FALSE(v.summary);
+}
+
+static void expect_summary(CustomLogger::RateLimit::Verdict v,
+                           uint64_t suppressed)
+{
+  EXPECT_TRUE(v.log);
+  EXPECT_TRUE(v.summary);
+  EXPECT_EQ(v.suppressed, suppressed);
+}
+
+TEST_F(RateLimit, BurstThenQuiet)
+{
+  CustomLogger::RateLimit limit(3, std::chrono::hours(1));
+  expect_logged(limit.count());
+  expect_logged(limit.count());
+  expect_logged(limit.count());
+  for (size_t i = 0; i < 100; ++i)
+    expect_quiet(limit.count());
+  EXPECT_EQ(limit.total(), 103UL);
+}
+
+TEST_F(RateLimit, PeriodicSummary)
+{
+  CustomLogger::RateLimit limit(1, std::chrono::milliseconds(20));
+  expect_logged(limit.count());
+  for (size_t i = 0; i < 10; ++i)
+    expect_quiet(limit.count());
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  expect_summary(limit.count(), 10);
+  expect_quiet(limit.count());
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  expect_summary(limit.count(), 1);
+
+  // nothing suppressed since, still reported as a summary
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  expect_summary(limit.count(), 0);
+  EXPECT_EQ(limit.total(), 15UL);
+}
+
+/// log lines written while it is alive, the usual logger is back after
+class CapturedLog
+{
+  public:
+    CapturedLog()
+      : previous_(spdlog::default_logger())
+    {
+      CustomLogger::initLogger(spdlog::level::warn, "", &stream_);
+    }
+
+    ~CapturedLog()
+    {
+      spdlog::set_default_logger(previous_);
+    }
+
+    std::vector<std::string> lines()
+    {
+      spdlog::default_logger()->flush();
+      std::vector<std::string> ret;
+      std::istringstream in(stream_.str());
+      for (std::string line; std::getline(in, line);)
+        ret.push_back(line);
+      return ret;
+    }
+
+  private:
+    std::shared_ptr<spdlog::logger> previous_;
+    std::ostringstream stream_;
+};
+
+static bool ends_with(const std::string& s, const std::string& end)
+{
+  return (s.size() >= end.size())
+      && (s.compare(s.size() - end.size(), end.size(), end) == 0);
+}
+
+TEST_F(RateLimit, Macro)
+{
+  CapturedLog log;
+  for (size_t i = 0; i < 1000; ++i)
+    WARN_LIMITED("<RateLimit> test warning {}", i);
+
+  // default burst of 10, the summary is not due within the default interval
+  auto lines = log.lines();
+  ASSERT_EQ(lines.size(), 10UL);
+  EXPECT_TRUE(ends_with(lines.front(), "<RateLimit> test warning 0"));
+  EXPECT_TRUE(ends_with(lines.back(), "<RateLimit> test warning 9"));
+}
+
+TEST_F(RateLimit, MacroSummary)
+{
+  CapturedLog log;
+  CustomLogger::RateLimit limit(1, std::chrono::milliseconds(20));
+  LOG_COUNTED(limit, spdlog::level::warn, "<RateLimit> counted {}", 0);
+  LOG_COUNTED(limit, spdlog::level::warn, "<RateLimit> counted {}", 1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  LOG_COUNTED(limit, spdlog::level::warn, "<RateLimit> counted {}", 2);
+  LOG_COUNTED(limit, spdlog::level::warn, "<RateLimit> counted {}", 3);
+
+  auto lines = log.lines();
+  ASSERT_EQ(lines.size(), 2UL);
+  EXPECT_TRUE(ends_with(lines[0], "<RateLimit> counted 0"));
+  EXPECT_TRUE(ends_with(lines[1], "<RateLimit> counted 2 (1 more suppressed)"));
+}
@@ -0,0 +1,102 @@
+#include "gtest_color_print.h"
+#include <producers/ESSStream/ESSGeometryPlugin.h>
+#include <limits>
+
+using namespace DAQuiri;
+
+class GeometryPlugin : public TestBase
+{
+  protected:
+    void configure(uint32_t nx, uint32_t ny, uint32_t nz, uint32_t np)
+    {
+      auto set = plugin.settings();
+      set.set(Setting::integer("ESSGeometry/extent_x", nx));
+      set.set(Setting::integer("ESSGeometry/extent_y", ny));
+      set.set(Setting::integer("ESSGeometry/extent_z", nz));
+      set.set(Setting::integer("ESSGeometry/panels", np));
+      plugin.settings(set);
+      reference = ESSGeometry(nx, ny, nz, np);
+    }
+
+    /// ids at the edges of the range and beyond 16 bits
+    std::vector<uint32_t> edges()
+    {
+      uint32_t max = reference.nx() * reference.ny()
+          * reference.nz() * reference.np();
+      return {0, 1, 2, max - 1, max, max + 1, max + 2,
+              65535, 65536, 65537, 100000,
+              std::numeric_limits<uint32_t>::max()};
+    }
+
+    /// fill, decoder, validator and invalid_count must agree with the
+    /// computed geometry, whether they go through the lookup table or not
+    void expect_as_computed()
+    {
+      EventModel model;
+      plugin.define(model);
+      EventBuffer events;
+      events.reserve(1, model);
+      auto decode = plugin.decoder();
+      auto valid = plugin.validator();
+
+      auto ids = edges();
+      size_t invalid {0};
+      for (auto id : ids)
+      {
+        bool expected = reference.valid_id(id);
+        invalid += !expected;
+        auto e = events.last();
+        EXPECT_EQ(valid(id), expected) << "id=" << id;
+        EXPECT_EQ(decode(e, id), expected) << "id=" << id;
+        ASSERT_EQ(plugin.fill(e, id), expected) << "id=" << id;
+        if (!expected)
+          continue;
+        EXPECT_EQ(e.value(0), reference.x(id)) << "id=" << id;
+        EXPECT_EQ(e.value(1), reference.y(id)) << "id=" << id;
+        EXPECT_EQ(e.value(2), reference.z(id)) << "id=" << id;
+        EXPECT_EQ(e.value(3), reference.p(id)) << "id=" << id;
+      }
+      EXPECT_EQ(plugin.invalid_count(ids.data(), ids.size()), invalid);
+    }
+
+    ESSGeometryPlugin plugin;
+    ESSGeometry reference {1, 1, 1, 1};
+};
+
+TEST_F(GeometryPlugin, Settings)
+{
+  configure(4, 3, 2, 1);
+  auto set = plugin.settings();
+  EXPECT_EQ(set.find({"ESSGeometry/extent_x"}).get_number(), 4);
+  EXPECT_EQ(set.find({"ESSGeometry/extent_y"}).get_number(), 3);
+  EXPECT_EQ(set.find({"ESSGeometry/extent_z"}).get_number(), 2);
+  EXPECT_EQ(set.find({"ESSGeometry/panels"}).get_number(), 1);
+}
+
+TEST_F(GeometryPlugin, SmallGeometry)
+{
+  configure(4, 4, 1, 1);
+  expect_as_computed();
+}
+
+TEST_F(GeometryPlugin, LookupBeyond16Bits)
+{
+  configure(512, 256, 1, 2);
+  expect_as_computed();
+}
+
+TEST_F(GeometryPlugin, ComputedWithoutLookup)
+{
+  // too wide for 16-bit coordinates in the lookup table
+  configure(70000, 2, 1, 1);
+  expect_as_computed();
+}
+
+TEST_F(GeometryPlugin, ChangedExtentsRebuild)
+{
+  configure(4, 4, 1, 1);
+  configure(4, 4, 1, 1);
+  expect_as_computed();
+  configure(8, 4, 1, 1);
+  expect_as_computed();
+}
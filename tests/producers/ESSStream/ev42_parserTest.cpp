@@ -0,0 +1,149 @@
+#include "gtest_color_print.h"
+#include <producers/ESSStream/ev42_parser.h>
+#include "ev42_events_generated.h"
+
+using namespace DAQuiri;
+
+using Buffer = std::vector<uint8_t>;
+
+static Buffer make_message(uint64_t id, uint64_t pulse_time,
+                           std::vector<uint32_t> tofs,
+                           std::vector<uint32_t> pixels)
+{
+  flatbuffers::FlatBufferBuilder fbb;
+  auto m = CreateEventMessageDirect(fbb, "test", id, pulse_time, &tofs, &pixels);
+  FinishEventMessageBuffer(fbb, m);
+  return Buffer(fbb.GetBufferPointer(), fbb.GetBufferPointer() + fbb.GetSize());
+}
+
+/// events of all running spills of the same pulse, in order
+struct Pulse
+{
+  PreciseFloat time;
+  size_t spills {0};
+  std::vector<uint64_t> timestamps;
+  std::vector<uint32_t> x;
+};
+
+static std::vector<Pulse> drain(SpillMultiqueue& queue)
+{
+  std::vector<Pulse> ret;
+  while (queue.size())
+  {
+    auto spill = queue.dequeue();
+    if (spill->type != Spill::Type::running)
+      continue;
+    PreciseFloat time {-1};
+    spill->find_stat(SpillStats::pulse_time, time);
+    if (ret.empty() || (ret.back().time != time))
+    {
+      ret.emplace_back();
+      ret.back().time = time;
+    }
+    ret.back().spills++;
+    for (auto e : spill->events)
+    {
+      ret.back().timestamps.push_back(e.timestamp());
+      ret.back().x.push_back(e.value(0));
+    }
+  }
+  return ret;
+}
+
+class ev42Parser : public TestBase
+{
+  protected:
+    virtual void SetUp()
+    {
+      configure(batched);
+      configure(single);
+
+      // 16 pixels, id 17 is out of range
+      messages.push_back(make_message(1, 1000, {1, 2}, {1, 6}));
+      messages.push_back(make_message(2, 1000, {3}, {16}));
+      messages.push_back(make_message(3, 2000, {5}, {17}));
+      messages.push_back(make_message(4, 3000, {7, 8, 9}, {2, 3, 4}));
+      messages.push_back(make_message(5, 3000, {}, {}));
+      messages.push_back(make_message(6, 3000, {4}, {5}));
+      for (auto& m : messages)
+        payloads.push_back(m.data());
+    }
+
+    static void configure(ev42_events& parser)
+    {
+      std::string r {parser.plugin_name()};
+      auto set = parser.settings();
+      set.set(Setting::text(r + "/StreamID", "stream"));
+      set.set(Setting::integer("ESSGeometry/extent_x", 4));
+      set.set(Setting::integer("ESSGeometry/extent_y", 4));
+      set.set(Setting::integer("ESSGeometry/extent_z", 1));
+      set.set(Setting::integer("ESSGeometry/panels", 1));
+      parser.settings(set);
+    }
+
+    ev42_events batched;
+    ev42_events single;
+    std::vector<Buffer> messages;
+    std::vector<void*> payloads;
+};
+
+TEST_F(ev42Parser, BatchMatchesMessages)
+{
+  SpillMultiqueue batched_queue(false, 100);
+  batched.process_payloads(&batched_queue, payloads);
+  auto batch = drain(batched_queue);
+
+  SpillMultiqueue single_queue(false, 100);
+  for (auto p : payloads)
+    single.process_payload(&single_queue, p);
+  auto each = drain(single_queue);
+
+  ASSERT_EQ(batch.size(), 3UL);
+  ASSERT_EQ(batch.size(), each.size());
+  for (size_t i = 0; i < batch.size(); ++i)
+  {
+    EXPECT_EQ(batch[i].time, each[i].time);
+    EXPECT_EQ(batch[i].spills, 1UL);
+    EXPECT_EQ(batch[i].timestamps, each[i].timestamps);
+    EXPECT_EQ(batch[i].x, each[i].x);
+  }
+  EXPECT_EQ(batch[0].timestamps.size(), 3UL);
+  EXPECT_TRUE(batch[1].timestamps.empty());
+  EXPECT_EQ(batch[2].timestamps.size(), 4UL);
+  EXPECT_EQ(batched.stream_state->out_of_range_pixels.load(), 1UL);
+  EXPECT_EQ(batched.stream_state->out_of_range_pixels.load(),
+            single.stream_state->out_of_range_pixels.load());
+}
+
+TEST_F(ev42Parser, SharedStreamStartsAndStopsOnce)
+{
+  // as for the parsers of two threads consuming the same stream
+  single.stream_state = batched.stream_state;
+
+  SpillMultiqueue queue(false, 100);
+  for (size_t i = 0; i < payloads.size(); ++i)
+    (i % 2 ? single : batched).process_payload(&queue, payloads[i]);
+  batched.stop(&queue);
+  single.stop(&queue);
+
+  size_t starts {0};
+  size_t stops {0};
+  size_t running {0};
+  while (queue.size())
+  {
+    auto spill = queue.dequeue();
+    starts += (spill->type == Spill::Type::start);
+    stops += (spill->type == Spill::Type::stop);
+    running += (spill->type == Spill::Type::running);
+    if (spill->type == Spill::Type::stop)
+    {
+      PreciseFloat out_of_range {0};
+      spill->find_stat(SpillStats::out_of_range_pixels, out_of_range);
+      EXPECT_EQ(out_of_range, 1);
+      EXPECT_EQ(running, 5UL);
+    }
+  }
+  EXPECT_EQ(starts, 1UL);
+  EXPECT_EQ(stops, 1UL);
+  EXPECT_FALSE(batched.stream_state->started.load());
+}
@@ -0,0 +1,221 @@
+#include "gtest_color_print.h"
+#include <producers/ESSStream/ev44_parser.h>
+#include "ev44_events_generated.h"
+
+using namespace DAQuiri;
+
+using Buffer = std::vector<uint8_t>;
+
+static Buffer make_message(std::string source, int64_t id,
+                           std::vector<int64_t> times,
+                           std::vector<int32_t> index,
+                           std::vector<int32_t> tofs,
+                           std::vector<int32_t> pixels)
+{
+  flatbuffers::FlatBufferBuilder fbb;
+  auto m = CreateEvent44MessageDirect(fbb, source.c_str(), id,
+                                      &times, &index, &tofs, &pixels);
+  FinishEvent44MessageBuffer(fbb, m);
+  return Buffer(fbb.GetBufferPointer(), fbb.GetBufferPointer() + fbb.GetSize());
+}
+
+/// one pulse per message
+static Buffer make_message(std::string source, int64_t id, int64_t pulse_time,
+                           std::vector<int32_t> tofs,
+                           std::vector<int32_t> pixels)
+{
+  return make_message(source, id, {pulse_time}, {0}, tofs, pixels);
+}
+
+/// what one running spill holds, whether decoded or left in the message
+struct PulseEvents
+{
+  PreciseFloat time {-1};
+  std::vector<uint64_t> timestamps;
+  bool zero_copy {false};
+};
+
+class ev44Parser : public TestBase
+{
+  protected:
+    virtual void SetUp()
+    {
+      set = parser.settings();
+      set.set(Setting::text("ev44_events/StreamID", "stream"));
+      set.set(Setting::integer("ESSGeometry/extent_x", 4));
+      set.set(Setting::integer("ESSGeometry/extent_y", 4));
+      set.set(Setting::integer("ESSGeometry/extent_z", 1));
+      set.set(Setting::integer("ESSGeometry/panels", 1));
+      parser.settings(set);
+    }
+
+    /// running spills of one message
+    size_t process(Buffer message)
+    {
+      parser.process_payload(&queue, message.data());
+      size_t ret {0};
+      while (queue.size())
+        ret += (queue.dequeue()->type == Spill::Type::running);
+      return ret;
+    }
+
+    /// running spills of messages processed so far
+    std::vector<PulseEvents> drain()
+    {
+      std::vector<PulseEvents> ret;
+      while (queue.size())
+      {
+        auto spill = queue.dequeue();
+        if (spill->type != Spill::Type::running)
+          continue;
+        ret.emplace_back();
+        spill->find_stat(SpillStats::pulse_time, ret.back().time);
+        if (spill->columns)
+        {
+          ret.back().zero_copy = true;
+          for (size_t i = 0; i < spill->columns->size(); ++i)
+            ret.back().timestamps.push_back(spill->columns->timestamp(i));
+        }
+        else
+          for (auto e : spill->events)
+            ret.back().timestamps.push_back(e.timestamp());
+      }
+      return ret;
+    }
+
+    ev44_events parser;
+    Setting set;
+    SpillMultiqueue queue {false, 100};
+};
+
+TEST_F(ev44Parser, FiltersSourceName)
+{
+  set.set(Setting::boolean("ev44_events/FilterSourceName", true));
+  set.set(Setting::text("ev44_events/SourceName", "detector"));
+  parser.settings(set);
+
+  EXPECT_EQ(process(make_message("detector", 1, 1000, {1}, {1})), 1UL);
+  EXPECT_EQ(process(make_message("detectors", 2, 2000, {1}, {1})), 0UL);
+  EXPECT_EQ(process(make_message("detect", 3, 3000, {1}, {1})), 0UL);
+  EXPECT_EQ(process(make_message("", 4, 4000, {1}, {1})), 0UL);
+}
+
+TEST_F(ev44Parser, AnySourceIfNotFiltering)
+{
+  set.set(Setting::text("ev44_events/SourceName", "detector"));
+  parser.settings(set);
+
+  EXPECT_EQ(process(make_message("other", 1, 1000, {1}, {1})), 1UL);
+}
+
+TEST_F(ev44Parser, RejectsOutOfOrder)
+{
+  set.set(Setting::integer("ev44_events/MessageOrdering", 2));
+  parser.settings(set);
+
+  EXPECT_EQ(process(make_message("detector", 2, 1000, {1}, {1})), 1UL);
+  EXPECT_EQ(process(make_message("detector", 1, 2000, {1}, {1})), 0UL);
+  EXPECT_EQ(process(make_message("detector", 2, 3000, {1}, {1})), 0UL);
+  EXPECT_EQ(process(make_message("detector", 3, 4000, {1}, {1})), 1UL);
+}
+
+TEST_F(ev44Parser, WarnsOutOfOrder)
+{
+  set.set(Setting::integer("ev44_events/MessageOrdering", 1));
+  parser.settings(set);
+
+  EXPECT_EQ(process(make_message("detector", 2, 1000, {1}, {1})), 1UL);
+  EXPECT_EQ(process(make_message("detector", 1, 2000, {1}, {1})), 1UL);
+}
+
+TEST_F(ev44Parser, CountsOutOfRangePixels)
+{
+  // 16 pixels, ids 0 and 17 are out of range
+  parser.process_payload(&queue,
+                         make_message("detector", 1, 1000,
+                                      {1, 2, 3}, {0, 5, 17}).data());
+
+  EXPECT_EQ(parser.stream_state->out_of_range_pixels.load(), 2UL);
+  size_t events {0};
+  while (queue.size())
+    events += queue.dequeue()->events.size();
+  EXPECT_EQ(events, 1UL);
+}
+
+TEST_F(ev44Parser, SplitsPulses)
+{
+  auto message = make_message("detector", 1, {1000, 2000, 3000}, {0, 2, 3},
+                              {1, 2, 3, 4, 5}, {1, 2, 3, 4, 5});
+  parser.process_payload(&queue, message.data());
+  auto pulses = drain();
+
+  ASSERT_EQ(pulses.size(), 3UL);
+  EXPECT_EQ(pulses[0].time, 1000);
+  EXPECT_EQ(pulses[0].timestamps, std::vector<uint64_t>({1001, 1002}));
+  EXPECT_EQ(pulses[1].time, 2000);
+  EXPECT_EQ(pulses[1].timestamps, std::vector<uint64_t>({2003}));
+  EXPECT_EQ(pulses[2].time, 3000);
+  EXPECT_EQ(pulses[2].timestamps, std::vector<uint64_t>({3004, 3005}));
+  EXPECT_FALSE(pulses[0].zero_copy);
+}
+
+TEST_F(ev44Parser, SkipsEmptyPulsesWithoutHeartbeat)
+{
+  auto message = make_message("detector", 1, {1000, 2000, 3000}, {0, 2, 2},
+                              {1, 2, 3}, {1, 2, 3});
+  parser.process_payload(&queue, message.data());
+  auto pulses = drain();
+
+  ASSERT_EQ(pulses.size(), 2UL);
+  EXPECT_EQ(pulses[0].time, 1000);
+  EXPECT_EQ(pulses[1].time, 3000);
+  EXPECT_EQ(pulses[1].timestamps, std::vector<uint64_t>({3003}));
+}
+
+TEST_F(ev44Parser, RejectsBadReferenceIndex)
+{
+  std::vector<int32_t> tofs {1, 2, 3, 4};
+  std::vector<int32_t> pixels {1, 2, 3, 4};
+
+  // not monotonic
+  EXPECT_EQ(process(make_message("detector", 1, {1000, 2000, 3000},
+                                 {0, 3, 2}, tofs, pixels)), 0UL);
+  // beyond the events
+  EXPECT_EQ(process(make_message("detector", 2, {1000, 2000},
+                                 {0, 5}, tofs, pixels)), 0UL);
+  // first pulse does not start at the first event
+  EXPECT_EQ(process(make_message("detector", 3, {1000, 2000},
+                                 {1, 2}, tofs, pixels)), 0UL);
+  // negative
+  EXPECT_EQ(process(make_message("detector", 4, {1000, 2000},
+                                 {0, -1}, tofs, pixels)), 0UL);
+  // times and indices differ in number
+  EXPECT_EQ(process(make_message("detector", 5, {1000, 2000},
+                                 {0}, tofs, pixels)), 0UL);
+
+  // still good after all of these
+  EXPECT_EQ(process(make_message("detector", 6, {1000, 2000},
+                                 {0, 2}, tofs, pixels)), 2UL);
+}
+
+TEST_F(ev44Parser, ZeroCopyPulses)
+{
+  auto message = std::make_shared<Buffer>(
+      make_message("detector", 1, {1000, 2000, 3000}, {0, 2, 3},
+                   {1, 2, 3, 4, 5}, {1, 2, 3, 4, 17}));
+  parser.process(&queue, message->data(), message);
+  auto pulses = drain();
+
+  ASSERT_EQ(pulses.size(), 3UL);
+  for (const auto& p : pulses)
+    EXPECT_TRUE(p.zero_copy);
+  EXPECT_EQ(pulses[0].time, 1000);
+  EXPECT_EQ(pulses[0].timestamps, std::vector<uint64_t>({1001, 1002}));
+  EXPECT_EQ(pulses[1].time, 2000);
+  EXPECT_EQ(pulses[1].timestamps, std::vector<uint64_t>({2003}));
+  EXPECT_EQ(pulses[2].time, 3000);
+  EXPECT_EQ(pulses[2].timestamps, std::vector<uint64_t>({3004, 3005}));
+
+  // left in the message, the bad pixel is only counted
+  EXPECT_EQ(parser.stream_state->out_of_range_pixels.load(), 1UL);
+}